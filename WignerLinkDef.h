@@ -13,4 +13,44 @@
  
  #pragma link C++ class wignerSource+; ///< Enable ROOT dictionary for wignerSource
  #pragma link C++ class wignerUtils+;  ///< Enable ROOT dictionary for wignerUtils
+ #pragma link C++ class wignerScan+;   ///< Enable ROOT dictionary for wignerScan
+ #pragma link C++ struct wignerPoint+; ///< Enable ROOT dictionary for wignerPoint
+ #pragma link C++ class wignerManifest+; ///< Enable ROOT dictionary for wignerManifest
+ #pragma link C++ struct wignerShard+;   ///< Enable ROOT dictionary for wignerShard
+ #pragma link C++ class wignerAnisotropicSource+; ///< Enable ROOT dictionary for wignerAnisotropicSource
+ #pragma link C++ class wignerNucleusA3+;    ///< Enable ROOT dictionary for wignerNucleusA3
+ #pragma link C++ class wignerGaussianA3+;   ///< Enable ROOT dictionary for wignerGaussianA3
+ #pragma link C++ class wignerHyperTableA3+; ///< Enable ROOT dictionary for wignerHyperTableA3
+ #pragma link C++ class wignerThreeBody+;    ///< Enable ROOT dictionary for wignerThreeBody
+ #pragma link C++ class wignerDeuteronTable+; ///< Enable ROOT dictionary for wignerDeuteronTable
+ #pragma link C++ class wignerEnsemble+;      ///< Enable ROOT dictionary for wignerEnsemble
+ #pragma link C++ struct wignerBand+;         ///< Enable ROOT dictionary for wignerBand
+ #pragma link C++ struct wignerBandPoint+;    ///< Enable ROOT dictionary for wignerBandPoint
+ #pragma link C++ class wignerShapeBase+;     ///< Enable ROOT dictionary for wignerShapeBase
+ #pragma link C++ class gaussianShape+;       ///< Enable ROOT dictionary for gaussianShape
+ #pragma link C++ class exponentialShape+;    ///< Enable ROOT dictionary for exponentialShape
+ #pragma link C++ class cauchyShape+;         ///< Enable ROOT dictionary for cauchyShape
+ #pragma link C++ class levyShape+;           ///< Enable ROOT dictionary for levyShape
+ #pragma link C++ class coreHaloShape+;       ///< Enable ROOT dictionary for coreHaloShape
+ #pragma link C++ class wignerShapedSource<gaussianShape>+;    ///< Shaped source instantiations for macros
+ #pragma link C++ class wignerShapedSource<exponentialShape>+;
+ #pragma link C++ class wignerShapedSource<cauchyShape>+;
+ #pragma link C++ class wignerShapedSource<levyShape>+;
+ #pragma link C++ class wignerShapedSource<coreHaloShape>+;
+ #pragma link C++ class wignerPotential+;       ///< Enable ROOT dictionary for wignerPotential
+ #pragma link C++ class squareWellPotential+;   ///< Enable ROOT dictionary for squareWellPotential
+ #pragma link C++ class yukawaPotential+;       ///< Enable ROOT dictionary for yukawaPotential
+ #pragma link C++ class woodsSaxonPotential+;   ///< Enable ROOT dictionary for woodsSaxonPotential
+ #pragma link C++ class tabulatedPotential+;    ///< Enable ROOT dictionary for tabulatedPotential
+ #pragma link C++ class wignerCore+;            ///< Enable ROOT dictionary for wignerCore
+ #pragma link C++ class wignerTable+;           ///< Enable ROOT dictionary for wignerTable
+ #pragma link C++ class wignerCoreSource+;      ///< Enable ROOT dictionary for wignerCoreSource
+ #pragma link C++ class wignerOverlap+;         ///< Enable ROOT dictionary for wignerOverlap
+ #pragma link C++ class wignerGaussianMixture+; ///< Enable ROOT dictionary for wignerGaussianMixture
+ #pragma link C++ class wignerLowRankTable+;    ///< Enable ROOT dictionary for wignerLowRankTable
+ #pragma link C++ class wignerRandom+;          ///< Enable ROOT dictionary for wignerRandom
+ #pragma link C++ class wignerSampler+;         ///< Enable ROOT dictionary for wignerSampler
+ #pragma link C++ class wignerCorrelation+;     ///< Enable ROOT dictionary for wignerCorrelation
+ #pragma link C++ class wignerAdaptiveScan+;    ///< Enable ROOT dictionary for wignerAdaptiveScan
+ #pragma link C++ class wignerContributionMap+; ///< Enable ROOT dictionary for wignerContributionMap
  #endif
\ No newline at end of file
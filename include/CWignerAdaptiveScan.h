@@ -0,0 +1,103 @@
+/**
+ * @defgroup WignerAdaptiveScan Adaptive k* Scan
+ * @brief k* scan that refines a coarse grid where the observables are not resolved.
+ * @{
+ */
+
+#ifndef CWIGNERADAPTIVESCAN
+#define CWIGNERADAPTIVESCAN
+
+#include "CWignerScan.h"
+#include "TString.h"
+#include <vector>
+
+/**
+ * @class wignerAdaptiveScan
+ * @brief Samples coal, ⟨K⟩, ⟨V⟩ and ⟨H⟩ over [start, end] with points placed where they vary.
+ *
+ * The scan starts from a uniform grid of the coarse step (both ends included). In each round
+ * the error of linear interpolation on every interval is estimated from the curvature of each
+ * observable, 2 f[k_{i-1}, k_i, k_{i+1}] (the larger of the two second divided differences
+ * that contain the interval), as |f''| h² / 8. Intervals where it exceeds the tolerance times
+ * the range of the observable over the samples are halved; all the new points of a round are
+ * computed in one wignerScan::run(), so they are spread over the worker threads. The scan
+ * stops when every interval is resolved, or is shorter than twice the minimum step, or when
+ * the maximum number of points is reached (the worst intervals are then refined first).
+ *
+ * The coarse step must still see every feature: a bump that falls between two coarse points
+ * leaves no curvature to refine on.
+ */
+class wignerAdaptiveScan
+{
+public:
+    /**
+     * @brief Constructor.
+     * @param scan Configured scan (source, threads, cache, ...) computing the points; not owned.
+     */
+    wignerAdaptiveScan(wignerScan &scan);
+
+    /// @brief Set the tolerance, relative to the range of each observable (default 1e-3).
+    void setTolerance(double tolerance);
+
+    /// @brief Set the smallest spacing between two points (default 1e-5 GeV/c).
+    void setMinStep(double step);
+
+    /// @brief Set the largest number of points (default 10000).
+    void setMaxPoints(size_t n);
+
+    /**
+     * @brief Run the scan.
+     * @param start First k* value (must be >= 0).
+     * @param end   Last k* value, included.
+     * @param step  Step of the initial uniform grid (must be > 0).
+     * @return Points sorted in k*, empty if the range is invalid.
+     */
+    std::vector<wignerPoint> run(double start, double end, double step);
+
+    /// @brief Number of refinement rounds of the last run().
+    int getRounds() const;
+
+    /**
+     * @brief Add cubic-spline interpolants of the observables to a file written by wignerScan::writeTree.
+     *
+     * The TSpline3 objects "coal_spline", "wK_spline", "wV_spline" and "wH_spline" are written
+     * next to the TTree, so `((TSpline3 *)file->Get("coal_spline"))->Eval(k)` gives coal at any k*.
+     * @param points  Points sorted in k*.
+     * @param outfile ROOT file (updated).
+     * @return True on success.
+     */
+    static bool writeInterpolants(const std::vector<wignerPoint> &points, const TString &outfile);
+
+private:
+    static const int kObservables = 4; ///< coal, wK, wV, wH.
+
+    wignerScan *mScan;         ///<! Scan computing the points (not owned).
+    double mTolerance = 1E-3;  ///< Tolerance relative to the range of each observable.
+    double mMinStep = 1E-5;    ///< Smallest spacing between two points.
+    size_t mMaxPoints = 10000; ///< Largest number of points.
+    int mRounds = 0;           ///< Refinement rounds of the last run.
+
+    /// @brief Observable i of a point (coal, wK, wV, wH).
+    static double observable(const wignerPoint &pt, int i);
+
+    /**
+     * @brief Second divided difference of an observable on points i - 1, i, i + 1.
+     * @param points Points sorted in k*.
+     * @param i      Middle point (0 < i < size - 1).
+     * @param obs    Observable index.
+     * @return f[k_{i-1}, k_i, k_{i+1}].
+     */
+    static double divided(const std::vector<wignerPoint> &points, size_t i, int obs);
+
+    /**
+     * @brief Estimated linear-interpolation error on [k_i, k_{i+1}], relative to the tolerance.
+     * @param points Points sorted in k*.
+     * @param i      Interval index.
+     * @param scale  Range of each observable over the samples.
+     * @return Largest error over the observables divided by tolerance x range (refine if > 1).
+     */
+    double intervalError(const std::vector<wignerPoint> &points, size_t i, const double *scale) const;
+};
+
+#endif
+/// @}
@@ -0,0 +1,171 @@
+/**
+ * @defgroup WignerAnisotropicSource Anisotropic Wigner Source
+ * @brief Gaussian source with separate out, side and long radii.
+ * @{
+ */
+
+#ifndef CWIGNERANISOTROPICSOURCE
+#define CWIGNERANISOTROPICSOURCE
+
+#include "CWignerSource.h"
+#include <string>
+#include <vector>
+
+/**
+ * @class wignerAnisotropicSource
+ * @brief Coalescence probability and energy moments for an anisotropic Gaussian source.
+ *
+ * The source Wigner function is a product of 1D Gaussians,
+ *
+ *     W(r, p) ∝ Π_i exp( -r_i² / (4 R_i²) ) * exp( -4 R_i² (p_i - k_i)² / ħ² ),   i = out, side, long,
+ *
+ * with k* along the out direction. Since the deuteron Wigner function only depends on |r| and |p|,
+ * the 6D phase-space integrals factorize into the 2D (r, p) integral of the isotropic case, with the
+ * Jacobian replaced by the angular averages A_r(r) and A_p(p) of the two Gaussians.
+ *
+ * Taking out as polar axis, the azimuthal part of each angular average is analytic
+ * (2π exp(-(a+b)/2) I0((a-b)/2)), and the remaining polar integral is done once per radial node
+ * with a composite Gauss-Legendre rule restricted to where the integrand is not negligible.
+ * The marginals are recomputed only when the radii or k* change; coal is then a single pass over
+ * the same (r, p) grid as wignerUtils::integral, and the energy moments are 1D sums.
+ *
+ * With R_out = R_side = R_long it reproduces the isotropic wignerSource.
+ */
+class wignerAnisotropicSource
+{
+public:
+    /// @brief Index of the out, side and long axes in the radius arrays.
+    enum axis
+    {
+        kOut = 0,
+        kSide = 1,
+        kLong = 2
+    };
+
+    /**
+     * @brief Set the reference radii used by setRadiusK() (same role as R0 in wignerSource).
+     * @param rOut  Reference out radius.
+     * @param rSide Reference side radius.
+     * @param rLong Reference long radius.
+     */
+    void setR0(double rOut, double rSide, double rLong);
+
+    /**
+     * @brief Set the source radii directly.
+     * @param rOut  Out radius.
+     * @param rSide Side radius.
+     * @param rLong Long radius.
+     */
+    void setRadii(double rOut, double rSide, double rLong);
+
+    /**
+     * @brief Set relative momentum and update radii/k* with the wignerUtils::radius() and
+     * wignerUtils::kStarEff() parametrization, applied to each axis (k* uses the out radius).
+     * @param k Relative momentum (k*).
+     */
+    void setRadiusK(double k);
+
+    /**
+     * @brief Set the effective k* directly, keeping the radii.
+     * @param k Effective relative momentum.
+     */
+    void setKstar(double k);
+
+    /// @brief Set the reduced mass of the system.
+    void setMu(double mu);
+
+    /// @brief Set the potential spatial width.
+    void setRWidth(double rWidth);
+
+    /// @brief Set the depth of the potential well.
+    void setV0(double v0);
+
+    /// @brief Get the source radius along one axis.
+    double getRadius(int axis);
+
+    /// @brief Get the geometric mean of the three radii.
+    double getMeanRadius();
+
+    /// @brief Get the current value of the effective k*.
+    double getKStar();
+
+    /// @brief Get the current normalization constant.
+    double getNorm();
+
+    /// @brief Get the Wigner-weighted kinetic energy.
+    double getwK();
+
+    /// @brief Get the Wigner-weighted potential energy.
+    double getwV();
+
+    /// @brief Get the Wigner-weighted Hamiltonian.
+    double getwH();
+
+    /// @brief Get the deuteron coalescence probability.
+    double getcoal();
+
+    /**
+     * @brief Check normalization of the WxW function.
+     * @return Integral result scaled by h^3, must be 1.
+     */
+    double checkWxW();
+
+    /**
+     * @brief Compute all observables for one k* value (see wignerSource::computePoint).
+     *
+     * The r0 field of the point holds the geometric mean radius.
+     * @param k Relative momentum (k*).
+     * @return Observables of the point.
+     */
+    wignerPoint computePoint(double k);
+
+    /// @brief Attach a persistent result cache (not owned), nullptr to disable it.
+    void setCache(wignerCache *cache);
+
+    /// @brief Key identifying the current parameters in the result cache.
+    wignerCacheKey getCacheKey();
+
+    /**
+     * @brief Set mu, rWidth, V0 from a `config/default.txt` style file; r0 is used for all three
+     * reference radii unless setR0() is called afterwards.
+     * @param txtfile Input file name.
+     */
+    void SetFromTxt(const std::string &txtfile);
+
+    /**
+     * @brief Angular average of an anisotropic Gaussian over the unit sphere.
+     *
+     * Computes ∫ dΩ exp( -Σ_i c_i (x n_i - s δ_i,out)² ).
+     *
+     * @param x     Modulus of the vector (r or p).
+     * @param c     Gaussian coefficients along out, side, long.
+     * @param shift Shift of the Gaussian along out (k* for the momentum part, 0 for r).
+     * @return Angular integral.
+     */
+    static double angularAverage(double x, const double c[3], double shift);
+
+private:
+    double mR0[3] = {1., 1., 1.};     ///< Reference radii.
+    double mRadius[3] = {1., 1., 1.}; ///< Source radii.
+    double mKin = 0.050;              ///< Input k*.
+    double mKStar = 0.050;            ///< Effective k*.
+    double mMu = 0.938 / 2;           ///< Reduced mass.
+    double mRWidth = 3.2;             ///< Width of the potential well.
+    double mV0 = -17.4E-3;            ///< Depth of the potential well.
+    double mNorm = 1.;                ///< Normalization constant.
+    bool mDirty = true;               ///< Marginals need to be recomputed.
+
+    std::vector<double> mR;  ///< Radial grid nodes.
+    std::vector<double> mP;  ///< Momentum grid nodes.
+    std::vector<double> mAr; ///< r² A_r(r) dr on the radial nodes.
+    std::vector<double> mAp; ///< p² A_p(p) dp on the momentum nodes.
+    double mWW = 0;          ///< Unnormalized WxW integral.
+
+    wignerCache *mCache = nullptr; ///<! Optional persistent result cache (not owned).
+
+    /// @brief Recompute grids and marginals if the radii, k* or the well width changed.
+    void update();
+};
+
+#endif
+/// @}
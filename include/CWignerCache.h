@@ -0,0 +1,95 @@
+/**
+ * @defgroup WignerCache Persistent Result Cache
+ * @brief On-disk cache of the observables of a k* point, keyed by the physics parameters.
+ * @{
+ */
+
+#ifndef CWIGNERCACHE
+#define CWIGNERCACHE
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct wignerPoint;
+
+/**
+ * @struct wignerCacheKey
+ * @brief Parameters identifying a cached point.
+ *
+ * `params` holds every number the result depends on (r0, mu, rWidth, V0, k*, source radius,
+ * effective k*, integration ranges and steps, integration mode), `table` the checksum of the
+ * deuteron Wigner table.
+ */
+struct wignerCacheKey
+{
+    std::vector<double> params; ///< Physics and integration parameters.
+    uint64_t table = 0;         ///< Deuteron table checksum.
+
+    /// @brief 64-bit hash of the key, used as file name.
+    uint64_t hash() const;
+};
+
+/**
+ * @class wignerCache
+ * @brief Content-addressed cache of wignerPoint results stored as one small file per entry.
+ *
+ * Entries live in `<dir>/<hash>.wgc`. They are written to a unique temporary file and
+ * renamed into place, so concurrent processes (and threads) only ever see complete entries,
+ * and the full key is stored in the entry and compared on lookup to rule out hash collisions.
+ *
+ * Eviction is least-recently-used: a hit refreshes the modification time of the entry and,
+ * when the number of entries exceeds the limit, the oldest ones are removed. Eviction is
+ * serialized between processes through an advisory lock on `<dir>/.lock`.
+ */
+class wignerCache
+{
+public:
+    /**
+     * @brief Constructor, creates the cache directory if needed.
+     * @param dir        Cache directory.
+     * @param maxEntries Maximum number of entries kept after an eviction pass.
+     */
+    wignerCache(const std::string &dir, size_t maxEntries = 100000);
+
+    /**
+     * @brief Look up a point.
+     * @param key Key of the point.
+     * @param pt  Filled with the cached observables on a hit (k is left untouched).
+     * @return True on a hit.
+     */
+    bool fetch(const wignerCacheKey &key, wignerPoint &pt);
+
+    /**
+     * @brief Store a point, evicting old entries if the cache is full.
+     * @param key Key of the point.
+     * @param pt  Observables to store.
+     */
+    void store(const wignerCacheKey &key, const wignerPoint &pt);
+
+    /// @brief Remove least-recently-used entries until at most maxEntries remain.
+    void evict();
+
+    /// @brief Get the cache directory.
+    const std::string &getDir() const;
+
+    /// @brief Number of hits since construction.
+    long getHits() const;
+
+    /// @brief Number of misses since construction.
+    long getMisses() const;
+
+private:
+    std::string mDir;             ///< Cache directory.
+    size_t mMaxEntries;           ///< Maximum number of entries.
+    std::atomic<long> mHits{0};   ///< Number of hits.
+    std::atomic<long> mMisses{0}; ///< Number of misses.
+    std::atomic<long> mStores{0}; ///< Number of entries stored by this object.
+
+    /// @brief Path of the entry file for a key hash.
+    std::string entryPath(uint64_t hash) const;
+};
+
+#endif
+/// @}
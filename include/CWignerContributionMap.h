@@ -0,0 +1,95 @@
+/**
+ * @defgroup WignerContributionMap Integrand Contribution Maps
+ * @brief Where in (r, p) coal, ⟨K⟩ and ⟨V⟩ come from, filled during the integration.
+ * @{
+ */
+
+#ifndef CWIGNERCONTRIBUTIONMAP
+#define CWIGNERCONTRIBUTIONMAP
+
+#include "TDirectory.h"
+#include "TString.h"
+#include <vector>
+
+/**
+ * @class wignerContributionMap
+ * @brief Coarse (r, p) histograms of the grid contributions to coal, ⟨K⟩ and ⟨V⟩ for one k*.
+ *
+ * wignerSource::computePoint() adds the contribution of every grid node (integrand times cell
+ * area) while it integrates, so the bins of each map add up to the observable and no extra
+ * evaluation is needed. Each observable gets a 2D (r, p) map and the 1D r and p marginals,
+ * with 4 times finer bins than the 2D map. The contents are plain arrays, so worker threads can
+ * fill their own maps; the histograms are only created by write().
+ */
+class wignerContributionMap
+{
+public:
+    /// @brief Observables with a map.
+    enum observable
+    {
+        kCoal = 0, ///< Coalescence probability.
+        kWK,       ///< Wigner-weighted kinetic energy.
+        kWV,       ///< Wigner-weighted potential energy.
+        kObservables
+    };
+
+    /**
+     * @brief Constructor.
+     * @param nr   Number of r bins of the 2D maps.
+     * @param np   Number of p bins of the 2D maps.
+     * @param rMin Lower r edge.
+     * @param rMax Upper r edge.
+     * @param pMin Lower p edge.
+     * @param pMax Upper p edge.
+     */
+    wignerContributionMap(int nr = 40, int np = 30, double rMin = 0, double rMax = 20, double pMin = 0, double pMax = 0.6);
+
+    /// @brief Clear all the maps.
+    void reset();
+
+    /**
+     * @brief Add a contribution.
+     * @param obs Observable.
+     * @param r   Radius of the node.
+     * @param p   Momentum of the node.
+     * @param w   Contribution of the node.
+     */
+    void fill(int obs, double r, double p, double w);
+
+    /// @brief Sum of the contributions to an observable (its value on the grid).
+    double getTotal(int obs) const;
+
+    /// @brief k* of the point the maps belong to.
+    double getK() const;
+
+    /// @brief Set the k* of the point the maps belong to.
+    void setK(double k);
+
+    /// @brief Name of an observable (coal, wK, wV).
+    static const char *name(int obs);
+
+    /**
+     * @brief Write the histograms <obs>_rp_<suffix> (TH2D), <obs>_r_<suffix> and <obs>_p_<suffix> (TH1D).
+     * @param dir    Directory to write to.
+     * @param suffix Suffix of the histogram names (e.g. the point index).
+     */
+    void write(TDirectory *dir, const TString &suffix) const;
+
+private:
+    int mNR;                                  ///< Number of r bins of the 2D maps.
+    int mNP;                                  ///< Number of p bins of the 2D maps.
+    double mRMin;                             ///< Lower r edge.
+    double mRMax;                             ///< Upper r edge.
+    double mPMin;                             ///< Lower p edge.
+    double mPMax;                             ///< Upper p edge.
+    double mK = 0;                            ///< k* of the point.
+    std::vector<double> mRP[kObservables];    ///< 2D maps, bin i + nr * j.
+    std::vector<double> mR[kObservables];     ///< r marginals.
+    std::vector<double> mP[kObservables];     ///< p marginals.
+
+    /// @brief Bin of x in n bins over [lo, hi], -1 outside.
+    static int bin(double x, double lo, double hi, int n);
+};
+
+#endif
+/// @}
@@ -0,0 +1,313 @@
+/**
+ * @defgroup WignerCore ROOT-free Numeric Core
+ * @brief Source, Jacobians and grid integration with no dependency on ROOT.
+ * @{
+ */
+
+#ifndef CWIGNERCORE
+#define CWIGNERCORE
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @struct wignerPoint
+ * @brief Observables computed for a single k* value, one entry of the output TTree.
+ */
+struct wignerPoint
+{
+    double k = 0;       ///< Input relative momentum k*.
+    double r0 = 0;      ///< Effective source radius.
+    double norm = 0;    ///< Normalization constant of the source.
+    double WW = 0;      ///< W x W normalization check (must be 1).
+    double coal = 0;    ///< Deuteron coalescence probability.
+    double wK = 0;      ///< Wigner-weighted kinetic energy.
+    double wV = 0;      ///< Wigner-weighted potential energy.
+    double wH = 0;      ///< Wigner-weighted Hamiltonian.
+    double cf = 0;      ///< Koonin–Pratt correlation function C(k*) (see wignerCorrelation), 0 if not computed.
+    long long idx = -1; ///< Global point index in a sharded scan (-1 if not sharded).
+    int shard = -1;     ///< Shard that produced the point (-1 if not sharded).
+
+    std::vector<double> coalTables;  ///< Coalescence probability per table of a multi-table sweep (empty otherwise).
+    std::vector<double> observables; ///< User-defined observables (see wignerObservables), empty otherwise.
+};
+
+/**
+ * @class wignerCore
+ * @brief Static numeric kernels shared by the ROOT layer (wignerUtils, wignerSource) and wignerCoreSource.
+ *
+ * The functions take plain arguments instead of the (x, pm) arrays of the TF2 callbacks; the
+ * TF2 callbacks of wignerUtils forward to them, so both layers give the same numbers. This
+ * header and its library (WignerCore) only use the C++ standard library.
+ */
+class wignerCore
+{
+public:
+    /// @brief ħc in GeV·fm.
+    static constexpr double kHCut = 0.1973;
+
+    /// @brief π.
+    static constexpr double kPi = 3.14159265358979323846;
+
+    /**
+     * @brief Gaussian source Wigner function (see wignerUtils::wignerSource).
+     * @param r      Radius.
+     * @param p      Momentum.
+     * @param norm   Normalization constant.
+     * @param radius Source radius.
+     * @param kStar  Effective k*.
+     * @return W(r, p).
+     */
+    static double wigner(double r, double p, double norm, double radius, double kStar);
+
+    /**
+     * @brief Jacobian of W, 16π² r² p² times the angular average (1 - exp(-2α)) / (2α).
+     * @param r       Radius.
+     * @param p       Momentum.
+     * @param radius  Source radius.
+     * @param kStar   Effective k*.
+     * @param squared Use the α of W x W (twice that of W), as in wignerUtils::jacobianW2.
+     * @return Jacobian.
+     */
+    static double jacobian(double r, double p, double radius, double kStar, bool squared = false);
+
+    /// @brief Effective source radius for k* and R0 (see wignerUtils::radius).
+    static double radius(double k, double r0);
+
+    /// @brief Effective k* for the source radius (see wignerUtils::kStarEff).
+    static double kStarEff(double k, double radius);
+
+    /**
+     * @brief Edges of the integration panels: lo, the break points inside (lo, hi) in order, hi.
+     * @param lo     Lower limit.
+     * @param hi     Upper limit.
+     * @param breaks Break points.
+     * @return Panel edges.
+     */
+    static std::vector<double> panels(double lo, double hi, std::vector<double> breaks);
+
+    /// @brief Midpoint nodes and cell widths of the integration grid along one axis (see wignerUtils::gridNodes).
+    static void gridNodes(double lo, double hi, const std::vector<double> &breaks, double step,
+                          std::vector<double> &nodes, std::vector<double> &widths);
+
+    /**
+     * @brief Cumulative radial marginal and p² moment of W·J on the grid without breaks.
+     *
+     * W·J factorizes as F(r) G(p) (wigner() is exp(-r² / 4R²) times a function of p, jacobian()
+     * is r² times a function of p), so both come from one pass per axis:
+     *
+     *     cumulative[i] = Σ_{r_n < edges[i]} F(r_n) Δr_n · Σ_j G(p_j) Δp_j,   p2 = Σ_n F(r_n) Δr_n · Σ_j p_j² G(p_j) Δp_j.
+     *
+     * ⟨V⟩ of a square well of width a is then V0 times interpolateCumulative(edges, cumulative, a)
+     * and ⟨K⟩ is p2 / 2μ, whatever V0, a and μ.
+     * @param norm       Normalization constant.
+     * @param radius     Source radius.
+     * @param kStar      Effective k*.
+     * @param minX       Lower r limit.
+     * @param maxX       Upper r limit.
+     * @param minP       Lower p limit.
+     * @param maxP       Upper p limit.
+     * @param dx         Step in r.
+     * @param dp         Step in p.
+     * @param edges      Filled with the radial cell edges, from minX to maxX.
+     * @param cumulative Filled with ∫ W·J over r < edges[i].
+     * @param p2         Set to ∫ p² W·J.
+     */
+    static void sourceMoments(double norm, double radius, double kStar, double minX, double maxX, double minP, double maxP,
+                              double dx, double dp, std::vector<double> &edges, std::vector<double> &cumulative, double &p2);
+
+    /**
+     * @brief Cumulative radial source ∫ exp(-r² / 4R²) r² dr on the grid without breaks.
+     *
+     * The F(r) of sourceMoments(), whose cumulative is this one times the p integral.
+     * @param radius     Source radius.
+     * @param minX       Lower r limit.
+     * @param maxX       Upper r limit.
+     * @param dx         Step in r.
+     * @param edges      Filled with the radial cell edges, from minX to maxX.
+     * @param cumulative Filled with the integral over r < edges[i].
+     */
+    static void radialSource(double radius, double minX, double maxX, double dx, std::vector<double> &edges,
+                             std::vector<double> &cumulative);
+
+    /// @brief Cumulative integral tabulated at cell edges, linear inside a cell, 0 below and the total above.
+    static double interpolateCumulative(const std::vector<double> &edges, const std::vector<double> &cumulative, double x);
+
+    /**
+     * @brief Fraction of the Gaussian source exp(-r² / 4R²) in d³r that lies at r < a.
+     *
+     * The cumulative distribution of |r⃗| for a normal r⃗ with σ² = 2R² per component,
+     * erf(a / 2R) - a / (R √π) exp(-a² / 4R²).
+     * @param a      Radius of the sphere.
+     * @param radius Source radius R.
+     * @return Fraction in [0, 1].
+     */
+    static double gaussianCdf(double a, double radius);
+
+    /**
+     * @brief Midpoint-grid integral of f(r, p), split into panels at the break points.
+     *
+     * The scheme of wignerUtils::integral: each panel gets the largest step <= dx (dp) that
+     * fits it exactly. f is a template parameter, so the integrand is inlined.
+     * @param f       Integrand, callable as f(r, p).
+     * @param minX    Lower r limit.
+     * @param maxX    Upper r limit.
+     * @param minP    Lower p limit.
+     * @param maxP    Upper p limit.
+     * @param dx      Largest step in r.
+     * @param dp      Largest step in p.
+     * @param xBreaks Break points in r.
+     * @param pBreaks Break points in p.
+     * @return Integral.
+     */
+    template <class F>
+    static double integrate(F &&f, double minX, double maxX, double minP, double maxP, double dx, double dp,
+                            const std::vector<double> &xBreaks = {}, const std::vector<double> &pBreaks = {});
+
+    /**
+     * @brief integrate() that also reports the contribution of every node.
+     *
+     * visit(r, p, f(r, p) x cell area) is called once per node, so the contributions add up
+     * to the integral (e.g. to histogram where it comes from, see wignerContributionMap).
+     * @param f       Integrand, callable as f(r, p).
+     * @param visit   Callable as visit(r, p, contribution).
+     * @param minX    Lower r limit.
+     * @param maxX    Upper r limit.
+     * @param minP    Lower p limit.
+     * @param maxP    Upper p limit.
+     * @param dx      Largest step in r.
+     * @param dp      Largest step in p.
+     * @param xBreaks Break points in r.
+     * @param pBreaks Break points in p.
+     * @return Integral, identical to that of integrate().
+     */
+    template <class F, class G>
+    static double integrateVisit(F &&f, G &&visit, double minX, double maxX, double minP, double maxP, double dx, double dp,
+                                 const std::vector<double> &xBreaks = {}, const std::vector<double> &pBreaks = {});
+
+    /**
+     * @brief Several integrals of the same grid in one pass (see integrate()).
+     *
+     * f adds the n integrands at a node to an accumulator, so what they share (e.g. the source
+     * factor) is evaluated once per node. With n = 1 the result is that of integrate().
+     * @param f       Callable as f(r, p, acc), adding integrand t to acc[t] for t < n.
+     * @param n       Number of integrals.
+     * @param res     Output, n integrals.
+     * @param minX    Lower r limit.
+     * @param maxX    Upper r limit.
+     * @param minP    Lower p limit.
+     * @param maxP    Upper p limit.
+     * @param dx      Largest step in r.
+     * @param dp      Largest step in p.
+     * @param xBreaks Break points in r.
+     * @param pBreaks Break points in p.
+     */
+    template <class F>
+    static void integrateMany(F &&f, size_t n, double *res, double minX, double maxX, double minP, double maxP, double dx, double dp,
+                              const std::vector<double> &xBreaks = {}, const std::vector<double> &pBreaks = {});
+
+    /**
+     * @brief 64-bit FNV-1a hash of a byte buffer.
+     * @param data Buffer.
+     * @param size Number of bytes.
+     * @param seed Initial hash value (to chain several buffers).
+     * @return Hash.
+     */
+    static uint64_t hash(const void *data, size_t size, uint64_t seed = 14695981039346656037ULL);
+
+    /**
+     * @brief Read parameters from a file (one value per line, `config/default.txt` style).
+     * @param filename File name to read from.
+     * @return Vector of parameter values.
+     */
+    static std::vector<double> readParams(const std::string &filename);
+};
+
+//_________________________________________________________________________
+template <class F>
+double wignerCore::integrate(F &&f, double minX, double maxX, double minP, double maxP, double dx, double dp,
+                             const std::vector<double> &xBreaks, const std::vector<double> &pBreaks)
+{
+    return integrateVisit(std::forward<F>(f), [](double, double, double) {}, minX, maxX, minP, maxP, dx, dp, xBreaks, pBreaks);
+}
+//_________________________________________________________________________
+template <class F, class G>
+double wignerCore::integrateVisit(F &&f, G &&visit, double minX, double maxX, double minP, double maxP, double dx, double dp,
+                                  const std::vector<double> &xBreaks, const std::vector<double> &pBreaks)
+{
+    std::vector<double> xEdges = panels(minX, maxX, xBreaks);
+    std::vector<double> pEdges = panels(minP, maxP, pBreaks);
+
+    double res = 0;
+    for (size_t i = 0; i + 1 < xEdges.size(); ++i)
+    {
+        for (size_t j = 0; j + 1 < pEdges.size(); ++j)
+        {
+            double x0 = xEdges[i], x1 = xEdges[i + 1];
+            double p0 = pEdges[j], p1 = pEdges[j + 1];
+            // tolerance so that a panel that is a multiple of the step keeps that step
+            int nx = std::max(1, int(std::ceil((x1 - x0) / dx - 1E-6)));
+            int np = std::max(1, int(std::ceil((p1 - p0) / dp - 1E-6)));
+            double hx = (x1 - x0) / nx;
+            double hp = (p1 - p0) / np;
+            double panel = 0;
+            for (int ix = 0; ix < nx; ++ix)
+            {
+                double x = x0 + (ix + 0.5) * hx;
+                for (int ip = 0; ip < np; ++ip)
+                {
+                    double p = p0 + (ip + 0.5) * hp;
+                    double v = f(x, p);
+                    panel += v;
+                    visit(x, p, v * hx * hp);
+                }
+            }
+            res += panel * hx * hp;
+        }
+    }
+    return res;
+}
+//_________________________________________________________________________
+template <class F>
+void wignerCore::integrateMany(F &&f, size_t n, double *res, double minX, double maxX, double minP, double maxP, double dx, double dp,
+                               const std::vector<double> &xBreaks, const std::vector<double> &pBreaks)
+{
+    std::vector<double> xEdges = panels(minX, maxX, xBreaks);
+    std::vector<double> pEdges = panels(minP, maxP, pBreaks);
+
+    std::fill(res, res + n, 0.);
+    std::vector<double> panel(n);
+    for (size_t i = 0; i + 1 < xEdges.size(); ++i)
+    {
+        for (size_t j = 0; j + 1 < pEdges.size(); ++j)
+        {
+            double x0 = xEdges[i], x1 = xEdges[i + 1];
+            double p0 = pEdges[j], p1 = pEdges[j + 1];
+            int nx = std::max(1, int(std::ceil((x1 - x0) / dx - 1E-6)));
+            int np = std::max(1, int(std::ceil((p1 - p0) / dp - 1E-6)));
+            double hx = (x1 - x0) / nx;
+            double hp = (p1 - p0) / np;
+            std::fill(panel.begin(), panel.end(), 0.);
+            for (int ix = 0; ix < nx; ++ix)
+            {
+                double x = x0 + (ix + 0.5) * hx;
+                for (int ip = 0; ip < np; ++ip)
+                {
+                    f(x, p0 + (ip + 0.5) * hp, panel.data());
+                }
+            }
+            for (size_t t = 0; t < n; ++t)
+            {
+                res[t] += panel[t] * hx * hp;
+            }
+        }
+    }
+}
+
+#endif
+/// @}
@@ -0,0 +1,167 @@
+/**
+ * @defgroup WignerCoreSource ROOT-free Wigner Source
+ * @brief Coalescence observables of the Gaussian source without ROOT, for embedding in event generators.
+ * @{
+ */
+
+#ifndef CWIGNERCORESOURCE
+#define CWIGNERCORESOURCE
+
+#include "CWignerCore.h"
+#include "CWignerLowRankTable.h"
+#include "CWignerPotential.h"
+#include "CWignerTable.h"
+#include <string>
+#include <vector>
+
+/**
+ * @class wignerCoreSource
+ * @brief The observables of wignerSource::computePoint() with plain functions instead of TF2 objects.
+ *
+ * Links only against the WignerCore library. The integrands are the wignerCore kernels and the
+ * integration is wignerCore::integrate() on the same panels and steps as wignerUtils::integral(),
+ * so for the same table, parameters and grid the results are those of wignerSource (its test mode,
+ * TF2::Integral, has no counterpart here). Unlike wignerSource, the integration ranges and steps
+ * are members, so any number of objects can be used from different threads.
+ *
+ * @code
+ *   wignerTable table = wignerTable::read("deuteronFunction/wigner2.bin");
+ *   wignerCoreSource source(&table);
+ *   source.SetFromTxt("config/default.txt");
+ *   wignerPoint pt = source.computePoint(0.05);
+ * @endcode
+ */
+class wignerCoreSource
+{
+public:
+    /**
+     * @brief Constructor.
+     * @param table Deuteron Wigner table (not owned), nullptr for coal = 0.
+     */
+    wignerCoreSource(const wignerTable *table = nullptr);
+
+    /// @brief Set the deuteron Wigner table (not owned), nullptr for coal = 0.
+    void setTable(const wignerTable *table);
+
+    /**
+     * @brief Compute the points from the factorization of W·J, with coal from a low-rank table.
+     *
+     * W·J is a product F(r) G(p), so the normalization, WW, ⟨K⟩ and the square-well ⟨V⟩ become
+     * products of 1D sums, and coal costs rank × (N + M) operations with the table
+     * W_d ≈ Σ_k σ_k u_k(r) v_k(p) (see wignerLowRankTable): a point takes about 0.1 ms instead of
+     * 0.1 s, for per-pair weights (see wignerFrame). The results are those of the grid up to
+     * rounding, except coal, which is that of the truncated table. ⟨H⟩ is ⟨K⟩ + ⟨V⟩.
+     * @param table Decomposition of the deuteron table (not owned, may be shared between threads),
+     *              nullptr to go back to the grid integrals.
+     */
+    void setLowRankTable(const wignerLowRankTable *table);
+
+    /// @brief Set the reference radius R0.
+    void setR0(double r0);
+
+    /// @brief Set the reduced mass.
+    void setMu(double mu);
+
+    /// @brief Set the width of the square well.
+    void setRWidth(double rWidth);
+
+    /// @brief Set the depth of the square well.
+    void setV0(double v0);
+
+    /**
+     * @brief Use another potential than the square well for ⟨V⟩ and ⟨H⟩, as wignerSource::setPotential.
+     * @param potential Potential (not owned), nullptr to go back to the square well of rWidth and V0.
+     */
+    void setPotential(const wignerPotential *potential);
+
+    /// @brief Get the potential used for ⟨V⟩: the attached one or the square well.
+    const wignerPotential *getPotential() const;
+
+    /**
+     * @brief Set the integration bounds (the defaults are those of wignerUtils).
+     * @param minX Minimum radius.
+     * @param maxX Maximum radius.
+     * @param minP Minimum momentum.
+     * @param maxP Maximum momentum.
+     */
+    void setIntegrationRanges(double minX, double maxX, double minP, double maxP);
+
+    /**
+     * @brief Set the steps of the grid integration.
+     * @param dx Step in r (fm).
+     * @param dp Step in p (GeV/c).
+     */
+    void setSteps(double dx, double dp);
+
+    /**
+     * @brief Set r0, mu, rWidth and V0 from a `config/default.txt` style file.
+     *
+     * The TF2 ranges of the file are not used: there are no TF2 objects here.
+     * @param txtfile Input file name.
+     */
+    void SetFromTxt(const std::string &txtfile);
+
+    /**
+     * @brief Compute all observables for one k* value, as wignerSource::computePoint.
+     * @param k Relative momentum (k*).
+     * @return Observables of the point.
+     */
+    wignerPoint computePoint(double k);
+
+    /// @brief Get the source radius of the last point.
+    double getRadius() const { return mRadius; }
+
+    /// @brief Get the effective k* of the last point.
+    double getKStar() const { return mKStar; }
+
+    /// @brief Get the normalization constant of the last point.
+    double getNorm() const { return mNorm; }
+
+    /// @brief Checksum of the table, as wignerUtils::getDeuteronChecksum (0 without a table).
+    uint64_t getTableChecksum() const;
+
+private:
+    double mR0 = 1.;        ///< Reference radius R0.
+    double mRadius = 1.;    ///< Source radius.
+    double mKStar = 0.050;  ///< Effective relative momentum.
+    double mNorm = 1.;      ///< Normalization constant.
+    double mMu = 0.938 / 2; ///< Reduced mass.
+    double mRWidth = 3.2;   ///< Width of the potential well.
+    double mV0 = -17.4E-3;  ///< Depth of the potential well.
+
+    double mMinX = 0.;   ///< Minimum radius for integration.
+    double mMaxX = 20.;  ///< Maximum radius for integration.
+    double mMinP = 0.;   ///< Minimum momentum for integration.
+    double mMaxP = 0.6;  ///< Maximum momentum for integration.
+    double mDx = 0.01;   ///< dx step of the grid.
+    double mDp = 0.001;  ///< dp step of the grid.
+
+    const wignerTable *mTable = nullptr;         ///< Deuteron table (not owned).
+    squareWellPotential mWell;                   ///< Square well of rWidth and V0.
+    const wignerPotential *mPotential = nullptr; ///< Attached potential (not owned), nullptr for mWell.
+    bool mPotentialDirty = true;                 ///< Potential values need to be recomputed.
+    std::vector<double> mRNodes;                 ///< Radial nodes of the grid, split at the potential breaks.
+    std::vector<double> mRWidths;                ///< Widths of the radial cells.
+    std::vector<double> mVNodes;                 ///< Potential on the radial nodes.
+    std::vector<double> mPNodes;                 ///< Momentum nodes of the grid.
+    std::vector<double> mPWidths;                ///< Widths of the momentum cells.
+
+    const wignerLowRankTable *mLowRank = nullptr; ///< Low-rank deuteron table (not owned), nullptr for the grid.
+    bool mLowRankDirty = true;                    ///< Factors of the low-rank table need to be recomputed.
+    std::vector<double> mLowRankR;                ///< Radial nodes, split at the breaks of the table.
+    std::vector<double> mLowRankP;                ///< Momentum nodes, split at the breaks of the table.
+    std::vector<double> mLowRankU;                ///< σ_k u_k(r_i) r_i² Δr_i, rank x mLowRankR.size().
+    std::vector<double> mLowRankV;                ///< v_k(p_j) Δp_j, rank x mLowRankP.size().
+
+    /// @brief Recompute the grid nodes and the potential on them if the potential or the grid changed.
+    void updatePotential();
+
+    /// @brief ⟨V⟩ as the dot product of the potential with the radial marginal of W·J.
+    double potentialEnergy();
+
+    /// @brief Observables of computePoint() from 1D sums and the low-rank table (radius and k* already set).
+    void computeSeparable(wignerPoint &pt);
+};
+
+#endif
+/// @}
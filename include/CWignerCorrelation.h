@@ -0,0 +1,100 @@
+/**
+ * @defgroup WignerCorrelation Koonin–Pratt Correlation Function
+ * @brief Femtoscopic correlation function C(k*) of the Gaussian source from tabulated pair wavefunctions.
+ * @{
+ */
+
+#ifndef CWIGNERCORRELATION
+#define CWIGNERCORRELATION
+
+#include "CWignerTable.h"
+#include <string>
+#include <vector>
+
+/**
+ * @class wignerCorrelation
+ * @brief C(k*) = ∫ d³r S(r) |ψ(k*, r)|² for the source of wignerCore::wigner.
+ *
+ * The radial distribution of the Gaussian source of the coalescence integrals, S(r) ∝
+ * exp(-r² / 4R²), is the Koonin–Pratt source of the pair. The wavefunctions are tables of the
+ * angle-averaged |ψ(k*, r)|² in the format of wignerTable, with x = r (fm) and y = k* (GeV/c),
+ * one per channel with its weight (e.g. 1/4 and 3/4 for the spin singlet and triplet of p–n);
+ * `wignertable --convert` writes them from a TH2D "h". Since |ψ|² → 1 at large r,
+ *
+ *     C(k*) = Σ_c w_c (1 + ∫ d³r S(r) (|ψ_c(k*, r)|² - 1)),
+ *
+ * with S normalized to 1 over all r: the integral only runs over the r range of the tables, and
+ * the truncation of the source to the integration range (r < 20 fm, while R grows as 1/k* at low
+ * k*) does not bias C. Outside the k* range of a table, C is NaN.
+ *
+ * The integral runs on a cumulative radial source, the arrays of wignerCore::radialSource(): in
+ * a scan, wignerSource passes the ones it already holds for ⟨K⟩ and the square-well ⟨V⟩ (see
+ * wignerSource::setCorrelation()), so the correlation and the coalescence of a point come from
+ * the same radial pass. Only the standard library is used, so the class is part of
+ * libWignerCore; compute() is const and can be called from several threads at once.
+ *
+ * @code
+ *   wignerCorrelation cf;
+ *   cf.addChannel(wignerTable::read("pn_singlet.bin"), 0.25);
+ *   cf.addChannel(wignerTable::read("pn_triplet.bin"), 0.75);
+ *   double c = cf.compute(0.05, 1.2);                   // k* = 50 MeV/c, R = 1.2 fm
+ * @endcode
+ */
+class wignerCorrelation
+{
+public:
+    /// @brief Constructor, without channels (C is then 0).
+    wignerCorrelation() = default;
+
+    /**
+     * @brief Add a channel.
+     * @param table  Angle-averaged |ψ(k*, r)|², x = r (fm), y = k* (GeV/c).
+     * @param weight Weight of the channel.
+     */
+    void addChannel(const wignerTable &table, double weight = 1.);
+
+    /**
+     * @brief Add a channel from a command-line specification.
+     * @param spec Binary table file, optionally followed by :<weight> (default 1), e.g. pn_triplet.bin:0.75.
+     * @return False if the specification or the file cannot be read.
+     */
+    bool addChannel(const std::string &spec);
+
+    /// @brief Number of channels.
+    size_t size() const;
+
+    /// @brief Largest r of the tables, beyond which |ψ|² = 1.
+    double getRMax() const;
+
+    /**
+     * @brief Correlation function on a radial grid of its own.
+     * @param kStar  Relative momentum k* (GeV/c).
+     * @param radius Source radius R (fm).
+     * @param minX   Lower r limit.
+     * @param maxX   Upper r limit (the tables end first if they are shorter).
+     * @param dx     Step in r.
+     * @return C(k*).
+     */
+    double compute(double kStar, double radius, double minX = 0., double maxX = 20., double dx = 0.01) const;
+
+    /**
+     * @brief Correlation function on a tabulated radial source.
+     * @param kStar      Relative momentum k* (GeV/c).
+     * @param radius     Source radius R (fm) of the arrays.
+     * @param edges      Radial cell edges (see wignerCore::radialSource()).
+     * @param cumulative Cumulative radial source at the edges, with any constant factor
+     *                   (e.g. the p integral of wignerCore::sourceMoments()).
+     * @return C(k*).
+     */
+    double compute(double kStar, double radius, const std::vector<double> &edges, const std::vector<double> &cumulative) const;
+
+private:
+    std::vector<wignerTable> mTables; ///< |ψ|² of each channel.
+    std::vector<double> mWeights;     ///< Weight of each channel.
+
+    /// @brief Fraction of exp(-r² / 4R²) r² over all r that lies in [lo, hi].
+    static double fraction(double lo, double hi, double radius);
+};
+
+#endif
+/// @}
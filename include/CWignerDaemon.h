@@ -0,0 +1,152 @@
+/**
+ * @defgroup WignerDaemon Query Daemon
+ * @brief Long-running process answering coalescence queries over a Unix domain socket.
+ * @{
+ */
+
+#ifndef CWIGNERDAEMON
+#define CWIGNERDAEMON
+
+#include "CWignerProtocol.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+class wignerCache;
+class wignerSource;
+
+/**
+ * @class wignerDaemon
+ * @brief Serves batched (k*, r0) queries (see CWignerProtocol.h) from a pool of worker threads.
+ *
+ * The deuteron table, the configuration and the optional persistent cache are loaded once. Each
+ * worker owns a wignerSource (its TF2 objects are built once, not per query). The accept loop
+ * polls the listening socket and every open connection waiting for its next request; a request
+ * that arrives is queued and answered by the next free worker, after which the connection is
+ * polled again. Workers are thus shared by requests, not held by connections: any number of
+ * clients can stay connected, and the requests of one connection are still answered in order.
+ * Points already computed by any worker are answered from an in-memory table shared by the
+ * workers, then from the persistent cache if one is attached. A batch whose computation throws
+ * or gives non-finite observables is answered with wignerProtocol::kServerError.
+ *
+ * Every request is timed. The statistics (requests, points, latency mean, median, 99th
+ * percentile and maximum, points per second) can be queried by the clients and are printed
+ * periodically and at shutdown.
+ */
+class wignerDaemon
+{
+public:
+    /**
+     * @brief Constructor.
+     * @param txtinput Configuration file in the `config/default.txt` style.
+     * @param nThreads Number of worker threads (values < 1 are treated as 1).
+     */
+    wignerDaemon(const std::string &txtinput = "config/default.txt", int nThreads = 1);
+
+    /// @brief Set the number of worker threads (before serve()).
+    void setThreads(int nThreads);
+
+    /// @brief Print one line per request.
+    void setVerbose(bool verbose);
+
+    /**
+     * @brief Consult and fill a persistent result cache (not owned), nullptr to disable it.
+     * @param cache Cache shared by all worker threads.
+     */
+    void setCache(wignerCache *cache);
+
+    /// @brief Set the largest number of points kept in the in-memory table (0 disables it).
+    void setMemoSize(size_t size);
+
+    /// @brief Print the statistics every given number of seconds (0: only at shutdown).
+    void setReportInterval(double seconds);
+
+    /**
+     * @brief Listen on a Unix domain socket and serve until stop() is called.
+     *
+     * A stale socket file left by a previous daemon is replaced; any other existing file is an
+     * error. The socket file is removed on return.
+     * @param path Socket path.
+     * @return True if the daemon ran and stopped cleanly, false if the socket could not be set up.
+     */
+    bool serve(const std::string &path);
+
+    /// @brief Ask serve() to return; safe to call from a signal handler.
+    void stop();
+
+    /// @brief Get the statistics since the start of serve().
+    wignerDaemonStats getStats() const;
+
+    /**
+     * @brief Print statistics in a human-readable form.
+     * @param stats Statistics.
+     * @param out   Output stream.
+     */
+    static void printStats(const wignerDaemonStats &stats, std::ostream &out);
+
+private:
+    static const int kLatencyBins = 90; ///< Latency histogram: 10 log bins per decade from 1 µs.
+
+    std::string mConfig;           ///< Configuration file path.
+    int mThreads = 1;              ///< Number of worker threads.
+    bool mVerbose = false;         ///< Print one line per request.
+    wignerCache *mCache = nullptr; ///< Optional result cache (not owned).
+    size_t mMemoSize = 1000000;    ///< Largest number of points in the in-memory table.
+    double mReportInterval = 0;    ///< Seconds between two statistics reports.
+
+    std::atomic<bool> mStop{false};                              ///<! Set by stop().
+    std::deque<int> mPending;                                    ///<! Connections with a request, waiting for a worker.
+    std::vector<int> mIdle;                                      ///<! Connections polled for their next request.
+    int mWake[2] = {-1, -1};                                     ///<! Pipe waking the accept loop when mIdle grows.
+    std::mutex mQueueMutex;                                      ///<! Protects mPending and mIdle.
+    std::condition_variable mQueueCond;                          ///<! Wakes the workers.
+    mutable std::mutex mStatsMutex;                              ///<! Protects the statistics.
+    wignerDaemonStats mStats;                                    ///<! Counters of the statistics.
+    std::vector<uint64_t> mLatency;                              ///<! Latency histogram.
+    std::chrono::steady_clock::time_point mStart;                ///<! Start of serve().
+    std::map<std::pair<double, double>, wignerReplyPoint> mMemo; ///<! Computed points by (k*, r0).
+    std::mutex mMemoMutex;                                       ///<! Protects mMemo.
+
+    /**
+     * @brief Worker body: answer one request of each queued connection until stop().
+     * @param worker Worker index.
+     */
+    void work(int worker);
+
+    /**
+     * @brief Read and answer one request.
+     * @param fd Connected socket, readable.
+     * @param fw Source of the worker.
+     * @return True if the connection stays open for further requests.
+     */
+    bool serveRequest(int fd, wignerSource &fw);
+
+    /**
+     * @brief Compute a batch.
+     * @param fw      Source of the worker.
+     * @param queries Query points (already validated).
+     * @param replies Filled with one reply per point.
+     * @return Number of points taken from the in-memory table; throws std::runtime_error if a
+     *         point has non-finite observables.
+     */
+    size_t compute(wignerSource &fw, const std::vector<wignerQueryPoint> &queries, std::vector<wignerReplyPoint> &replies);
+
+    /**
+     * @brief Account for one served request.
+     * @param seconds  Latency.
+     * @param points   Number of points.
+     * @param memoHits Points taken from the in-memory table.
+     * @param error    Answered with an error status.
+     */
+    void record(double seconds, size_t points, size_t memoHits, bool error);
+};
+
+#endif
+/// @}
@@ -0,0 +1,126 @@
+/**
+ * @defgroup WignerDeuteronTable Deuteron Wigner Table Generator
+ * @brief Builds the deuteron Wigner table loaded by wignerUtils from a radial wavefunction.
+ * @{
+ */
+
+#ifndef CWIGNERDEUTERONTABLE
+#define CWIGNERDEUTERONTABLE
+
+#include "CWignerOverlap.h"
+#include "TString.h"
+#include <string>
+#include <vector>
+
+class TH2D;
+
+/**
+ * @class wignerDeuteronTable
+ * @brief Angle-averaged deuteron Wigner function W_d(r, p) computed from u(r) and w(r).
+ *
+ * With the spin- and polarization-averaged density matrix
+ *
+ *     ρ(r1, r2) = [u(r1) u(r2) + w(r1) w(r2) P2(r̂1·r̂2)] / (4π r1 r2),
+ *
+ * the Wigner function averaged over the angle between r and p is
+ *
+ *     W_d(r, p) = 4π / (2πħ)³ ∫ dy y² j0(p y / ħ) F(r, y),
+ *     F(r, y)   = ½ ∫ dμ ρ(r + y/2, r - y/2),   μ = r̂·ŷ,
+ *
+ * normalized to ∫ d³r d³p W_d = 1, as the table of `deuteronFunction/wigner2.root`.
+ *
+ * F is computed with Gauss-Legendre in μ on a uniform y grid. The y integral is a sine
+ * transform; the y step is chosen commensurate with the p bins, so that for each r bin all the
+ * p bins come out of a single FFT. The r bins are distributed over threads.
+ */
+class wignerDeuteronTable
+{
+public:
+    /**
+     * @brief Hulthén wavefunction u(r) = N (exp(-αr) - exp(-βr)), S-wave only.
+     * @param alpha α in fm⁻¹.
+     * @param beta  β in fm⁻¹.
+     * @return Generator holding the wavefunction.
+     */
+    static wignerDeuteronTable hulthen(double alpha = 0.2316, double beta = 1.385);
+
+    /**
+     * @brief Tabulated wavefunction (e.g. Argonne v18 or CD-Bonn), read from a text file.
+     *
+     * One line per point with r (fm), u(r) and optionally w(r) (fm⁻½); lines starting with
+     * '#' are skipped. The wavefunction is renormalized to ∫ (u² + w²) dr = 1.
+     * @param filename Input file.
+     * @return Generator holding the wavefunction.
+     */
+    static wignerDeuteronTable fromFile(const std::string &filename);
+
+    /**
+     * @brief Set the output binning.
+     * @param nR   Number of r bins.
+     * @param rMin Lower r edge (fm).
+     * @param rMax Upper r edge (fm).
+     * @param nP   Number of p bins.
+     * @param pMin Lower p edge (GeV/c).
+     * @param pMax Upper p edge (GeV/c).
+     */
+    void setGrid(int nR, double rMin, double rMax, int nP, double pMin, double pMax);
+
+    /// @brief Set the number of threads.
+    void setThreads(int nThreads);
+
+    /// @brief Set the maximum step of the y integration (fm), 0.05 by default.
+    void setStep(double dy);
+
+    /// @brief Set the number of Gauss-Legendre nodes of the μ integration, 24 by default.
+    void setAngularNodes(int n);
+
+    /// @brief D-state probability ∫ w² dr of the wavefunction.
+    double getDProbability() const;
+
+    /// @brief Overlap engine computing coal directly from the wavefunction (see wignerOverlap).
+    wignerOverlap overlap() const;
+
+    /**
+     * @brief Compute the table.
+     * @param name Histogram name.
+     * @return New histogram (owned by the caller, not attached to any directory).
+     */
+    TH2D *compute(const char *name = "h");
+
+    /**
+     * @brief Compute the table and write it into a new ROOT file as the TH2D "h".
+     * @param filename Output file name.
+     * @param binary   Also write the table in the ROOT-free format of wignerTable, if not empty.
+     * @return True on success.
+     */
+    bool write(const TString &filename, const std::string &binary = "");
+
+private:
+    double mStep = 0.005;      ///< Step of the wavefunction grid (fm).
+    std::vector<double> mPhiS; ///< u(r) / r on the wavefunction grid.
+    std::vector<double> mPhiD; ///< w(r) / r on the wavefunction grid, empty without D-wave.
+    double mPD = 0;            ///< D-state probability.
+
+    int mNR = 100;       ///< Number of r bins.
+    double mRMin = 0.;   ///< Lower r edge.
+    double mRMax = 20.;  ///< Upper r edge.
+    int mNP = 100;       ///< Number of p bins.
+    double mPMin = 0.;   ///< Lower p edge.
+    double mPMax = 0.6;  ///< Upper p edge.
+    int mThreads = 1;    ///< Number of threads.
+    double mDy = 0.05;   ///< Maximum y step.
+    int mNMu = 24;       ///< Gauss-Legendre nodes in μ.
+
+    /**
+     * @brief Sample u(r) and w(r) on the wavefunction grid.
+     * @param u Radial S-wave function.
+     * @param w Radial D-wave function (empty if absent).
+     */
+    void setWavefunction(const std::vector<double> &u, const std::vector<double> &w);
+
+    /// @brief Linear interpolation of a wavefunction grid.
+    double interpolate(const std::vector<double> &phi, double r) const;
+};
+
+#endif
+/// @}
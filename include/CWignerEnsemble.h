@@ -0,0 +1,219 @@
+/**
+ * @defgroup WignerEnsemble Parameter Uncertainty Ensemble
+ * @brief Propagates distributions of the model parameters to bands of the observables.
+ * @{
+ */
+
+#ifndef CWIGNERENSEMBLE
+#define CWIGNERENSEMBLE
+
+#include "TString.h"
+#include <string>
+#include <vector>
+
+class TF2;
+class TH2;
+class wignerSource;
+
+/**
+ * @struct wignerBand
+ * @brief Distribution of one observable over the ensemble at one k*.
+ */
+struct wignerBand
+{
+    double mean = 0;  ///< Ensemble mean.
+    double sigma = 0; ///< Ensemble standard deviation.
+    double q[5] = {}; ///< Quantiles at 2.5, 16, 50, 84 and 97.5 %.
+};
+
+/**
+ * @struct wignerBandPoint
+ * @brief Bands of the observables for a single k* value, one entry of the "bands" TTree.
+ */
+struct wignerBandPoint
+{
+    double k = 0;    ///< Input relative momentum k*.
+    wignerBand coal; ///< Deuteron coalescence probability.
+    wignerBand wK;   ///< Wigner-weighted kinetic energy.
+    wignerBand wV;   ///< Wigner-weighted potential energy.
+    wignerBand wH;   ///< Wigner-weighted Hamiltonian.
+};
+
+/**
+ * @class wignerEnsemble
+ * @brief Evaluates N correlated samples of (r0, mu, rWidth, V0, deuteron table) per k* point.
+ *
+ * Each parameter is fixed (default: the value of the configuration file), Gaussian or uniform;
+ * the parameters are correlated through a Gaussian copula (Cholesky factor of the correlation
+ * matrix) and the deuteron table is drawn from a weighted list. The samples are drawn once and
+ * reused for every k*, so the bands of neighbouring points are coherent.
+ *
+ * The cost does not scale with N. For each k*, the source is built at a few Chebyshev nodes in r0
+ * spanning the sampled range (a single node if r0 is fixed). At each node one pass over the
+ * (r, p) grid gives the radial marginal of W·J, whose prefix sums give ∫_{r < rWidth} W·J for
+ * any rWidth, and ∫ p² W·J; one integral per deuteron table gives coal. Then for a sample
+ *
+ *     ⟨K⟩ = ∫ p² W·J / (2 mu),   ⟨V⟩ = V0 ∫_{r < rWidth} W·J,
+ *
+ * and the node values are combined by barycentric interpolation in r0, so a sample costs
+ * O(nodes). The node integrals are distributed over threads.
+ */
+class wignerEnsemble
+{
+public:
+    /// @brief Index of the sampled parameters.
+    enum parameter
+    {
+        kR0 = 0,
+        kMu = 1,
+        kRWidth = 2,
+        kV0 = 3,
+        kNParameters = 4
+    };
+
+    /**
+     * @brief Constructor.
+     * @param txtinput Configuration file in the `config/default.txt` style, giving the fixed values.
+     * @param nThreads Number of worker threads (values < 1 are treated as 1).
+     */
+    wignerEnsemble(const std::string &txtinput = "config/default.txt", int nThreads = 1);
+
+    /// @brief Destructor, deletes the loaded deuteron tables.
+    ~wignerEnsemble();
+
+    /// @brief Set the number of worker threads.
+    void setThreads(int nThreads);
+
+    /// @brief Print one line per computed k* point.
+    void setVerbose(bool verbose);
+
+    /// @brief Set the number of samples, 1000 by default.
+    void setSamples(int nSamples);
+
+    /// @brief Set the seed of the sampling.
+    void setSeed(unsigned long seed);
+
+    /// @brief Set the number of Chebyshev nodes in r0, 7 by default.
+    void setNodes(int nNodes);
+
+    /// @brief Keep a parameter at a fixed value.
+    void setFixed(int par, double value);
+
+    /// @brief Draw a parameter from a Gaussian.
+    void setGaussian(int par, double mean, double sigma);
+
+    /// @brief Draw a parameter uniformly in [lo, hi].
+    void setUniform(int par, double lo, double hi);
+
+    /**
+     * @brief Set the correlation coefficient of two parameters (in the Gaussian copula).
+     * @param a   First parameter.
+     * @param b   Second parameter.
+     * @param rho Correlation coefficient in (-1, 1).
+     */
+    void setCorrelation(int a, int b, double rho);
+
+    /**
+     * @brief Add a deuteron table to the list the samples are drawn from.
+     *
+     * Without any table, the current table of wignerUtils is used.
+     * @param filename ROOT file holding the table (TH2D "h").
+     * @param weight   Relative probability of the table.
+     */
+    void addDeuteronTable(const TString &filename, double weight = 1.);
+
+    /**
+     * @brief Read the ensemble from a text file.
+     *
+     * One item per line, '#' starts a comment:
+     * @code
+     *   samples 1000
+     *   seed 1
+     *   nodes 7
+     *   r0 gauss 1.0 0.1          # or: fixed <x>, uniform <lo> <hi>
+     *   V0 uniform -0.020 -0.015
+     *   corr r0 V0 -0.3
+     *   table deuteronFunction/wigner2.root 1
+     * @endcode
+     * Parameter names are r0, mu, rWidth and V0.
+     * @param specfile Input file name.
+     */
+    void readSpec(const std::string &specfile);
+
+    /**
+     * @brief Compute the bands for the given k* values.
+     * @param kValues List of k* values.
+     * @return One wignerBandPoint per input value, in the same order.
+     */
+    std::vector<wignerBandPoint> run(const std::vector<double> &kValues);
+
+    /**
+     * @brief Write the bands into a TTree named "bands", and the samples into a TTree named "samples".
+     *
+     * The bands tree has the branch k and, for X in coal, wK, wV and wH, the branches X_mean,
+     * X_sigma, X_q025, X_q16, X_q50, X_q84 and X_q975.
+     * @param points  Bands to store.
+     * @param outfile Output ROOT file name (recreated).
+     * @return True on success.
+     */
+    bool writeTree(const std::vector<wignerBandPoint> &points, const TString &outfile) const;
+
+private:
+    /// Distribution of one parameter.
+    struct distribution
+    {
+        int type = 0; ///< 0 fixed, 1 Gaussian, 2 uniform.
+        double a = 0; ///< Value, mean or lower edge.
+        double b = 0; ///< Unused, sigma or upper edge.
+    };
+
+    /// Observables of the source at one (k*, r0 node).
+    struct node
+    {
+        std::vector<double> coal;  ///< Coalescence probability per table.
+        double p2 = 0;             ///< ∫ p² W·J.
+        std::vector<double> edges; ///< Radial cell edges of wignerCore::sourceMoments().
+        std::vector<double> cdf;   ///< ∫_{r < r_i} W·J at the r cell edges.
+    };
+
+    std::string mConfig;                      ///< Configuration file path.
+    int mThreads = 1;                         ///< Number of worker threads.
+    int mSamples = 1000;                      ///< Number of samples.
+    unsigned long mSeed = 1;                  ///< Seed of the sampling.
+    int mNodes = 7;                           ///< Chebyshev nodes in r0.
+    bool mVerbose = true;                     ///< Print one line per point.
+    distribution mDist[kNParameters];         ///< Parameter distributions.
+    double mCorr[kNParameters][kNParameters]; ///< Correlation matrix of the copula.
+    std::vector<TString> mTableFiles;         ///< Deuteron table files.
+    std::vector<double> mTableWeights;        ///< Deuteron table weights.
+
+    std::vector<TH2 *> mTables;              ///<! Loaded deuteron tables (nullptr: wignerUtils table).
+    std::vector<std::vector<double>> mDraws; ///<! Sampled parameters, one vector per sample.
+    std::vector<int> mDrawTables;            ///<! Sampled table index, one per sample.
+
+    /// @brief Parameter index of a name (r0, mu, rWidth, V0), -1 if unknown.
+    static int parameterIndex(const std::string &name);
+
+    /// @brief Draw the samples and load the deuteron tables.
+    void prepare();
+
+    /**
+     * @brief Compute the observables of one (k*, r0 node).
+     * @param fw    Source of the worker.
+     * @param coals Coalescence integrands of the worker, one per table (nullptr: the source's own).
+     * @param k     Relative momentum.
+     * @param r0    r0 of the node.
+     * @return Node observables.
+     */
+    node computeNode(wignerSource &fw, const std::vector<TF2 *> &coals, double k, double r0) const;
+
+    /**
+     * @brief Summarize the samples of one observable.
+     * @param values Sample values (sorted in place).
+     * @return Mean, standard deviation and quantiles.
+     */
+    static wignerBand summarize(std::vector<double> &values);
+};
+
+#endif
+/// @}
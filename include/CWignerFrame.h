@@ -0,0 +1,158 @@
+/**
+ * @defgroup WignerFrame RDataFrame Columns
+ * @brief Per-pair coalescence weights and energy moments as RDataFrame columns, one engine per slot.
+ * @{
+ */
+
+#ifndef CWIGNERFRAME
+#define CWIGNERFRAME
+
+#include "CWignerCoreSource.h"
+#include "CWignerLowRankTable.h"
+#include "CWignerTable.h"
+#include "ROOT/RVec.hxx"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @class wignerFrame
+ * @brief coal(k*, r0), ⟨K⟩, ⟨V⟩ and ⟨H⟩ for DefineSlot() in a multithreaded RDataFrame event loop.
+ *
+ * wignerSource cannot be called from a Define: the TF2 objects and the static state of
+ * wignerUtils (table, ranges, steps) are shared by all threads, and a point costs a full grid.
+ * wignerFrame takes a snapshot of that state once, in the constructor, and gives every slot of the
+ * event loop its own engine, a wignerCoreSource (no TF2, no static state) that only reads the
+ * shared table. The slot index of DefineSlot() selects the engine, so no lock is taken in the loop.
+ *
+ * Each engine computes the points from the factorization of W·J with the low-rank deuteron table
+ * (see wignerCoreSource::setLowRankTable(), about 0.3 ms per point) and keeps them on a lattice in
+ * (k*, r0): a pair costs a bilinear interpolation between four lattice points, each computed once
+ * per slot the first time a pair falls next to it. An r0 (k*) on a lattice line only needs the
+ * points of that line. Below the first lattice k*, dk, the values of dk are used (the source radius
+ * diverges at k* = 0). Pairs with k* <= 0 or r0 < 0 get NaN.
+ *
+ * The callables return RVec columns for RVec inputs (all pairs of an event) or a value for scalar
+ * inputs. The object must outlive the event loop.
+ *
+ * @code
+ *   ROOT::EnableImplicitMT();
+ *   ROOT::RDataFrame df("pairs", "pairs.root");
+ *   wignerFrame frame(df.GetNSlots(), "config/default.txt");
+ *   auto out = df.DefineSlot("coal", frame.column(wignerFrame::kCoal), {"kstar", "r0"})
+ *                .DefineSlot("wK", frame.column(wignerFrame::kWK), {"kstar", "r0"});
+ *   out.Snapshot("pairs", "weighted.root");
+ * @endcode
+ */
+class wignerFrame
+{
+public:
+    /// @brief Observables available as columns.
+    enum observable
+    {
+        kCoal, ///< Coalescence probability.
+        kWK,   ///< Wigner-weighted kinetic energy.
+        kWV,   ///< Wigner-weighted potential energy.
+        kWH,   ///< Wigner-weighted Hamiltonian.
+        kR     ///< Source radius.
+    };
+
+    /// @brief Vectorized column: one value per pair of the RVec inputs.
+    using vectorColumn = std::function<ROOT::RVecD(unsigned int, const ROOT::RVecD &, const ROOT::RVecD &)>;
+
+    /// @brief Scalar column: one value per entry.
+    using scalarColumn = std::function<double(unsigned int, double, double)>;
+
+    /**
+     * @brief Constructor, to be called before the event loop.
+     *
+     * Takes the deuteron table, the integration ranges and the steps from wignerUtils, and μ,
+     * rWidth and V0 from the configuration file (r0 is a column).
+     * @param nSlots   Number of slots of the data frame (RDataFrame::GetNSlots()), 0 for the size of the ROOT thread pool.
+     * @param txtinput Configuration file in the `config/default.txt` style.
+     */
+    wignerFrame(unsigned int nSlots = 0, const std::string &txtinput = "config/default.txt");
+
+    wignerFrame(const wignerFrame &) = delete;
+    wignerFrame &operator=(const wignerFrame &) = delete;
+
+    /**
+     * @brief Largest truncation error of the low-rank deuteron table, before the event loop.
+     * @param precision Relative truncation error (default 1e-4, see wignerLowRankTable), 0 for the
+     *                  grid integrals of wignerCoreSource (exact, about 0.2 s per lattice point).
+     */
+    void setCoalPrecision(double precision);
+
+    /**
+     * @brief Spacing of the lattice of computed points, before the event loop.
+     * @param dk  Spacing in k* (GeV/c, default 0.001).
+     * @param dr0 Spacing in r0 (fm, default 0.01); 0 for both computes every pair exactly.
+     */
+    void setLattice(double dk, double dr0);
+
+    /**
+     * @brief Observables of one pair.
+     * @param slot Slot of the calling thread.
+     * @param k    Relative momentum k* (GeV/c).
+     * @param r0   Reference radius (fm).
+     * @return Interpolated point (k is the input).
+     */
+    wignerPoint evaluate(unsigned int slot, double k, double r0);
+
+    /**
+     * @brief Callable for DefineSlot() over RVec columns of k* and r0 of equal size.
+     * @param obs Observable.
+     */
+    vectorColumn column(observable obs);
+
+    /**
+     * @brief Callable for DefineSlot() over scalar columns of k* and r0.
+     * @param obs Observable.
+     */
+    scalarColumn scalar(observable obs);
+
+    /// @brief Number of slots.
+    unsigned int getSlots() const;
+
+    /// @brief Number of lattice points computed by all slots so far (call outside the event loop).
+    size_t getNodes() const;
+
+    /// @brief Rank of the low-rank deuteron table (0 for the grid integrals).
+    int getRank() const;
+
+private:
+    /// @brief Engine of one slot.
+    struct engine
+    {
+        wignerCoreSource source;                         ///< Computes the lattice points.
+        std::unordered_map<uint64_t, wignerPoint> nodes; ///< Lattice points by (k* index, r0 index).
+    };
+
+    wignerTable mTable;                            ///< Snapshot of the deuteron table, shared by the slots.
+    std::unique_ptr<wignerLowRankTable> mLowRank;  ///< Decomposition of mTable, nullptr for the grid integrals.
+    wignerCoreSource mSource;                      ///< Settings (μ, rWidth, V0, ranges, steps) copied to the engines.
+    double mCoalPrecision = 1E-4;                  ///< Truncation error of mLowRank.
+    double mDk = 0.001;                            ///< Lattice spacing in k*.
+    double mDr0 = 0.01;                            ///< Lattice spacing in r0.
+    std::vector<std::unique_ptr<engine>> mEngines; ///< One engine per slot.
+
+    /// @brief Rebuild the engines after a change of the settings.
+    void setup();
+
+    /**
+     * @brief Lattice point of a slot, computed on first use.
+     * @param e Engine of the slot.
+     * @param i k* index (k* = i dk).
+     * @param j r0 index (r0 = j dr0).
+     */
+    const wignerPoint &node(engine &e, uint32_t i, uint32_t j);
+
+    /// @brief Value of an observable in a point.
+    static double value(const wignerPoint &pt, observable obs);
+};
+
+#endif
+/// @}
@@ -0,0 +1,114 @@
+/**
+ * @defgroup WignerGaussianMixture Gaussian-Mixture Deuteron Table
+ * @brief Sum of Gaussians fitted to the deuteron table, with a closed-form coalescence probability.
+ * @{
+ */
+
+#ifndef CWIGNERGAUSSIANMIXTURE
+#define CWIGNERGAUSSIANMIXTURE
+
+#include "CWignerTable.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @class wignerGaussianMixture
+ * @brief W_d(r, p) ≈ Σ_i c_i exp(-a_i r² - b_i p²), and coal(k*, R) as a sum over the components.
+ *
+ * Each component folded with the Gaussian source of wignerCore::wigner is a Gaussian integral,
+ *
+ *     coal = 8 N Σ_i c_i (π / α_i)^(3/2) (π / (β + b_i))^(3/2) exp(-β b_i k*² / (β + b_i)),
+ *     α_i  = 1 / 4R² + a_i,   β = 4R² / ħ²,
+ *
+ * with N the normalization of the source (1 on the whole phase space). The r and p factors
+ * only depend on a_i and b_i, so a point costs one exponential per distinct width rather than
+ * per component. The mixture is isotropic in r and p, like the angle-averaged table, so the
+ * average over the direction of k* is exact.
+ *
+ * fit() uses a tensor basis: nw widths in r times nw widths in p on geometric ladders, with the
+ * coefficients from a linear least-squares fit weighted by r² p² (the phase-space measure of the
+ * coal integral). The weights are separable, so the fit reduces to one QR factorization per
+ * axis. nw grows until the relative weighted residual is below the tolerance.
+ */
+class wignerGaussianMixture
+{
+public:
+    /// @brief Constructor, without components (coal() is then 0).
+    wignerGaussianMixture() = default;
+
+    /**
+     * @brief Constructor from the components.
+     * @param a        Coefficients of r² (fm⁻²), > 0.
+     * @param b        Coefficients of p² ((GeV/c)⁻²), > 0.
+     * @param c        Amplitudes.
+     * @param residual Relative residual of the fit that produced them.
+     */
+    wignerGaussianMixture(const std::vector<double> &a, const std::vector<double> &b, const std::vector<double> &c, double residual = 0);
+
+    /**
+     * @brief Fit a deuteron table.
+     * @param table     Table.
+     * @param tolerance Target of the relative residual sqrt(Σ r²p² (W - fit)² / Σ r²p² W²).
+     * @param maxWidths Largest number of widths per axis (K = maxWidths² components at most).
+     * @return Mixture with the smallest number of widths reaching the tolerance, else with maxWidths.
+     */
+    static wignerGaussianMixture fit(const wignerTable &table, double tolerance = 1E-3, int maxWidths = 16);
+
+    /**
+     * @brief Read the components from a text file written by write().
+     * @param filename Input file.
+     * @return Mixture.
+     */
+    static wignerGaussianMixture read(const std::string &filename);
+
+    /**
+     * @brief Write the components into a text file, one "a b c" line each.
+     * @param filename Output file.
+     * @return True on success.
+     */
+    bool write(const std::string &filename) const;
+
+    /// @brief Value of the mixture at (r, p).
+    double evaluate(double r, double p) const;
+
+    /**
+     * @brief Coalescence probability for a source radius and an effective k*.
+     * @param radius Source radius R (fm).
+     * @param kStar  Effective k* (GeV/c).
+     * @param norm   Normalization constant of the source (see wignerSource::getNorm()).
+     * @return coal.
+     */
+    double coal(double radius, double kStar, double norm = 1.) const;
+
+    /**
+     * @brief Coalescence probability with the radius and k* of wignerSource::setRadiusK(), source normalized to 1.
+     * @param k  Relative momentum k* (GeV/c).
+     * @param r0 Reference radius R0 (fm).
+     * @return coal.
+     */
+    double computeCoal(double k, double r0) const;
+
+    /// @brief Number of components.
+    size_t size() const;
+
+    /// @brief Relative residual of the fit.
+    double getResidual() const;
+
+    /// @brief Hash of the components, to key cached results.
+    uint64_t checksum() const;
+
+private:
+    std::vector<double> mA; ///< Coefficients of r² (fm⁻²).
+    std::vector<double> mB; ///< Coefficients of p² ((GeV/c)⁻²).
+    std::vector<double> mC; ///< Amplitudes.
+    double mResidual = 0;   ///< Relative residual of the fit.
+
+    std::vector<double> mWidthsA; ///< Distinct values of a.
+    std::vector<double> mWidthsB; ///< Distinct values of b.
+    std::vector<int> mIndexA;     ///< Index of the a of each component in mWidthsA.
+    std::vector<int> mIndexB;     ///< Index of the b of each component in mWidthsB.
+};
+
+#endif
+/// @}
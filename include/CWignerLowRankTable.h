@@ -0,0 +1,136 @@
+/**
+ * @defgroup WignerLowRankTable Low-Rank Deuteron Table
+ * @brief Truncated singular value decomposition of the deuteron table, for coal as 1D sums.
+ * @{
+ */
+
+#ifndef CWIGNERLOWRANKTABLE
+#define CWIGNERLOWRANKTABLE
+
+#include "CWignerTable.h"
+#include <vector>
+
+/**
+ * @class wignerLowRankTable
+ * @brief W_d(r, p) ≈ Σ_k σ_k u_k(r) v_k(p), with the rank chosen by a tolerance.
+ *
+ * The bilinear interpolation of wignerTable is a product of one weight per axis, so the SVD
+ * T = Σ_k σ_k u_k v_kᵀ of the matrix of bin contents carries over to the interpolated table:
+ * u_k(r) and v_k(p) are the singular vectors interpolated along their own axis, and the full
+ * rank reproduces wignerTable::interpolate() up to rounding. Since W·J of the Gaussian source
+ * factorizes as F(r) G(p), the coal integral on the grid becomes
+ *
+ *     coal = h³ Σ_k σ_k (Σ_i u_k(r_i) F(r_i) Δr_i) (Σ_j v_k(p_j) G(p_j) Δp_j),
+ *
+ * i.e. rank × (N + M) operations instead of N × M: projectGrid() once per grid, coal() per point
+ * (see wignerSource::setCoalPrecision()).
+ *
+ * The rank is the smallest one whose relative truncation error sqrt(Σ_{k > rank} σ_k² / Σ σ_k²),
+ * the Frobenius norm of the dropped part over that of the table, is below the tolerance. The
+ * singular values come from the eigenvalues of the Gram matrix of the smaller dimension, so
+ * tolerances below about 1e-7 are not resolved. Only the standard library is used, so the class
+ * is part of libWignerCore.
+ */
+class wignerLowRankTable
+{
+public:
+    /// @brief Empty table (rank 0, interpolates to 0).
+    wignerLowRankTable() = default;
+
+    /**
+     * @brief Decompose a table.
+     * @param table     Table.
+     * @param tolerance Largest relative truncation error.
+     * @param maxRank   Largest rank kept; getError() is above the tolerance if it is reached.
+     */
+    wignerLowRankTable(const wignerTable &table, double tolerance = 1E-4, int maxRank = 64);
+
+    /// @brief Value of the truncated table at (r, p), 0 outside the table as wignerTable::interpolate().
+    double interpolate(double x, double y) const;
+
+    /**
+     * @brief Factors of the truncated table on the nodes of a grid.
+     *
+     * u[k * r.size() + i] = σ_k u_k(r_i) and v[k * p.size() + j] = v_k(p_j), so that the table on
+     * node (i, j) is Σ_k u[k * r.size() + i] v[k * p.size() + j].
+     * @param r Radial nodes.
+     * @param p Momentum nodes.
+     * @param u Filled with the radial factors.
+     * @param v Filled with the momentum factors.
+     */
+    void project(const std::vector<double> &r, const std::vector<double> &p, std::vector<double> &u, std::vector<double> &v) const;
+
+    /**
+     * @brief Factors of the truncated table on the nodes of the integration grid, with the measure folded in.
+     *
+     * The nodes are those of wignerCore::gridNodes() split at getBreaks(); the factors are those
+     * of project() times r_i² Δr_i and Δp_j, the r² being that of the Jacobian, so that coal()
+     * only needs F(r) = exp(-r² / 4R²) and G(p).
+     * @param minX Lower r limit.
+     * @param maxX Upper r limit.
+     * @param minP Lower p limit.
+     * @param maxP Upper p limit.
+     * @param dx   Step in r.
+     * @param dp   Step in p.
+     * @param r    Filled with the radial nodes.
+     * @param p    Filled with the momentum nodes.
+     * @param u    Filled with σ_k u_k(r_i) r_i² Δr_i, rank x r.size().
+     * @param v    Filled with v_k(p_j) Δp_j, rank x p.size().
+     */
+    void projectGrid(double minX, double maxX, double minP, double maxP, double dx, double dp,
+                     std::vector<double> &r, std::vector<double> &p, std::vector<double> &u, std::vector<double> &v) const;
+
+    /**
+     * @brief Σ_k (Σ_i u[k, i] f_i) (Σ_j v[k, j] g_j), the integral of the table times f(r) g(p).
+     * @param u Radial factors of projectGrid().
+     * @param v Momentum factors of projectGrid().
+     * @param f f on the radial nodes.
+     * @param g g on the momentum nodes.
+     * @return Integral.
+     */
+    double coal(const std::vector<double> &u, const std::vector<double> &v, const std::vector<double> &f, const std::vector<double> &g) const;
+
+    /// @brief Break points of the interpolation, as wignerTable::getBreaks().
+    void getBreaks(std::vector<double> &rBreaks, std::vector<double> &pBreaks) const;
+
+    /// @brief Number of components kept.
+    int getRank() const;
+
+    /// @brief Relative truncation error of the kept components.
+    double getError() const;
+
+    /// @brief Singular values of the kept components.
+    const std::vector<double> &getSingularValues() const;
+
+private:
+    int mNx = 0;                ///< Number of r bins.
+    double mXMin = 0;           ///< Lower r edge.
+    double mXMax = 0;           ///< Upper r edge.
+    int mNy = 0;                ///< Number of p bins.
+    double mYMin = 0;           ///< Lower p edge.
+    double mYMax = 0;           ///< Upper p edge.
+    double mError = 0;          ///< Relative truncation error.
+    std::vector<double> mSigma; ///< Singular values, decreasing.
+    std::vector<double> mU;     ///< Left singular vectors on the r bins, mNx per component.
+    std::vector<double> mV;     ///< Right singular vectors on the p bins, mNy per component.
+
+    /**
+     * @brief Interpolation weights of one axis, as in wignerTable::interpolate().
+     * @param x  Coordinate.
+     * @param n  Number of bins.
+     * @param lo Lower edge.
+     * @param hi Upper edge.
+     * @param b1 Filled with the first bin (0-based).
+     * @param b2 Filled with the second bin (0-based).
+     * @param w1 Filled with the weight of b1.
+     * @param w2 Filled with the weight of b2.
+     * @return False outside the axis (both weights 0).
+     */
+    static bool weights(double x, int n, double lo, double hi, int &b1, int &b2, double &w1, double &w2);
+
+    /// @brief Eigenvalues (increasing) and eigenvectors (columns) of a symmetric n x n matrix.
+    static void eigen(int n, std::vector<double> &a, std::vector<double> &d);
+};
+
+#endif
+/// @}
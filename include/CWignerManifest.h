@@ -0,0 +1,168 @@
+/**
+ * @defgroup WignerManifest Shard Manifest
+ * @brief Description of a k* scan split into independent shards.
+ * @{
+ */
+
+#ifndef CWIGNERMANIFEST
+#define CWIGNERMANIFEST
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @struct wignerShard
+ * @brief One contiguous block of k* points of a sharded scan.
+ */
+struct wignerShard
+{
+    int index = 0;      ///< Shard index (0 ... nShards - 1).
+    long first = 0;     ///< Global index of the first point of the shard.
+    long count = 0;     ///< Number of points in the shard.
+    double kMin = 0;    ///< First k* value of the shard.
+    double kMax = 0;    ///< Last k* value of the shard.
+    std::string output; ///< ROOT file written by the shard.
+};
+
+/**
+ * @struct wignerScanSettings
+ * @brief Physics options of wignersim that change the results of a sharded scan.
+ *
+ * They are recorded in the manifest, so that every shard runs with those of the scan rather
+ * than with its own command line.
+ */
+struct wignerScanSettings
+{
+    bool testMode = false;     ///< TF2::Integral instead of the grid integration (--test-mode).
+    std::vector<double> radii; ///< Reference out, side, long radii of the anisotropic source (empty if isotropic).
+    std::string shape;         ///< Source shape specification (empty for the Gaussian wignerSource).
+    std::string potential;     ///< Potential specification (empty for the square well of the configuration file).
+    std::string nucleus;       ///< A = 3 nucleus, triton or he3 (empty for the deuteron).
+    std::string nucleusTable;  ///< Tabulated A = 3 nucleus (empty for the Gaussian nucleus).
+    double tolerance = 1E-3;   ///< Relative error target of the A = 3 Monte Carlo.
+
+    /**
+     * @brief Settings as one line of `key=value` items, only those differing from the defaults.
+     * @return Text hashed into wignerManifest::configHash, empty for the default settings.
+     */
+    std::string str() const;
+
+    /// @brief Files read by the settings (tabulated potential and nucleus), hashed with their text.
+    std::vector<std::string> files() const;
+};
+
+/**
+ * @class wignerManifest
+ * @brief Text manifest describing a sharded k* scan.
+ *
+ * The manifest records the scan range, the configuration file, the deuteron table and the
+ * physics settings of wignersim (and a hash of the configuration content chained with the
+ * table checksum and the settings, so that every node runs with the same parameters and table)
+ * and the list of shards with their point ranges and output files. Point i of the scan is k = start + i * step, so shards
+ * never overlap and can be computed in any order on any node sharing the filesystem.
+ *
+ * Format (one `key = value` per line, then one line per shard):
+ * @code
+ *   start = 0.001
+ *   end = 2
+ *   step = 0.005
+ *   config = config/default.txt
+ *   deuteron = deuteronFunction/wigner1.root
+ *   shape = levy:1.5
+ *   config_hash = 5c1e0e3e4a1f8d27
+ *   points = 400
+ *   shards = 8
+ *   shard 0 0 50 0.001 0.246 simres/res_part_0.root
+ * @endcode
+ *
+ * The deuteron line is only written for a table other than the default one, and the settings
+ * lines (test_mode, radii, shape, potential, nucleus, nucleus_table, mc_tolerance) only for
+ * values other than the defaults of wignerScanSettings.
+ */
+class wignerManifest
+{
+public:
+    /**
+     * @brief Build a manifest splitting [start, end) into nShards blocks of nearly equal size.
+     * @param start   First k* value.
+     * @param end     Upper bound of the scan (exclusive).
+     * @param step    Increment in k*.
+     * @param nShards Number of shards (clamped to the number of points).
+     * @param config  Configuration file path.
+     * @param prefix  Output prefix, shard i writes `<prefix>_part_i.root`.
+     * @param deuteron Deuteron table file, already loaded by wignerUtils::setDeuteronTable (empty for the default).
+     * @param settings Physics settings of the scan.
+     * @return The manifest, with no shards if the range is invalid.
+     */
+    static wignerManifest create(double start, double end, double step, int nShards,
+                                 const std::string &config, const std::string &prefix, const std::string &deuteron = "",
+                                 const wignerScanSettings &settings = {});
+
+    /**
+     * @brief Read a manifest file.
+     * @param filename Manifest path.
+     * @return The manifest; throws std::runtime_error on failure.
+     */
+    static wignerManifest read(const std::string &filename);
+
+    /**
+     * @brief Write the manifest to a file.
+     * @param filename Manifest path.
+     * @return True on success.
+     */
+    bool write(const std::string &filename) const;
+
+    /// @brief k* value of global point i.
+    double kAt(long i) const;
+
+    /// @brief k* values of the given shard.
+    std::vector<double> kValues(int shard) const;
+
+    /// @brief Check that the configuration file, the current deuteron table and the settings files still have the hash stored in the manifest.
+    bool configMatches() const;
+
+    /**
+     * @brief Text stored in every shard output and compared by wignermerge.
+     * @return The configuration hash followed by settings.str().
+     */
+    std::string stamp() const;
+
+    /**
+     * @brief Hash of a configuration file, of the current deuteron table and of the settings.
+     * @param config   Configuration file path.
+     * @param settings Physics settings.
+     * @return fileHash(config) chained with wignerUtils::getDeuteronChecksum(), settings.str() and
+     *         the files of the settings; 0 if one of the files cannot be read.
+     */
+    static uint64_t configHashOf(const std::string &config, const wignerScanSettings &settings = {});
+
+    /**
+     * @brief 64-bit FNV-1a hash of a byte buffer.
+     * @param data Pointer to the data.
+     * @param size Number of bytes.
+     * @param seed Initial hash value (to chain several buffers).
+     * @return Hash value.
+     */
+    static uint64_t hash(const void *data, size_t size, uint64_t seed = 14695981039346656037ULL);
+
+    /**
+     * @brief Hash of the content of a file.
+     * @param filename File to hash.
+     * @return Hash value, 0 if the file cannot be read.
+     */
+    static uint64_t fileHash(const std::string &filename);
+
+    double start = 0;                ///< First k* value.
+    double end = 0;                  ///< Upper bound of the scan (exclusive).
+    double step = 0;                 ///< Increment in k*.
+    long points = 0;                 ///< Total number of points.
+    std::string config;              ///< Configuration file path.
+    std::string deuteron;            ///< Deuteron table file (empty for the default table).
+    wignerScanSettings settings;     ///< Physics settings of the scan.
+    uint64_t configHash = 0;         ///< Hash of the configuration file content, of the deuteron table and of the settings.
+    std::vector<wignerShard> shards; ///< Shard list, ordered by index.
+};
+
+#endif
+/// @}
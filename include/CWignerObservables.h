@@ -0,0 +1,128 @@
+/**
+ * @defgroup WignerObservables User-Defined Observables
+ * @brief Integrands registered by the user and integrated in the pass of the coalescence probability.
+ * @{
+ */
+
+#ifndef CWIGNEROBSERVABLES
+#define CWIGNEROBSERVABLES
+
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * @class wignerObservables
+ * @brief Registry of observables ∫∫ f(r, p) [W] [J] [h³ W_d] dr dp.
+ *
+ * A new quantity (⟨r²⟩, ⟨p²⟩, another Hamiltonian, ...) needs neither a static function in
+ * wignerUtils nor a TF2 and a getter in wignerSource: register its integrand f(r, p), a compiled
+ * callable or a formula in x = r and y = p, and the factors it is multiplied by: the source W,
+ * the Jacobian J and the deuteron table h³ W_d (with f = 1 and all three, the observable is
+ * coal). wignerSource::computePoint() then integrates all of them in one pass over the grid, in
+ * which the factors are evaluated once per node, together with coal when that is integrated on
+ * the grid (see wignerSource::setObservables()); wignerScan writes them as extra branches named
+ * after the observables.
+ *
+ * Formulas are compiled by TFormula once, when they are registered, and are then only read, so a
+ * registry can be shared by the workers of a scan. Register before the scan starts.
+ *
+ * @code
+ *   wignerObservables obs;
+ *   obs.add("r2", "x*x");                                                  // ⟨r²⟩ of the source
+ *   obs.add("coalR2", [](double r, double) { return r * r; }, wignerObservables::kAll);
+ *   source.setObservables(&obs);
+ *   wignerPoint pt = source.computePoint(0.05);                            // pt.observables = {⟨r²⟩, ...}
+ * @endcode
+ */
+class wignerObservables
+{
+public:
+    /// @brief Shared factors of an integrand.
+    enum factor
+    {
+        kNone = 0,                             ///< f alone.
+        kSource = 1,                           ///< Source W (normalized).
+        kJacobian = 2,                         ///< Jacobian J.
+        kDeuteron = 4,                         ///< Deuteron table times h³.
+        kAll = kSource | kJacobian | kDeuteron ///< All of them.
+    };
+
+    /// @brief Integrand f(r, p) without the factors.
+    using integrand = std::function<double(double, double)>;
+
+    /**
+     * @brief Register a compiled integrand.
+     * @param name    Name of the observable (branch name of the output tree).
+     * @param f       Integrand f(r, p), callable from several threads at once.
+     * @param factors Sum of factor values multiplying f.
+     */
+    void add(const std::string &name, integrand f, int factors = kSource | kJacobian);
+
+    /**
+     * @brief Register a formula, compiled once by TFormula.
+     * @param name    Name of the observable (branch name of the output tree).
+     * @param formula Formula in x = r (fm) and y = p (GeV/c), without parameters.
+     * @param factors Sum of factor values multiplying the formula.
+     * @return False if the formula does not compile or has parameters.
+     */
+    bool add(const std::string &name, const std::string &formula, int factors = kSource | kJacobian);
+
+    /**
+     * @brief Register a formula from a command-line specification.
+     *
+     * The specification is <name>:<factors>:<formula>, with the factors a comma-separated list
+     * of source, jacobian and deuteron (or none), e.g. r2:source,jacobian:x*x.
+     * @param spec Specification.
+     * @return False if the specification or the formula is not valid.
+     */
+    bool add(const std::string &spec);
+
+    /// @brief Number of observables.
+    size_t size() const;
+
+    /// @brief Names of the observables, in the order of registration.
+    const std::vector<std::string> &getNames() const;
+
+    /// @brief Union of the factors of all observables.
+    int getFactors() const;
+
+    /**
+     * @brief Add the integrands at a node to an accumulator.
+     * @param r   Radius.
+     * @param p   Momentum.
+     * @param w   Source W(r, p).
+     * @param j   Jacobian J(r, p).
+     * @param d   h³ W_d(r, p) (any value if no observable uses it).
+     * @param acc Accumulator, size() values.
+     */
+    void accumulate(double r, double p, double w, double j, double d, double *acc) const
+    {
+        for (size_t i = 0; i < mIntegrands.size(); ++i)
+        {
+            const int factors = mFactors[i];
+            double v = mIntegrands[i](r, p);
+            if (factors & kSource)
+            {
+                v *= w;
+            }
+            if (factors & kJacobian)
+            {
+                v *= j;
+            }
+            if (factors & kDeuteron)
+            {
+                v *= d;
+            }
+            acc[i] += v;
+        }
+    }
+
+private:
+    std::vector<std::string> mNames;    ///< Names of the observables.
+    std::vector<integrand> mIntegrands; ///< Integrands without the factors.
+    std::vector<int> mFactors;          ///< Factors of each integrand.
+};
+
+#endif
+/// @}
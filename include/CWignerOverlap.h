@@ -0,0 +1,72 @@
+/**
+ * @defgroup WignerOverlap Wavefunction-Overlap Coalescence
+ * @brief Deuteron coalescence probability as 1D radial overlaps of the source and deuteron states.
+ * @{
+ */
+
+#ifndef CWIGNEROVERLAP
+#define CWIGNEROVERLAP
+
+#include <vector>
+
+/**
+ * @class wignerOverlap
+ * @brief coal(k*, R) from the radial wavefunctions u(r), w(r), without a Wigner table.
+ *
+ * The Gaussian source W of wignerCore::wigner is the Wigner function of the minimum-uncertainty
+ * state ψ(r) = (4πR²)^(-3/4) exp(-r² / 8R² + i k*·r / ħ). The phase-space overlap with the
+ * polarization-averaged deuteron density matrix of wignerDeuteronTable is then
+ *
+ *     coal = (2πħ)³ ∫ d³r d³p W W_d = ⟨ψ|ρ_d|ψ⟩ = 4π (I_0² + I_2²),
+ *     I_0  = ∫ dr r G(r) u(r) j0(k* r / ħ),   I_2 = ∫ dr r G(r) w(r) j2(k* r / ħ),
+ *
+ * with G the radial part of ψ, already averaged over the direction of k*. Each point costs one
+ * pass over the wavefunction grid instead of the 2D sum of wignerSource::getcoal(); the two
+ * agree up to the integration error of the grid and of the table, and to the normalization of
+ * W on the finite (r, p) range of the grid (which matters once k* approaches the p range).
+ * Only the standard library is used, so the class is part of libWignerCore.
+ */
+class wignerOverlap
+{
+public:
+    /// @brief Constructor, without wavefunction (coal() is then 0).
+    wignerOverlap() = default;
+
+    /**
+     * @brief Constructor.
+     * @param step Step of the wavefunction grid (fm); point i is at r = i * step.
+     * @param u    S-wave radial function u(r) (fm^-1/2), normalized with w to ∫ (u² + w²) dr = 1.
+     * @param w    D-wave radial function w(r), empty if absent.
+     */
+    wignerOverlap(double step, const std::vector<double> &u, const std::vector<double> &w = {});
+
+    /**
+     * @brief Coalescence probability for a source radius and an effective k*.
+     * @param radius Source radius R (fm).
+     * @param kStar  Effective k* (GeV/c).
+     * @return coal.
+     */
+    double coal(double radius, double kStar) const;
+
+    /**
+     * @brief Coalescence probability with the radius and k* of wignerSource::setRadiusK().
+     * @param k  Relative momentum k* (GeV/c).
+     * @param r0 Reference radius R0 (fm).
+     * @return coal.
+     */
+    double computeCoal(double k, double r0) const;
+
+    /// @brief D-state probability ∫ w² dr of the wavefunction.
+    double getDProbability() const;
+
+private:
+    double mStep = 0.005;   ///< Step of the wavefunction grid (fm).
+    std::vector<double> mU; ///< u(r) on the grid.
+    std::vector<double> mW; ///< w(r) on the grid, empty without D-wave.
+
+    /// @brief Spherical Bessel function j2(x).
+    static double besselJ2(double x);
+};
+
+#endif
+/// @}
@@ -0,0 +1,168 @@
+/**
+ * @defgroup WignerPotential Nucleon-Nucleon Potentials
+ * @brief Central potentials used for the ⟨V⟩ and ⟨H⟩ observables.
+ * @{
+ */
+
+#ifndef CWIGNERPOTENTIAL
+#define CWIGNERPOTENTIAL
+
+#include <string>
+#include <vector>
+
+/**
+ * @class wignerPotential
+ * @brief Central potential V(r) in GeV, r in fm.
+ *
+ * A potential is immutable: its parameters are set at construction. The sources evaluate it
+ * once on the radial nodes of the integration grid and keep the values until another potential
+ * is attached or the grid changes, so ⟨V⟩ = Σ_i V(r_i) m(r_i) is a dot product with the radial
+ * marginal m of W·J, whatever the cost of a single evaluation.
+ */
+class wignerPotential
+{
+public:
+    virtual ~wignerPotential() = default;
+
+    /**
+     * @brief Value of the potential.
+     * @param r Relative distance (fm).
+     * @return V(r) (GeV).
+     */
+    virtual double value(double r) const = 0;
+
+    /// @brief Name used on the command line.
+    virtual const char *name() const = 0;
+
+    /// @brief Parameters of the potential, stored in the result cache key.
+    virtual std::vector<double> getParameters() const = 0;
+
+    /// @brief Radii where V is discontinuous or has a kink, used to split the radial grid.
+    virtual std::vector<double> getBreaks() const { return {}; }
+
+    /**
+     * @brief Values of the potential on a list of radii.
+     * @param r Radii.
+     * @return V(r_i) for every radius.
+     */
+    std::vector<double> onNodes(const std::vector<double> &r) const;
+
+    /**
+     * @brief Build a potential from a specification.
+     *
+     * Accepted specifications: square:<width>,<depth>, yukawa:<V0>,<range>,
+     * woodssaxon:<V0>,<R>,<a> and table:<file>.
+     * @param spec Potential specification.
+     * @return New potential (owned by the caller), nullptr if the specification is not recognized.
+     */
+    static wignerPotential *create(const std::string &spec);
+};
+
+/**
+ * @class squareWellPotential
+ * @brief V = V0 for r < width, 0 beyond; the potential of wignerUtils::potentialEnergy.
+ */
+class squareWellPotential : public wignerPotential
+{
+public:
+    /**
+     * @brief Constructor.
+     * @param width Width of the well (fm, >= 0).
+     * @param depth Depth V0 of the well (GeV).
+     */
+    squareWellPotential(double width = 3.2, double depth = -17.4E-3);
+
+    double value(double r) const override { return r < mWidth ? mDepth : 0.; }
+    const char *name() const override { return "square"; }
+    std::vector<double> getParameters() const override { return {mWidth, mDepth}; }
+    std::vector<double> getBreaks() const override { return {mWidth}; }
+
+private:
+    double mWidth = 3.2;      ///< Width of the well.
+    double mDepth = -17.4E-3; ///< Depth of the well.
+};
+
+/**
+ * @class yukawaPotential
+ * @brief V = V0 exp(-r / a) / (r / a), with the range a = ħc / m of the exchanged meson.
+ *
+ * The 1/r singularity at the origin is integrable against the r² of the Jacobian, and the grid
+ * nodes are cell midpoints, so r = 0 is never evaluated.
+ */
+class yukawaPotential : public wignerPotential
+{
+public:
+    /**
+     * @brief Constructor.
+     * @param strength V0 (GeV), e times the value at r = a.
+     * @param range    Range a (fm, > 0), 1.43 fm for the pion.
+     */
+    yukawaPotential(double strength, double range);
+
+    double value(double r) const override;
+    const char *name() const override { return "yukawa"; }
+    std::vector<double> getParameters() const override { return {mStrength, mRange}; }
+
+private:
+    double mStrength = 0; ///< V0.
+    double mRange = 1.;   ///< Range a.
+};
+
+/**
+ * @class woodsSaxonPotential
+ * @brief V = V0 / (1 + exp((r - R) / a)).
+ */
+class woodsSaxonPotential : public wignerPotential
+{
+public:
+    /**
+     * @brief Constructor.
+     * @param depth       V0 (GeV).
+     * @param radius      Half-depth radius R (fm, >= 0).
+     * @param diffuseness Surface diffuseness a (fm, > 0).
+     */
+    woodsSaxonPotential(double depth, double radius, double diffuseness);
+
+    double value(double r) const override;
+    const char *name() const override { return "woodssaxon"; }
+    std::vector<double> getParameters() const override { return {mDepth, mRadius, mDiffuseness}; }
+
+private:
+    double mDepth = 0;       ///< V0.
+    double mRadius = 1.;     ///< Half-depth radius.
+    double mDiffuseness = 1; ///< Surface diffuseness.
+};
+
+/**
+ * @class tabulatedPotential
+ * @brief Potential read from a text file of (r, V) pairs, linearly interpolated.
+ *
+ * One pair per line, r in fm in increasing order and V in GeV; '#' starts a comment. Below the
+ * first radius V is the first value, beyond the last radius V = 0. The parameters are the
+ * table itself, so the cache key changes with any value.
+ */
+class tabulatedPotential : public wignerPotential
+{
+public:
+    /**
+     * @brief Constructor, reads the table.
+     * @param filename Input file name.
+     */
+    explicit tabulatedPotential(const std::string &filename);
+
+    double value(double r) const override;
+    const char *name() const override { return "table"; }
+    std::vector<double> getParameters() const override;
+    std::vector<double> getBreaks() const override { return {mR.back()}; }
+
+    /// @brief Get the file the table was read from.
+    const std::string &getFileName() const { return mFileName; }
+
+private:
+    std::string mFileName;  ///< Input file name.
+    std::vector<double> mR; ///< Radii of the table.
+    std::vector<double> mV; ///< Potential on the table.
+};
+
+#endif
+/// @}
@@ -0,0 +1,289 @@
+/**
+ * @defgroup WignerProtocol Query Daemon Protocol
+ * @brief Binary protocol of the wignerd query daemon, and a header-only client.
+ * @{
+ */
+
+#ifndef CWIGNERPROTOCOL
+#define CWIGNERPROTOCOL
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <vector>
+
+/*
+ * This header only depends on the C++ standard library and POSIX, so a transport code can
+ * include it without ROOT or the WignerUtils library.
+ *
+ * Every message, in both directions, is a wignerMessageHeader followed by `count` records.
+ * Numbers are in the native byte order: the socket is local, so client and daemon run on the
+ * same machine.
+ *
+ *   request  kQuery : header + count x wignerQueryPoint
+ *   reply    kQuery : header (status) + count x wignerReplyPoint (none if status != kOk)
+ *   request  kStats : header (count = 0)
+ *   reply    kStats : header + 1 x wignerDaemonStats
+ *
+ * A connection can carry any number of requests; the daemon answers them in order.
+ */
+
+/// @brief Constants of the protocol.
+namespace wignerProtocol
+{
+    const uint32_t kMagic = 0x57494744; ///< "WIGD".
+    const uint16_t kVersion = 1;        ///< Protocol version.
+    const uint32_t kMaxCount = 1 << 20; ///< Largest number of points in one request.
+
+    /// Message types.
+    enum type : uint16_t
+    {
+        kQuery = 1, ///< Batch of (k*, r0) points.
+        kStats = 2  ///< Latency and throughput statistics of the daemon.
+    };
+
+    /// Status of a reply.
+    enum status : uint32_t
+    {
+        kOk = 0,          ///< Request served.
+        kBadHeader = 1,   ///< Wrong magic, version or type, or count above kMaxCount.
+        kBadQuery = 2,    ///< Negative k* or r0 in the batch; no point was computed.
+        kServerError = 3  ///< Computation failed (exception or non-finite observables); no point is returned.
+    };
+}
+
+/**
+ * @struct wignerMessageHeader
+ * @brief Header of every request and reply.
+ */
+struct wignerMessageHeader
+{
+    uint32_t magic = wignerProtocol::kMagic;     ///< Must be wignerProtocol::kMagic.
+    uint16_t version = wignerProtocol::kVersion; ///< Must be wignerProtocol::kVersion.
+    uint16_t type = wignerProtocol::kQuery;      ///< Message type.
+    uint32_t count = 0;                          ///< Number of records after the header.
+    uint32_t status = wignerProtocol::kOk;       ///< Reply status (0 in requests).
+};
+
+/**
+ * @struct wignerQueryPoint
+ * @brief One point of a query batch.
+ */
+struct wignerQueryPoint
+{
+    double k = 0;  ///< Relative momentum k* (GeV/c).
+    double r0 = 1; ///< Reference radius R0 (fm).
+};
+
+/**
+ * @struct wignerReplyPoint
+ * @brief Observables of one point, as in wignerPoint.
+ */
+struct wignerReplyPoint
+{
+    double radius = 0; ///< Effective source radius.
+    double norm = 0;   ///< Normalization constant of the source.
+    double WW = 0;     ///< W x W normalization check.
+    double coal = 0;   ///< Deuteron coalescence probability.
+    double wK = 0;     ///< Wigner-weighted kinetic energy.
+    double wV = 0;     ///< Wigner-weighted potential energy.
+    double wH = 0;     ///< Wigner-weighted Hamiltonian.
+};
+
+/**
+ * @struct wignerDaemonStats
+ * @brief Statistics of the daemon since it started.
+ *
+ * The latency of a request runs from the end of its reading to the end of the writing of its reply.
+ */
+struct wignerDaemonStats
+{
+    uint64_t requests = 0;      ///< Query requests served.
+    uint64_t points = 0;        ///< Points computed or taken from the caches.
+    uint64_t memoHits = 0;      ///< Points taken from the in-memory table.
+    uint64_t errors = 0;        ///< Requests answered with an error status.
+    uint64_t connections = 0;   ///< Connections accepted.
+    double uptime = 0;          ///< Seconds since the daemon started.
+    double busy = 0;            ///< Sum of the request latencies (s).
+    double latencyMean = 0;     ///< Mean request latency (s).
+    double latencyP50 = 0;      ///< Median request latency (s), from a log-binned histogram.
+    double latencyP99 = 0;      ///< 99th percentile of the request latency (s), from the histogram.
+    double latencyMax = 0;      ///< Largest request latency (s).
+    double pointsPerSecond = 0; ///< Points served per second of uptime.
+};
+
+/**
+ * @class wignerClient
+ * @brief Minimal blocking client of wignerd, for codes that cannot link ROOT.
+ *
+ * @code
+ *   wignerClient client;
+ *   if (client.open("/tmp/wignerd.sock"))
+ *   {
+ *       std::vector<wignerQueryPoint> q = {{0.05, 1.2}, {0.10, 1.2}};
+ *       std::vector<wignerReplyPoint> r;
+ *       client.query(q, r);
+ *   }
+ * @endcode
+ */
+class wignerClient
+{
+public:
+    wignerClient() = default;
+    wignerClient(const wignerClient &) = delete;
+    wignerClient &operator=(const wignerClient &) = delete;
+
+    /// @brief Destructor, closes the connection.
+    ~wignerClient() { close(); }
+
+    /**
+     * @brief Connect to a daemon.
+     * @param path Path of the Unix domain socket.
+     * @return True on success.
+     */
+    bool open(const std::string &path)
+    {
+        close();
+        sockaddr_un addr;
+        std::memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        if (path.size() >= sizeof(addr.sun_path))
+        {
+            return false;
+        }
+        std::strcpy(addr.sun_path, path.c_str());
+        mFd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (mFd < 0)
+        {
+            return false;
+        }
+        if (::connect(mFd, (sockaddr *)&addr, sizeof(addr)) < 0)
+        {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    /// @brief Close the connection.
+    void close()
+    {
+        if (mFd >= 0)
+        {
+            ::close(mFd);
+            mFd = -1;
+        }
+    }
+
+    /**
+     * @brief Send a batch and wait for the observables.
+     * @param points Query points.
+     * @param replies Filled with one reply per point, in the same order.
+     * @return Reply status (wignerProtocol::kOk on success), or kServerError if the connection failed.
+     */
+    uint32_t query(const std::vector<wignerQueryPoint> &points, std::vector<wignerReplyPoint> &replies)
+    {
+        wignerMessageHeader header;
+        header.type = wignerProtocol::kQuery;
+        header.count = points.size();
+        if (!sendAll(&header, sizeof(header)) || !sendAll(points.data(), points.size() * sizeof(wignerQueryPoint)))
+        {
+            return wignerProtocol::kServerError;
+        }
+        if (!recvAll(&header, sizeof(header)))
+        {
+            return wignerProtocol::kServerError;
+        }
+        if (header.status != wignerProtocol::kOk)
+        {
+            return header.status;
+        }
+        replies.resize(header.count);
+        return recvAll(replies.data(), replies.size() * sizeof(wignerReplyPoint)) ? header.status : uint32_t(wignerProtocol::kServerError);
+    }
+
+    /**
+     * @brief Ask the daemon for its statistics.
+     * @param stats Filled on success.
+     * @return True on success.
+     */
+    bool stats(wignerDaemonStats &stats)
+    {
+        wignerMessageHeader header;
+        header.type = wignerProtocol::kStats;
+        return sendAll(&header, sizeof(header)) && recvAll(&header, sizeof(header)) &&
+               header.status == wignerProtocol::kOk && header.count == 1 && recvAll(&stats, sizeof(stats));
+    }
+
+    /**
+     * @brief Write a whole buffer to a socket, retrying on partial writes and signals.
+     * @param fd   Socket.
+     * @param data Buffer.
+     * @param size Number of bytes.
+     * @return True if every byte was written.
+     */
+    static bool writeAll(int fd, const void *data, size_t size)
+    {
+#ifdef MSG_NOSIGNAL
+        const int flags = MSG_NOSIGNAL; // a closed peer is an error, not a SIGPIPE
+#else
+        const int flags = 0;
+#endif
+        const char *p = (const char *)data;
+        while (size > 0)
+        {
+            ssize_t n = ::send(fd, p, size, flags);
+            if (n < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (n <= 0)
+            {
+                return false;
+            }
+            p += n;
+            size -= n;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Read a whole buffer from a socket, retrying on partial reads and signals.
+     * @param fd   Socket.
+     * @param data Buffer.
+     * @param size Number of bytes.
+     * @return True if every byte was read; false on error or end of stream.
+     */
+    static bool readAll(int fd, void *data, size_t size)
+    {
+        char *p = (char *)data;
+        while (size > 0)
+        {
+            ssize_t n = ::recv(fd, p, size, 0);
+            if (n < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (n <= 0)
+            {
+                return false;
+            }
+            p += n;
+            size -= n;
+        }
+        return true;
+    }
+
+private:
+    int mFd = -1; ///< Connected socket, -1 if closed.
+
+    bool sendAll(const void *data, size_t size) { return writeAll(mFd, data, size); }
+    bool recvAll(void *data, size_t size) { return readAll(mFd, data, size); }
+};
+
+#endif
+/// @}
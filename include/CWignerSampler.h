@@ -0,0 +1,195 @@
+/**
+ * @defgroup WignerSampler Phase-Space Sampler
+ * @brief Batches of (r, p) drawn from the Gaussian source and from its coalescence-weighted distribution.
+ * @{
+ */
+
+#ifndef CWIGNERSAMPLER
+#define CWIGNERSAMPLER
+
+#include "CWignerTable.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @class wignerRandom
+ * @brief xoshiro256+ random engine, one independent stream per index.
+ *
+ * Stream i starts from the seed state advanced by i jumps of 2^128 draws, so streams never
+ * overlap. Satisfies UniformRandomBitGenerator, for use with the <random> distributions; the
+ * upper 53 bits (used by uniform()) are of full quality.
+ */
+class wignerRandom
+{
+public:
+    using result_type = uint64_t;
+
+    /**
+     * @brief Constructor.
+     * @param seed   Seed.
+     * @param stream Stream index.
+     */
+    wignerRandom(uint64_t seed = 12345, uint64_t stream = 0);
+
+    /// @brief Next 64-bit number.
+    uint64_t operator()()
+    {
+        uint64_t result = mS[0] + mS[3], t = mS[1] << 17;
+        mS[2] ^= mS[0];
+        mS[3] ^= mS[1];
+        mS[1] ^= mS[2];
+        mS[0] ^= mS[3];
+        mS[2] ^= t;
+        mS[3] = (mS[3] << 45) | (mS[3] >> 19);
+        return result;
+    }
+
+    /// @brief Uniform number in [0, 1).
+    double uniform() { return ((*this)() >> 11) * 0x1.0p-53; }
+
+    /// @brief Uniform number in (0, 1], safe for a logarithm.
+    double uniformPositive() { return (((*this)() >> 11) + 1) * 0x1.0p-53; }
+
+    /// @brief Advance by 2^128 draws.
+    void jump();
+
+    static constexpr uint64_t min() { return 0; }
+    static constexpr uint64_t max() { return ~uint64_t(0); }
+
+private:
+    uint64_t mS[4]; ///< State.
+};
+
+/**
+ * @class wignerSampler
+ * @brief Random (r, p) for event generators, without TF2::GetRandom2.
+ *
+ * sampleSource() draws from W·J, the distribution of the lengths r = |r⃗| and p = |p⃗| under the
+ * Gaussian source of wignerCore::wigner: r⃗ is normal with σ² = 2R² per component and p⃗ is
+ * normal around k⃗ with σ² = ħ² / 8R². The draw is exact and needs no table,
+ *
+ *     r = σ_r sqrt(-2 ln u₁ + z₁²),   p = sqrt((k* + σ_p z₂)² - 2 σ_p² ln u₂),
+ *
+ * with z₁, z₂ from one Marsaglia polar pair. The source is not truncated to the integration range
+ * (wignerSource normalizes it on that range).
+ *
+ * sampleCoalescence() draws from W_d·W·J, where the nucleons that coalesce sit, after
+ * setTable(): the cells of the integration grid get their probability once, in a Walker alias
+ * table, and a draw is one cell (two uniform numbers) with r and p uniform inside it, as
+ * TH2::GetRandom2 does with its bins. The cells are those of the grid of wignerSource::getcoal(),
+ * so h³ N times the sum of the cell weights is coal (see getCoal()).
+ *
+ * The table is a Wigner function and is negative in places: the cells are drawn with |W_d|·W·J
+ * and each sample carries the sign of its cell, so averages are Σ sign f / Σ sign.
+ *
+ * Both draw in batches. The overloads without engine use a wignerRandom stream per thread (see
+ * stream()), so one sampler can be shared by any number of threads. Only the standard library
+ * is used, so the class is part of libWignerCore.
+ */
+class wignerSampler
+{
+public:
+    /**
+     * @brief Constructor.
+     * @param radius Source radius R (fm).
+     * @param kStar  Effective k* (GeV/c).
+     */
+    wignerSampler(double radius = 1., double kStar = 0.);
+
+    /**
+     * @brief Tabulate W_d·W·J for sampleCoalescence(), on the grid of the coal integral.
+     *
+     * Uses the radius and k* of the constructor.
+     * @param table Deuteron table (only used during the call).
+     * @param minX  Lower r limit.
+     * @param maxX  Upper r limit.
+     * @param minP  Lower p limit.
+     * @param maxP  Upper p limit.
+     * @param dx    Step in r.
+     * @param dp    Step in p.
+     */
+    void setTable(const wignerTable &table, double minX = 0., double maxX = 20., double minP = 0., double maxP = 0.6,
+                  double dx = 0.01, double dp = 0.001);
+
+    /**
+     * @brief Draw from the source W·J.
+     * @param n   Number of samples.
+     * @param r   Filled with n radii (fm).
+     * @param p   Filled with n momenta (GeV/c).
+     * @param rng Random engine.
+     */
+    void sampleSource(size_t n, double *r, double *p, wignerRandom &rng) const;
+
+    /// @brief sampleSource() with the stream of the calling thread.
+    void sampleSource(size_t n, double *r, double *p) const;
+
+    /**
+     * @brief Draw from |W_d|·W·J; nothing is drawn before setTable().
+     * @param n    Number of samples.
+     * @param r    Filled with n radii (fm).
+     * @param p    Filled with n momenta (GeV/c).
+     * @param sign Filled with the sign (±1) of W_d in the cell of each sample, nullptr to ignore it.
+     * @param rng  Random engine.
+     */
+    void sampleCoalescence(size_t n, double *r, double *p, double *sign, wignerRandom &rng) const;
+
+    /// @brief sampleCoalescence() with the stream of the calling thread.
+    void sampleCoalescence(size_t n, double *r, double *p, double *sign = nullptr) const;
+
+    /**
+     * @brief Coalescence probability of the tabulated grid.
+     * @param norm Normalization constant of the source (see wignerSource::getNorm()).
+     * @return h³ N Σ W_d·W·J ΔrΔp, the getcoal() of the grid.
+     */
+    double getCoal(double norm = 1.) const;
+
+    /// @brief Σ |W_d|·W·J ΔrΔp over Σ W_d·W·J ΔrΔp: the variance penalty of the signs (1 if W_d >= 0).
+    double getSignRatio() const;
+
+    /// @brief Number of cells with a non-zero weight.
+    size_t getCells() const;
+
+    /// @brief Source radius.
+    double getRadius() const;
+
+    /// @brief Effective k*.
+    double getKStar() const;
+
+    /**
+     * @brief Random engine of the calling thread.
+     *
+     * Created on first use in each thread from the seed of setSeed() and the number of streams
+     * created before it.
+     */
+    static wignerRandom &stream();
+
+    /// @brief Seed of the streams created after the call (default 12345).
+    static void setSeed(uint64_t seed);
+
+private:
+    double mRadius = 1.; ///< Source radius.
+    double mKStar = 0.;  ///< Effective k*.
+    double mSigmaR = 0.; ///< Width of each component of r⃗.
+    double mSigmaP = 0.; ///< Width of each component of p⃗.
+
+    /// @brief Column of the alias table: a cell, kept with probability prob, else its alias.
+    struct column
+    {
+        double prob;   ///< Probability to keep the cell.
+        uint32_t r[2]; ///< Radial index of the cell and of the alias.
+        uint32_t p[2]; ///< Momentum index of the cell and of the alias.
+        float sign[2]; ///< Sign of W_d in the cell and in the alias.
+    };
+
+    std::vector<double> mRLow;    ///< Lower r edge of the radial cells.
+    std::vector<double> mRWidth;  ///< Widths of the radial cells.
+    std::vector<double> mPLow;    ///< Lower p edge of the momentum cells.
+    std::vector<double> mPWidth;  ///< Widths of the momentum cells.
+    std::vector<column> mColumns; ///<! Alias table, one column per non-empty cell (not streamed, rebuilt by setTable()).
+    double mWeight = 0;           ///< Σ W_d·W·J ΔrΔp with the source normalized to 1.
+    double mAbsWeight = 0;        ///< Σ |W_d|·W·J ΔrΔp.
+};
+
+#endif
+/// @}
@@ -0,0 +1,285 @@
+/**
+ * @defgroup WignerScan Wigner k* Scan Driver
+ * @brief Compiled driver that evaluates the source observables over a list of k* values.
+ * @{
+ */
+
+#ifndef CWIGNERSCAN
+#define CWIGNERSCAN
+
+#include "CWignerContributionMap.h"
+#include "CWignerSource.h"
+#include "TString.h"
+#include <string>
+#include <vector>
+
+/**
+ * @class wignerScan
+ * @brief Evaluates wignerSource observables over a set of k* values using several threads.
+ *
+ * Each worker thread owns its own wignerSource (and therefore its own TF2 objects),
+ * configured from the same text file. The k* points are distributed round-robin over the
+ * workers and the results are returned in the order of the input list.
+ */
+class wignerNucleusA3;
+
+class wignerScan
+{
+public:
+    /**
+     * @brief Constructor.
+     * @param txtinput Path to the configuration file in the `config/default.txt` style.
+     * @param nThreads Number of worker threads (values < 1 are treated as 1).
+     */
+    wignerScan(const std::string &txtinput = "config/default.txt", int nThreads = 1);
+
+    /// @brief Set the number of worker threads.
+    void setThreads(int nThreads);
+
+    /// @brief Use TF2::Integral instead of the custom grid integration (see wignerSource::initFunctions).
+    void setTestMode(bool testMode);
+
+    /// @brief Print one line per computed point.
+    void setVerbose(bool verbose);
+
+    /**
+     * @brief Consult and fill a persistent result cache (not owned), nullptr to disable it.
+     * @param cache Cache shared by all worker threads.
+     */
+    void setCache(wignerCache *cache);
+
+    /**
+     * @brief Switch to the anisotropic source (wignerAnisotropicSource) with the given reference radii.
+     *
+     * mu, rWidth and V0 are still read from the configuration file.
+     * @param rOut  Reference out radius.
+     * @param rSide Reference side radius.
+     * @param rLong Reference long radius.
+     */
+    void setAnisotropic(double rOut, double rSide, double rLong);
+
+    /**
+     * @brief Switch to A = 3 coalescence (wignerThreeBody) with the given nucleus.
+     *
+     * The points are then computed one after the other, each Monte Carlo integration using
+     * all the worker threads. The result cache is not used.
+     * @param nucleus   Nucleus Wigner function (not owned), nullptr for the default triton.
+     * @param tolerance Target relative error of the coalescence probability.
+     */
+    void setThreeBody(const wignerNucleusA3 *nucleus, double tolerance = 1E-3);
+
+    /**
+     * @brief Switch to wignerShapedSource with the given source shape.
+     *
+     * Accepted specifications: gauss, exponential, cauchy, levy:<alpha> and
+     * corehalo:<fraction>,<ratio> (see CWignerShapes.h).
+     * @param spec Shape specification.
+     * @return False if the specification is not recognized.
+     */
+    bool setShape(const std::string &spec);
+
+    /**
+     * @brief Use another potential than the square well of the configuration file.
+     *
+     * Accepted specifications: square:<width>,<depth>, yukawa:<V0>,<range>,
+     * woodssaxon:<V0>,<R>,<a> and table:<file> (see CWignerPotential.h). Each worker builds
+     * its own copy. Not available for the anisotropic and A = 3 sources.
+     * @param spec Potential specification.
+     * @return False if the specification is not recognized.
+     */
+    bool setPotential(const std::string &spec);
+
+    /**
+     * @brief Compute coal for several deuteron tables in the same pass over the grid.
+     *
+     * Each file must hold a TH2 "h" (e.g. from wignertable). The points then carry one
+     * coalescence probability per table (wignerPoint::coalTables, "coal_<i>" in writeTree) and
+     * coal is that of the first table. Only for the Gaussian wignerSource; the result cache is not used.
+     * @param files ROOT files of the tables.
+     * @return False if a table cannot be read.
+     */
+    bool setDeuteronTables(const std::vector<std::string> &files);
+
+    /// @brief Get the files of the tables set with setDeuteronTables().
+    const std::vector<std::string> &getDeuteronTables() const;
+
+    /**
+     * @brief Compute coal in closed form from a Gaussian mixture (see wignerSource::setMixture()).
+     *
+     * Only for the Gaussian wignerSource.
+     * @param mixture Mixture (not owned), nullptr to integrate the deuteron table.
+     */
+    void setMixture(const wignerGaussianMixture *mixture);
+
+    /**
+     * @brief Compute coal from the low-rank deuteron table when accurate enough (see wignerSource::setCoalPrecision()).
+     *
+     * Only for the Gaussian wignerSource.
+     * @param precision Largest relative truncation error accepted, 0 to always integrate the grid.
+     */
+    void setCoalPrecision(double precision);
+
+    /**
+     * @brief Integrate user-defined observables for every point (see wignerSource::setObservables()).
+     *
+     * The points carry one value per observable (wignerPoint::observables), written by writeTree
+     * as branches named after them. Only for the Gaussian wignerSource; the result cache is not used.
+     * @param observables Registry (not owned, shared by the workers), nullptr for none.
+     */
+    void setObservables(const wignerObservables *observables);
+
+    /**
+     * @brief Compute the Koonin–Pratt correlation function for every point (see wignerSource::setCorrelation()).
+     *
+     * The points carry C(k*) of their source radius (wignerPoint::cf), written by writeTree as
+     * the branch "cf". Only for the Gaussian wignerSource.
+     * @param correlation Pair wavefunctions (not owned, shared by the workers), nullptr for none.
+     */
+    void setCorrelation(const wignerCorrelation *correlation);
+
+    /**
+     * @brief Fill contribution maps of coal, ⟨K⟩ and ⟨V⟩ for every point of run().
+     *
+     * The maps cover the integration range of wignerUtils with nr x np bins (see
+     * wignerContributionMap) and are kept until the next run(). Only for the Gaussian
+     * wignerSource on the grid (not in test mode); the result cache is not used.
+     * @param nr Number of r bins, 0 to disable the maps.
+     * @param np Number of p bins.
+     */
+    void setContributionMaps(int nr, int np);
+
+    /// @brief Contribution maps of the last run(), one per point (empty if disabled).
+    const std::vector<wignerContributionMap> &getContributionMaps() const;
+
+    /**
+     * @brief Write the contribution maps of the last run() into the directory "maps" of a file.
+     *
+     * The histograms of point i are named <obs>_rp_<i>, <obs>_r_<i> and <obs>_p_<i>, with
+     * <obs> = coal, wK, wV, and carry the k* of the point in their title.
+     * @param outfile ROOT file (updated), e.g. written by writeTree.
+     * @return True on success.
+     */
+    bool writeContributionMaps(const TString &outfile) const;
+
+    /// @brief Get the number of worker threads.
+    int getThreads() const;
+
+    /// @brief Get the configuration file path.
+    const std::string &getConfig() const;
+
+    /**
+     * @brief Build the list of k* values start, start + step, ... strictly below end.
+     *
+     * Points are computed as start + i * step, so that no rounding error accumulates
+     * along the scan.
+     *
+     * @param start First k* value (must be >= 0).
+     * @param end   Upper bound of the scan (exclusive).
+     * @param step  Increment in k* (must be > 0).
+     * @return Vector of k* values, empty if the range is invalid.
+     */
+    static std::vector<double> kGrid(double start, double end, double step);
+
+    /**
+     * @brief Compute all observables for the given k* values.
+     * @param kValues List of k* values.
+     * @return One wignerPoint per input value, in the same order.
+     */
+    std::vector<wignerPoint> run(const std::vector<double> &kValues);
+
+    /**
+     * @brief Write a list of points into a TTree named "tree" in a new ROOT file.
+     *
+     * The branch layout is the one produced by macros/wignersim.cpp, so the output can be
+     * merged with `hadd` and read by makeplots. With shard information, the branches
+     * "idx" and "shard" are added and the tree is indexed on "idx". Points of a multi-table
+     * scan add one branch "coal_<i>" per table, titled with the table file when given, and
+     * points with user-defined observables one branch per observable.
+     *
+     * @param points        Points to store.
+     * @param outfile       Output ROOT file name (recreated).
+     * @param withShardInfo Also store the idx/shard branches and build the tree index.
+     * @param tableNames    Titles of the coal_<i> branches (see setDeuteronTables()).
+     * @param observableNames Names of the branches of wignerPoint::observables (see wignerObservables::getNames()).
+     * @param withCorrelation Also store the branch "cf" of the correlation function (see setCorrelation()).
+     * @return True on success.
+     */
+    static bool writeTree(const std::vector<wignerPoint> &points, const TString &outfile, bool withShardInfo = false,
+                          const std::vector<std::string> &tableNames = {}, const std::vector<std::string> &observableNames = {},
+                          bool withCorrelation = false);
+
+    /**
+     * @brief Read the points stored in a TTree written by writeTree.
+     * @param infile  Input ROOT file name.
+     * @param points  Vector to which the points are appended.
+     * @return True on success; false if the file or the tree cannot be read.
+     */
+    static bool readTree(const TString &infile, std::vector<wignerPoint> &points);
+
+    /**
+     * @brief Store a text as the TNamed "stamp" of a file, e.g. the wignerManifest::stamp() of a shard.
+     * @param outfile ROOT file (updated), e.g. written by writeTree.
+     * @param stamp   Text to store.
+     * @return True on success.
+     */
+    static bool writeStamp(const TString &outfile, const std::string &stamp);
+
+    /**
+     * @brief Read the text stored by writeStamp.
+     * @param infile Input ROOT file name.
+     * @return The stamp, empty if the file or the stamp cannot be read.
+     */
+    static std::string readStamp(const TString &infile);
+
+private:
+    std::string mConfig;                             ///< Configuration file path.
+    int mThreads = 1;                                ///< Number of worker threads.
+    bool mTestMode = false;                          ///< Forwarded to wignerSource::initFunctions.
+    bool mVerbose = true;                            ///< Print one line per point.
+    wignerCache *mCache = nullptr;                   ///< Optional result cache (not owned).
+    bool mAnisotropic = false;                       ///< Use wignerAnisotropicSource.
+    double mR0s[3] = {1., 1., 1.};                   ///< Reference out, side, long radii of the anisotropic source.
+    bool mThreeBody = false;                         ///< Use wignerThreeBody.
+    const wignerNucleusA3 *mNucleus = nullptr;       ///< A = 3 nucleus (not owned).
+    double mTolerance = 1E-3;                        ///< Relative error target of the A = 3 Monte Carlo.
+    std::string mShape;                              ///< Source shape name, empty for wignerSource.
+    std::vector<double> mShapeParams;                ///< Parameters of the source shape.
+    std::string mPotential;                          ///< Potential specification, empty for the square well.
+    std::vector<std::string> mTableFiles;            ///< Files of the deuteron tables of a multi-table scan.
+    std::vector<wignerTable> mTables;                ///< Deuteron tables of a multi-table scan.
+    int mMapBins[2] = {0, 0};                        ///< r and p bins of the contribution maps (0: disabled).
+    std::vector<wignerContributionMap> mMaps;        ///< Contribution maps of the last run, one per point.
+    const wignerGaussianMixture *mMixture = nullptr; ///< Closed-form deuteron table (not owned).
+    double mCoalPrecision = 0;                       ///< Largest truncation error of the low-rank coal.
+    const wignerObservables *mObservables = nullptr; ///< User-defined observables (not owned).
+    const wignerCorrelation *mCorrelation = nullptr; ///< Pair wavefunctions of the correlation function (not owned).
+
+    /**
+     * @brief Worker body: compute every nThreads-th point starting at index worker.
+     * @param worker  Worker index.
+     * @param kValues Input k* values.
+     * @param points  Output vector (already sized).
+     */
+    void work(int worker, const std::vector<double> &kValues, std::vector<wignerPoint> &points);
+
+    /**
+     * @brief Worker body for a source of the given shape (see work()).
+     * @param worker    Worker index.
+     * @param shape     Source shape.
+     * @param potential Potential of the worker, nullptr for the square well.
+     * @param kValues   Input k* values.
+     * @param points    Output vector (already sized).
+     */
+    template <class Shape>
+    void workShaped(int worker, const Shape &shape, const wignerPotential *potential, const std::vector<double> &kValues,
+                    std::vector<wignerPoint> &points);
+
+    /**
+     * @brief Print one point if verbose.
+     * @param pt Point to print.
+     */
+    void print(const wignerPoint &pt);
+};
+
+#endif
+/// @}
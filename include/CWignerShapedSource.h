@@ -0,0 +1,473 @@
+/**
+ * @defgroup WignerShapedSource Source with a Pluggable Shape
+ * @brief Isotropic source whose spatial profile is a compile-time template parameter.
+ * @{
+ */
+
+#ifndef CWIGNERSHAPEDSOURCE
+#define CWIGNERSHAPEDSOURCE
+
+#include "CWignerCache.h"
+#include "CWignerPotential.h"
+#include "CWignerShapes.h"
+#include "CWignerSource.h"
+#include "CWignerUtils.h"
+#include "TMath.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/**
+ * @class wignerShapedSource
+ * @brief Coalescence probability and energy moments of a source of the given Shape (see wignerShapeBase).
+ *
+ * The components of the shape are separable in r and p, so each observable is built from the
+ * 1D marginals 4π r² S_c(r) and 4π p² G_c(p) on the grid of wignerUtils::integral, recomputed
+ * only when the radius or k* change:
+ *
+ *  - the normalization and ⟨K⟩ are products of 1D sums;
+ *  - ⟨V⟩ uses the cumulative probability of the shape, cdf(rWidth), which is analytic for the
+ *    Gaussian, exponential, Cauchy and core-halo shapes, so it has no discretization step at
+ *    the edge of the well; with another potential (setPotential()) it is the dot product of the
+ *    potential on the radial nodes, computed once, with the radial marginal;
+ *  - coal is a single pass over the (r, p) grid with the deuteron table.
+ *
+ * The shape is a template parameter, so the per-node calls are resolved at compile time.
+ * `wignerShapedSource<gaussianShape>` reproduces wignerSource.
+ */
+template <class Shape>
+class wignerShapedSource
+{
+public:
+    /**
+     * @brief Constructor.
+     * @param shape Shape (copied), e.g. levyShape(1.5).
+     */
+    explicit wignerShapedSource(const Shape &shape = Shape()) : mShape(shape) {}
+
+    /// @brief Get the shape.
+    const Shape &getShape() const { return mShape; }
+
+    /// @brief Set the reference radius R0.
+    void setR0(double r0);
+
+    /// @brief Set the source radius directly.
+    void setRadius(double radius);
+
+    /// @brief Set relative momentum and update radius/k* with the relations of the shape.
+    void setRadiusK(double k);
+
+    /// @brief Set the reduced mass of the system.
+    void setMu(double mu);
+
+    /// @brief Set the potential spatial width.
+    void setRWidth(double rWidth);
+
+    /// @brief Set the depth of the potential well.
+    void setV0(double v0);
+
+    /**
+     * @brief Use another potential than the square well for ⟨V⟩ and ⟨H⟩ (see wignerSource::setPotential).
+     * @param potential Potential (not owned), nullptr to go back to the square well of rWidth and V0.
+     */
+    void setPotential(const wignerPotential *potential);
+
+    /// @brief Get the current value of the source radius.
+    double getRadius() const { return mRadius; }
+
+    /// @brief Get the current value of k*.
+    double getKStar() const { return mKStar; }
+
+    /// @brief Get the normalization constant, 1 / ∫ W·J on the grid (1 up to truncation).
+    double getNorm();
+
+    /// @brief Get the Wigner-weighted kinetic energy.
+    double getwK();
+
+    /// @brief Get the Wigner-weighted potential energy.
+    double getwV();
+
+    /// @brief Get the Wigner-weighted Hamiltonian.
+    double getwH();
+
+    /// @brief Get the deuteron coalescence probability.
+    double getcoal();
+
+    /**
+     * @brief Check normalization of the WxW function.
+     * @return Integral result scaled by h^3; 1 for a Gaussian, the purity of the state otherwise.
+     */
+    double checkWxW();
+
+    /**
+     * @brief Compute all observables for one k* value (see wignerSource::computePoint).
+     * @param k Relative momentum (k*).
+     * @return Observables of the point.
+     */
+    wignerPoint computePoint(double k);
+
+    /// @brief Attach a persistent result cache (not owned), nullptr to disable it.
+    void setCache(wignerCache *cache) { mCache = cache; }
+
+    /// @brief Key identifying the current shape and parameters in the result cache.
+    wignerCacheKey getCacheKey();
+
+    /**
+     * @brief Set r0, mu, rWidth, V0 from a `config/default.txt` style file.
+     * @param txtfile Input file name.
+     */
+    void SetFromTxt(const std::string &txtfile);
+
+private:
+    static constexpr int kComponents = Shape::kComponents;
+
+    Shape mShape;           ///< Source shape.
+    double mR0 = 1.;        ///< Reference radius R0.
+    double mRadius = 1.;    ///< Source radius.
+    double mKin = 0.050;    ///< Input k*.
+    double mKStar = 0.050;  ///< Effective k*.
+    double mMu = 0.938 / 2; ///< Reduced mass.
+    double mRWidth = 3.2;   ///< Width of the potential well.
+    double mV0 = -17.4E-3;  ///< Depth of the potential well.
+    double mNorm = 1.;      ///< Normalization constant.
+    double mWW = 0;         ///< Unnormalized WxW integral.
+    bool mDirty = true;     ///< Marginals need to be recomputed.
+
+    std::vector<double> mR;                             ///< Radial grid nodes.
+    std::vector<double> mP;                             ///< Momentum grid nodes.
+    std::array<std::vector<double>, kComponents> mAr;   ///< w_c 4π r² S_c(r) dr on the radial nodes.
+    std::array<std::vector<double>, kComponents> mAp;   ///< 4π p² G_c(p) dp on the momentum nodes.
+    std::array<double, kComponents> mSumR;              ///< Sums of mAr.
+    std::array<double, kComponents> mSumP;              ///< Sums of mAp.
+
+    wignerCache *mCache = nullptr; ///<! Optional persistent result cache (not owned).
+
+    const wignerPotential *mPotential = nullptr; ///<! Attached potential (not owned), nullptr for the square well.
+    bool mPotentialDirty = true;                 ///<! Potential values need to be recomputed.
+    double mVGrid[3] = {};                       ///<! Range and step of the radial grid of mV.
+    std::vector<double> mV;                      ///<! Attached potential on the radial nodes.
+
+    /// @brief Recompute grids and marginals if the radius or k* changed.
+    void update();
+};
+
+//_________________________________________________________________________
+template <class Shape>
+void wignerShapedSource<Shape>::setR0(double r0)
+{
+    if (r0 < 0)
+    {
+        std::cerr << "Error: r0 is negative\n";
+        std::abort();
+    }
+    mR0 = r0;
+}
+//_________________________________________________________________________
+template <class Shape>
+void wignerShapedSource<Shape>::setRadius(double radius)
+{
+    if (radius <= 0)
+    {
+        std::cerr << "Error: source radius is not positive\n";
+        std::abort();
+    }
+    mRadius = radius;
+    mDirty = true;
+}
+//_________________________________________________________________________
+template <class Shape>
+void wignerShapedSource<Shape>::setRadiusK(double k)
+{
+    if (k < 0)
+    {
+        std::cerr << "Error: k is negative\n";
+        std::abort();
+    }
+    mKin = k;
+    mRadius = mShape.radius(k, mR0);
+    mKStar = mShape.kStarEff(k, mRadius);
+    mDirty = true;
+}
+//_________________________________________________________________________
+template <class Shape>
+void wignerShapedSource<Shape>::setMu(double mu)
+{
+    if (mu <= 0)
+    {
+        std::cerr << "Error: reduced mass is not positive\n";
+        std::abort();
+    }
+    mMu = mu;
+}
+//_________________________________________________________________________
+template <class Shape>
+void wignerShapedSource<Shape>::setRWidth(double rWidth)
+{
+    if (rWidth < 0)
+    {
+        std::cerr << "Error: potential well width is negative\n";
+        std::abort();
+    }
+    mRWidth = rWidth;
+}
+//_________________________________________________________________________
+template <class Shape>
+void wignerShapedSource<Shape>::setV0(double v0)
+{
+    mV0 = v0;
+}
+//_________________________________________________________________________
+template <class Shape>
+void wignerShapedSource<Shape>::setPotential(const wignerPotential *potential)
+{
+    mPotential = potential;
+    mPotentialDirty = true;
+}
+//_________________________________________________________________________
+template <class Shape>
+void wignerShapedSource<Shape>::update()
+{
+    if (!mDirty)
+    {
+        return;
+    }
+
+    double minX = wignerUtils::getMinX(), maxX = wignerUtils::getMaxX();
+    double minP = wignerUtils::getMinP(), maxP = wignerUtils::getMaxP();
+    int nR = std::max(1, int(std::ceil((maxX - minX) / wignerUtils::getDx() - 1E-6)));
+    int nP = std::max(1, int(std::ceil((maxP - minP) / wignerUtils::getDp() - 1E-6)));
+    double dx = (maxX - minX) / nR;
+    double dp = (maxP - minP) / nP;
+
+    mR.resize(nR);
+    mP.resize(nP);
+    for (int i = 0; i < nR; ++i)
+    {
+        mR[i] = minX + (i + 0.5) * dx;
+    }
+    for (int j = 0; j < nP; ++j)
+    {
+        mP[j] = minP + (j + 0.5) * dp;
+    }
+
+    double norm = 0;
+    std::array<double, kComponents> size;
+    for (int c = 0; c < kComponents; ++c)
+    {
+        size[c] = mShape.componentRadius(c, mRadius);
+        double w = mShape.weight(c);
+        mAr[c].resize(nR);
+        mAp[c].resize(nP);
+        mSumR[c] = mSumP[c] = 0;
+        for (int i = 0; i < nR; ++i)
+        {
+            mAr[c][i] = w * 4 * TMath::Pi() * mR[i] * mR[i] * mShape.density(c, mR[i], size[c]) * dx;
+            mSumR[c] += mAr[c][i];
+        }
+        for (int j = 0; j < nP; ++j)
+        {
+            mAp[c][j] = wignerShapeBase::momentum(mP[j], mKStar, size[c]) * dp;
+            mSumP[c] += mAp[c][j];
+        }
+        norm += mSumR[c] * mSumP[c];
+    }
+    mNorm = 1. / norm;
+
+    // W x W couples every pair of components
+    mWW = 0;
+    for (int a = 0; a < kComponents; ++a)
+    {
+        for (int b = 0; b < kComponents; ++b)
+        {
+            double sumR = 0, sumP = 0;
+            for (int i = 0; i < nR; ++i)
+            {
+                sumR += 4 * TMath::Pi() * mR[i] * mR[i] * mShape.density(a, mR[i], size[a]) * mShape.density(b, mR[i], size[b]);
+            }
+            for (int j = 0; j < nP; ++j)
+            {
+                sumP += wignerShapeBase::momentum(mP[j], mKStar, size[a], size[b], true);
+            }
+            mWW += mShape.weight(a) * mShape.weight(b) * sumR * dx * sumP * dp;
+        }
+    }
+    mDirty = false;
+}
+//_________________________________________________________________________
+template <class Shape>
+double wignerShapedSource<Shape>::getNorm()
+{
+    update();
+    return mNorm;
+}
+//_________________________________________________________________________
+template <class Shape>
+double wignerShapedSource<Shape>::getwK()
+{
+    update();
+    double res = 0;
+    for (int c = 0; c < kComponents; ++c)
+    {
+        double sumK = 0;
+        for (size_t j = 0; j < mP.size(); ++j)
+        {
+            sumK += mAp[c][j] * mP[j] * mP[j] / (2 * mMu);
+        }
+        res += mSumR[c] * sumK;
+    }
+    return mNorm * res;
+}
+//_________________________________________________________________________
+template <class Shape>
+double wignerShapedSource<Shape>::getwV()
+{
+    update();
+    if (mPotential)
+    {
+        // the radial nodes only move with the global grid, not with the radius
+        double grid[3] = {wignerUtils::getMinX(), wignerUtils::getMaxX(), wignerUtils::getDx()};
+        if (mPotentialDirty || !std::equal(grid, grid + 3, mVGrid))
+        {
+            std::copy(grid, grid + 3, mVGrid);
+            mV = mPotential->onNodes(mR);
+            mPotentialDirty = false;
+        }
+        double res = 0;
+        for (int c = 0; c < kComponents; ++c)
+        {
+            double sumV = 0;
+            for (size_t i = 0; i < mR.size(); ++i)
+            {
+                sumV += mAr[c][i] * mV[i];
+            }
+            res += sumV * mSumP[c];
+        }
+        return mNorm * res;
+    }
+
+    double minX = wignerUtils::getMinX();
+    double edge = std::min(mRWidth, wignerUtils::getMaxX());
+    double res = 0;
+    for (int c = 0; c < kComponents; ++c)
+    {
+        double size = mShape.componentRadius(c, mRadius);
+        double inside = edge > minX ? mShape.cdf(c, edge, size) - mShape.cdf(c, minX, size) : 0.;
+        res += mShape.weight(c) * inside * mSumP[c];
+    }
+    return mNorm * res * mV0;
+}
+//_________________________________________________________________________
+template <class Shape>
+double wignerShapedSource<Shape>::getwH()
+{
+    return getwK() + getwV();
+}
+//_________________________________________________________________________
+template <class Shape>
+double wignerShapedSource<Shape>::getcoal()
+{
+    update();
+    double x[2];
+    double res = 0;
+    for (size_t i = 0; i < mR.size(); ++i)
+    {
+        x[0] = mR[i];
+        for (size_t j = 0; j < mP.size(); ++j)
+        {
+            x[1] = mP[j];
+            double w = 0;
+            for (int c = 0; c < kComponents; ++c)
+            {
+                w += mAr[c][i] * mAp[c][j];
+            }
+            res += w * wignerUtils::wignerDeuteron(x, nullptr);
+        }
+    }
+    double h = wignerUtils::getHCut() * 2 * TMath::Pi();
+    return res * mNorm * h * h * h;
+}
+//_________________________________________________________________________
+template <class Shape>
+double wignerShapedSource<Shape>::checkWxW()
+{
+    update();
+    double h = wignerUtils::getHCut() * 2 * TMath::Pi();
+    return mWW * mNorm * mNorm * h * h * h;
+}
+//_________________________________________________________________________
+template <class Shape>
+wignerPoint wignerShapedSource<Shape>::computePoint(double k)
+{
+    wignerPoint pt;
+    pt.k = k;
+    setRadiusK(k);
+
+    if (mCache && mCache->fetch(getCacheKey(), pt))
+    {
+        return pt;
+    }
+
+    pt.r0 = getRadius();
+    pt.norm = getNorm();
+    pt.WW = checkWxW();
+    pt.wK = getwK();
+    pt.wV = getwV();
+    pt.wH = pt.wK + pt.wV;
+    pt.coal = getcoal();
+
+    if (mCache)
+    {
+        mCache->store(getCacheKey(), pt);
+    }
+    return pt;
+}
+//_________________________________________________________________________
+template <class Shape>
+wignerCacheKey wignerShapedSource<Shape>::getCacheKey()
+{
+    wignerCacheKey key;
+    for (const char *c = Shape::name(); *c; ++c)
+    {
+        key.params.push_back(*c);
+    }
+    for (double x : mShape.getParameters())
+    {
+        key.params.push_back(x);
+    }
+    key.params.insert(key.params.end(), {mR0, mKin, mRadius, mKStar, mMu, mRWidth, mV0,
+                                         wignerUtils::getMinX(), wignerUtils::getMaxX(), wignerUtils::getMinP(), wignerUtils::getMaxP(),
+                                         wignerUtils::getDx(), wignerUtils::getDp()});
+    if (mPotential)
+    {
+        for (const char *c = mPotential->name(); *c; ++c)
+        {
+            key.params.push_back(*c);
+        }
+        std::vector<double> params = mPotential->getParameters();
+        key.params.insert(key.params.end(), params.begin(), params.end());
+    }
+    key.table = wignerUtils::getDeuteronChecksum();
+    return key;
+}
+//_________________________________________________________________________
+template <class Shape>
+void wignerShapedSource<Shape>::SetFromTxt(const std::string &txtfile)
+{
+    std::vector<double> params = wignerSource::readParamsFromFile(txtfile);
+    if (params.size() < 8)
+    {
+        std::cerr << "Error: expected 8 parameters, got " << params.size() << "\n";
+        return;
+    }
+    setR0(params[0]);
+    setMu(params[1]);
+    setRWidth(params[2]);
+    setV0(params[3]);
+}
+
+#endif
+/// @}
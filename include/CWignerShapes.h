@@ -0,0 +1,209 @@
+/**
+ * @defgroup WignerShapes Source Shapes
+ * @brief Spatial profiles of the source used as template parameters of wignerShapedSource.
+ * @{
+ */
+
+#ifndef CWIGNERSHAPES
+#define CWIGNERSHAPES
+
+#include <string>
+#include <vector>
+
+/**
+ * @class wignerShapeBase
+ * @brief Parts shared by all the shapes; a shape may hide any of them with its own version.
+ *
+ * A shape describes a source Wigner function made of separable components,
+ *
+ *     W(r, p) = Σ_c w_c S_c(r) G_c(p),
+ *
+ * where S_c is a spatial density normalized to ∫ d³r S_c = 1 with size R_c, and G_c the
+ * Gaussian momentum distribution of the Gaussian source of the same size,
+ *
+ *     G_c(p) = (4 R_c² / (π ħ²))^{3/2} exp(-4 R_c² (p - k*)² / ħ²).
+ *
+ * For a single Gaussian component this is the wignerUtils::wignerSource function. The shape
+ * is a template parameter of wignerShapedSource, so every call below is resolved at compile
+ * time; there is no virtual dispatch, and the integration loops only read the marginals.
+ *
+ * A shape provides:
+ *  - `static constexpr int kComponents`, the number of components;
+ *  - `double weight(int c) const` and `double componentRadius(int c, double radius) const`;
+ *  - `double density(int c, double r, double radius) const`, S_c(r) for the component radius;
+ *  - `double cdf(int c, double a, double radius) const`, ∫_{r < a} d³r S_c, used for ⟨V⟩;
+ *  - `double radius(double k, double r0) const` and `double kStarEff(double k, double radius) const`;
+ *  - `std::vector<double> getParameters() const` and `static const char *name()`.
+ */
+class wignerShapeBase
+{
+public:
+    /// @brief Number of separable components.
+    static constexpr int kComponents = 1;
+
+    /// @brief Weight of a component.
+    double weight(int) const { return 1.; }
+
+    /// @brief Size of a component for the source radius.
+    double componentRadius(int, double radius) const { return radius; }
+
+    /// @brief Source radius for k* and R0, wignerUtils::radius() by default.
+    double radius(double k, double r0) const;
+
+    /// @brief Effective k* for the source radius, wignerUtils::kStarEff() by default.
+    double kStarEff(double k, double radius) const;
+
+    /// @brief Shape parameters, stored in the result cache key.
+    std::vector<double> getParameters() const { return {}; }
+
+    /**
+     * @brief Momentum part of one component, or of the product of two (for W x W).
+     *
+     * Returns 4π p² times the average over the direction of p of G_a, or of G_a G_b if squared
+     * is true, with k* along a fixed axis.
+     * @param p       Momentum.
+     * @param kStar   Effective k*.
+     * @param ra      Size of the first component.
+     * @param rb      Size of the second component (ignored if squared is false).
+     * @param squared Product of the two distributions instead of the first one alone.
+     * @return Angle-integrated momentum density.
+     */
+    static double momentum(double p, double kStar, double ra, double rb = 0, bool squared = false);
+};
+
+/**
+ * @class gaussianShape
+ * @brief S(r) = exp(-r² / (4R²)) / (4π R²)^{3/2}, the shape of wignerSource.
+ */
+class gaussianShape : public wignerShapeBase
+{
+public:
+    /// @brief Name used on the command line.
+    static const char *name() { return "gauss"; }
+
+    /// @brief Spatial density.
+    double density(int c, double r, double radius) const;
+
+    /// @brief Probability of r < a: erf(a / 2R) - a exp(-a² / 4R²) / (√π R).
+    double cdf(int c, double a, double radius) const;
+};
+
+/**
+ * @class exponentialShape
+ * @brief S(r) = exp(-r / R) / (8π R³).
+ */
+class exponentialShape : public wignerShapeBase
+{
+public:
+    /// @brief Name used on the command line.
+    static const char *name() { return "exponential"; }
+
+    /// @brief Spatial density.
+    double density(int c, double r, double radius) const;
+
+    /// @brief Probability of r < a: 1 - exp(-x) (1 + x + x²/2), x = a / R.
+    double cdf(int c, double a, double radius) const;
+};
+
+/**
+ * @class cauchyShape
+ * @brief S(r) = 1 / (π² R³ (1 + r² / R²)²), the Fourier transform of exp(-qR) (Lévy α = 1).
+ */
+class cauchyShape : public wignerShapeBase
+{
+public:
+    /// @brief Name used on the command line.
+    static const char *name() { return "cauchy"; }
+
+    /// @brief Spatial density.
+    double density(int c, double r, double radius) const;
+
+    /// @brief Probability of r < a: (2 / π) (atan x - x / (1 + x²)), x = a / R.
+    double cdf(int c, double a, double radius) const;
+};
+
+/**
+ * @class levyShape
+ * @brief Symmetric Lévy-stable source, S(r) = ∫ d³q / (2π)³ exp(i q·r - (qR)^α).
+ *
+ * α = 2 is the Gaussian and α = 1 the Cauchy shape. The dimensionless profile
+ * s(x) = R³ S(xR) = 1 / (2π² x) ∫ dq q sin(qx) exp(-q^α) and its cumulative probability are
+ * tabulated once at construction; beyond the table s follows the power law x^{-(3 + α)}.
+ */
+class levyShape : public wignerShapeBase
+{
+public:
+    /**
+     * @brief Constructor.
+     * @param alpha Stability index in [1, 2]; below 1 the tail beyond the table holds too much of the probability.
+     */
+    explicit levyShape(double alpha = 1.5);
+
+    /// @brief Name used on the command line.
+    static const char *name() { return "levy"; }
+
+    /// @brief Get the stability index.
+    double getAlpha() const { return mAlpha; }
+
+    /// @brief Shape parameters, stored in the result cache key.
+    std::vector<double> getParameters() const { return {mAlpha}; }
+
+    /// @brief Spatial density.
+    double density(int c, double r, double radius) const;
+
+    /// @brief Probability of r < a, from the tabulated cumulative profile.
+    double cdf(int c, double a, double radius) const;
+
+private:
+    double mAlpha = 1.5;      ///< Stability index.
+    double mStep = 0.01;      ///< Step of the table in x = r / R.
+    std::vector<double> mS;   ///< s(x) on the table.
+    std::vector<double> mCdf; ///< ∫_{x' < x} 4π x'² s(x') dx' on the table.
+};
+
+/**
+ * @class coreHaloShape
+ * @brief Two Gaussian components: a core of size R and a halo of size λR.
+ *
+ * W = f W_R + (1 - f) W_{λR}, each component with its own momentum width, i.e. the mixture
+ * of two Gaussian sources. f = 1 is the Gaussian shape.
+ */
+class coreHaloShape : public wignerShapeBase
+{
+public:
+    /// @brief Number of separable components.
+    static constexpr int kComponents = 2;
+
+    /**
+     * @brief Constructor.
+     * @param fraction Core fraction f in [0, 1].
+     * @param ratio    Halo to core size ratio λ (> 0).
+     */
+    explicit coreHaloShape(double fraction = 0.8, double ratio = 3.);
+
+    /// @brief Name used on the command line.
+    static const char *name() { return "corehalo"; }
+
+    /// @brief Weight of a component (0 core, 1 halo).
+    double weight(int c) const { return c == 0 ? mFraction : 1. - mFraction; }
+
+    /// @brief Size of a component for the core radius.
+    double componentRadius(int c, double radius) const { return c == 0 ? radius : mRatio * radius; }
+
+    /// @brief Shape parameters, stored in the result cache key.
+    std::vector<double> getParameters() const { return {mFraction, mRatio}; }
+
+    /// @brief Spatial density of a component.
+    double density(int c, double r, double radius) const;
+
+    /// @brief Probability of r < a for a component.
+    double cdf(int c, double a, double radius) const;
+
+private:
+    double mFraction = 0.8; ///< Core fraction.
+    double mRatio = 3.;     ///< Halo to core size ratio.
+    gaussianShape mGauss;   ///< Profile of each component.
+};
+
+#endif
+/// @}
@@ -7,6 +7,16 @@
 #ifndef CWIGNERSOURCE
 #define CWIGNERSOURCE
 
+#include "CWignerCache.h"
+#include "CWignerContributionMap.h"
+#include "CWignerCore.h"
+#include "CWignerCorrelation.h"
+#include "CWignerGaussianMixture.h"
+#include "CWignerLowRankTable.h"
+#include "CWignerObservables.h"
+#include "CWignerPotential.h"
+#include "CWignerSampler.h"
+#include "CWignerTable.h"
 #include "TF2.h"
 #include <iostream>
 #include <fstream>
@@ -102,6 +112,22 @@ public:
      */
     void setV0(double v0);
 
+    /**
+     * @brief Use another potential than the square well for ⟨V⟩ and ⟨H⟩.
+     *
+     * The potential is evaluated once on the radial nodes of the grid and kept until another
+     * potential is attached, its parameters change or the grid changes. ⟨V⟩ is then the dot
+     * product of these values with the radial marginal of W·J, itself kept until the radius or
+     * k* change or the breaks of the potential move. The square well needs no nodes: its ⟨V⟩ is
+     * V0 times getRadialCumulative(rWidth). The TF2 getters of V, W·V and W·H still describe the
+     * square well.
+     * @param potential Potential (not owned), nullptr to go back to the square well of rWidth and V0.
+     */
+    void setPotential(const wignerPotential *potential);
+
+    /// @brief Get the potential used for ⟨V⟩: the attached one or the square well.
+    const wignerPotential *getPotential() const;
+
     /// @brief Get the main Wigner TF2 function.
     TF2 *getWignerFunction();
 
@@ -144,15 +170,33 @@ public:
     /// @brief Get the current normalization constant.
     double getNorm();
 
-    /// @brief Get the integral of Wigner-weighted kinetic energy.
+    /// @brief Get the integral of Wigner-weighted kinetic energy, getP2Moment() / 2μ outside test mode and maps.
     double getwK();
 
-    /// @brief Get the integral of Wigner-weighted potential energy.
+    /**
+     * @brief Get the integral of Wigner-weighted potential energy.
+     *
+     * V0 times getRadialCumulative(rWidth) for the square well outside test mode and maps, Σ_i V(r_i) m(r_i)
+     * on the grid otherwise; in test mode, TF2 integrals split at the breaks of the potential.
+     */
     double getwV();
 
-    /// @brief Get the integral of Wigner-weighted Hamiltonian.
+    /// @brief Get the integral of Wigner-weighted Hamiltonian, getwK() + getwV() outside test mode, TF2 integrals only in test mode.
     double getwH();
 
+    /**
+     * @brief Cumulative radial marginal of the source, ∫ W·J over r' < r on the grid.
+     *
+     * Tabulated at the radial cell edges of the grid without breaks, once per radius, k* and
+     * grid (see wignerCore::sourceMoments()), and linear inside a cell: scans of rWidth and V0
+     * cost one lookup.
+     * @param r Radius.
+     */
+    double getRadialCumulative(double r);
+
+    /// @brief ∫ p² W·J on the grid, computed with getRadialCumulative(): scans of μ cost one division.
+    double getP2Moment();
+
     /// @brief Get the current value of the source radius.
     double getRadius();
 
@@ -183,6 +227,102 @@ public:
     /// @brief Get the deuteron coalescence probability.
     double getcoal();
 
+    /**
+     * @brief Coalescence probability for several tables in one pass over the grid.
+     *
+     * The source factor W·J is evaluated once per node and multiplied by each table, so the
+     * cost is close to that of a single getcoal(). The grid is split at the breaks of every
+     * table (see wignerUtils::getDeuteronBreaks); the integration is always the midpoint grid,
+     * also in test mode.
+     * @param tables Tables (not owned).
+     * @return One probability per table.
+     */
+    std::vector<double> getcoal(const std::vector<const wignerTable *> &tables);
+
+    /**
+     * @brief Compute coal for several tables in computePoint().
+     *
+     * computePoint() then fills wignerPoint::coalTables with getcoal(tables), and coal with the
+     * value of the first table; the result cache is not used.
+     * @param tables Tables (not owned, must outlive the source), nullptr or empty for the table of wignerUtils.
+     */
+    void setDeuteronTables(const std::vector<const wignerTable *> *tables);
+
+    /**
+     * @brief Compute coal in closed form from a Gaussian mixture of the deuteron table.
+     *
+     * getcoal() then returns wignerGaussianMixture::coal() for the current radius, k* and
+     * normalization, with no grid integration; the cache key follows the mixture.
+     * @param mixture Mixture (not owned), nullptr to integrate the table of wignerUtils again.
+     */
+    void setMixture(const wignerGaussianMixture *mixture);
+
+    /**
+     * @brief Allow getcoal() to use the low-rank factorization of the deuteron table.
+     *
+     * If the relative truncation error of wignerUtils::getLowRankTable() is at most the
+     * precision, getcoal() sums the factors against the r and p parts of W·J on the nodes of the
+     * grid, rank × (N + M) operations instead of N × M; otherwise the grid is integrated as
+     * before. Not in test mode nor with contribution maps; a mixture (setMixture()) has priority.
+     * @param precision Largest relative truncation error accepted, 0 (default) to always integrate the grid.
+     */
+    void setCoalPrecision(double precision);
+
+    /// @brief Get the precision set with setCoalPrecision().
+    double getCoalPrecision();
+
+    /**
+     * @brief Sampler of (r, p) for the current radius and k*, e.g. for event generators.
+     *
+     * Replaces TF2::GetRandom2 on getWignerFunctionForJacobian(): wignerSampler::sampleSource()
+     * draws exactly from the Gaussian source, in batches and from any number of threads.
+     * @param coalescence Also tabulate W_d·W·J on the grid of getcoal(), with the table of
+     *                    wignerUtils, for wignerSampler::sampleCoalescence().
+     * @return Sampler.
+     */
+    wignerSampler getSampler(bool coalescence = true);
+
+    /**
+     * @brief Integrate user-defined observables in computePoint() (see wignerObservables).
+     *
+     * computePoint() then fills wignerPoint::observables with getObservables(). When coal is
+     * integrated on the grid (no mixture, low-rank table, maps or test mode), it joins the same
+     * pass; the result cache is not used. The deuteron factor is the table of coal: that of
+     * wignerUtils, or the one table of setDeuteronTables(). Observables with the deuteron factor
+     * and several tables are an error, checked here and in setDeuteronTables().
+     * @param observables Registry (not owned, may be shared by several sources), nullptr for none.
+     */
+    void setObservables(const wignerObservables *observables);
+
+    /**
+     * @brief All registered observables in one pass over the grid.
+     *
+     * W, J and h³ W_d are evaluated once per node and only if an observable uses them; the grid
+     * is split at the breaks of the deuteron table if one does. Always the midpoint grid, also
+     * in test mode.
+     * @param coal  If not nullptr, set to the getcoal() of the grid, integrated in the same pass.
+     * @param table Deuteron table of the deuteron factor and of coal, nullptr for the table of wignerUtils.
+     * @return One value per observable, in the order of registration.
+     */
+    std::vector<double> getObservables(double *coal = nullptr, const wignerTable *table = nullptr);
+
+    /**
+     * @brief Compute the Koonin–Pratt correlation function in computePoint() (see wignerCorrelation).
+     *
+     * computePoint() then fills wignerPoint::cf with getCorrelation(), also on a cache hit.
+     * @param correlation Pair wavefunctions (not owned, may be shared by several sources), nullptr for none.
+     */
+    void setCorrelation(const wignerCorrelation *correlation);
+
+    /**
+     * @brief C(k*) at the k* of setRadiusK() for the current radius.
+     *
+     * Integrated on the radial marginal of getRadialCumulative(), which ⟨K⟩ and the square-well
+     * ⟨V⟩ of the same point use as well.
+     * @return C(k*), 0 without setCorrelation().
+     */
+    double getCorrelation();
+
     /// @brief Get the integral over the deuteron Wigner function.
     double getDeuteronInt();
 
@@ -192,12 +332,58 @@ public:
      */
     double checkWxW();
 
+    /**
+     * @brief Compute all observables for one k* value.
+     *
+     * Equivalent to setRadiusK(k) followed by getNorm(), checkWxW(), getwK(), getwV(),
+     * getwH() and getcoal(). If a cache is attached (see setCache()), it is consulted
+     * before any integration, including the normalization, and new results are stored.
+     *
+     * @param k Relative momentum (k*).
+     * @return Observables of the point.
+     */
+    wignerPoint computePoint(double k);
+
+    /**
+     * @brief Attach a persistent result cache (not owned), nullptr to disable it.
+     * @param cache Cache shared by any number of wignerSource objects and threads.
+     */
+    void setCache(wignerCache *cache);
+
+    /**
+     * @brief Fill contribution maps of coal, ⟨K⟩ and ⟨V⟩ in getcoal(), getwK() and getwV().
+     *
+     * The contribution of each grid node is added to the maps while the integrals run, so
+     * the maps cost no extra evaluation. Nothing is filled in test mode (TF2::Integral), and
+     * computePoint() resets the maps and does not use the result cache while they are attached.
+     * @param map Maps (not owned), nullptr to stop filling.
+     */
+    void setContributionMap(wignerContributionMap *map);
+
+    /**
+     * @brief Key identifying the current parameters in the result cache.
+     *
+     * Contains r0, the input k*, source radius, effective k*, mu, rWidth, V0, the global
+     * integration ranges and steps, the integration mode, the name and parameters of an attached
+     * potential and the deuteron table checksum (or that of the Gaussian mixture), followed by
+     * the rank when coal comes from the low-rank table.
+     * @return Cache key.
+     */
+    wignerCacheKey getCacheKey();
+
     /**
      * @brief Set parameters from an external text file.
      * @param txtfile Input file name (default: "default.txt").
      */
     void SetFromTxt(const std::string &txtfile = "default.txt");
 
+    /**
+     * @brief Read parameters from a file (one value per line, `config/default.txt` style).
+     * @param filename File name to read from.
+     * @return Vector of parameter values.
+     */
+    static std::vector<double> readParamsFromFile(const std::string &filename);
+
 private:
     double mR0 = 1.;        ///< Reference radius R0.
     double mRadius = 1.;    ///< Source radius.
@@ -209,6 +395,37 @@ private:
     double mV0 = -17.4E-3;  ///< Depth of the potential well.
     TString mName = "";     ///< Suffix for TF2 naming.
 
+    wignerCache *mCache = nullptr; ///<! Optional persistent result cache (not owned).
+
+    const std::vector<const wignerTable *> *mTables = nullptr; ///<! Tables of a multi-table sweep (not owned).
+    wignerContributionMap *mMap = nullptr;                     ///<! Contribution maps being filled (not owned).
+    const wignerGaussianMixture *mMixture = nullptr;           ///<! Closed-form deuteron table (not owned).
+    const wignerObservables *mObservables = nullptr;           ///<! User-defined observables (not owned).
+    const wignerCorrelation *mCorrelation = nullptr;           ///<! Pair wavefunctions of the correlation function (not owned).
+    double mCoalPrecision = 0;                                 ///< Largest truncation error of the low-rank coal.
+
+    const wignerLowRankTable *mLowRank = nullptr; ///<! Low-rank table of the projections below (not owned).
+    double mLowRankGrid[6] = {};                  ///<! Ranges and steps of the grid of the projections.
+    std::vector<double> mLowRankR;                ///<! Radial nodes, split at the breaks of the table.
+    std::vector<double> mLowRankP;                ///<! Momentum nodes, split at the breaks of the table.
+    std::vector<double> mLowRankU;                ///<! σ_k u_k(r_i) r_i² Δr_i, rank x mLowRankR.size().
+    std::vector<double> mLowRankV;                ///<! v_k(p_j) Δp_j, rank x mLowRankP.size().
+
+    squareWellPotential mWell;                   ///< Square well of rWidth and V0.
+    const wignerPotential *mPotential = nullptr; ///<! Attached potential (not owned), nullptr for mWell.
+    bool mPotentialDirty = true;                 ///<! Potential values need to be recomputed.
+    bool mMarginalDirty = true;                  ///<! Radial marginal needs to be recomputed.
+    double mGrid[6] = {};                        ///<! Ranges and steps of the grid of the cached values.
+    std::vector<double> mRNodes;                 ///<! Radial nodes of the grid, split at the potential breaks.
+    std::vector<double> mRWidths;                ///<! Widths of the radial cells.
+    std::vector<double> mVNodes;                 ///<! Potential on the radial nodes.
+    std::vector<double> mMarginal;               ///<! ∫ dp W·J times the cell width, on the radial nodes.
+    bool mMomentsDirty = true;                   ///<! Cumulative marginal and p² moment need to be recomputed.
+    double mMomentGrid[6] = {};                  ///<! Ranges and steps of the grid of the moments.
+    std::vector<double> mEdges;                  ///<! Radial cell edges of the grid without breaks.
+    std::vector<double> mCumulative;             ///<! ∫ W·J over r below each edge.
+    double mP2 = 0;                              ///<! ∫ p² W·J.
+
     double mRMin = 0;   ///< Minimum radius.
     double mRMax = 50;  ///< Maximum radius.
     double mPMin = 0;   ///< Minimum momentum.
@@ -269,12 +486,24 @@ private:
     /// @brief Update potential depth in all TF2s.
     void reSetV0();
 
-    /**
-     * @brief Read parameters from a file.
-     * @param filename File name to read from.
-     * @return Vector of parameter values.
-     */
-    std::vector<double> readParamsFromFile(const std::string &filename);
+    /// @brief Recompute the radial nodes and the potential on them if the potential or the grid changed.
+    void updatePotential();
+
+    /// @brief Recompute the radial marginal of W·J if needed.
+    void updateMarginal();
+
+    /// @brief Recompute the cumulative radial marginal and the p² moment if needed.
+    void updateMoments();
+
+    /// @brief Abort if an observable uses the deuteron factor while several deuteron tables are set.
+    void checkObservableTables() const;
+
+    /// @brief Low-rank table getcoal() may use with the current settings, nullptr to integrate the grid.
+    const wignerLowRankTable *lowRankTable();
+
+    /// @brief coal from the factors of a low-rank table, projected on the grid nodes if needed.
+    double getcoalLowRank(const wignerLowRankTable *table);
+
 };
 
 #endif
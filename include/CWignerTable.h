@@ -0,0 +1,127 @@
+/**
+ * @defgroup WignerTable ROOT-free Deuteron Table
+ * @brief Deuteron Wigner table in a plain binary file, interpolated like TH2::Interpolate.
+ * @{
+ */
+
+#ifndef CWIGNERTABLE
+#define CWIGNERTABLE
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @class wignerTable
+ * @brief Uniformly binned 2D table W_d(r, p) with the bilinear interpolation of TH2::Interpolate.
+ *
+ * The binary file (native byte order) holds
+ *
+ *     uint32 magic ("WIGT"), uint32 version,
+ *     int32 nx, double xmin, double xmax, int32 ny, double ymin, double ymax,
+ *     (nx + 2) (ny + 2) doubles: the bin contents with under- and overflow, in the TH2 layout
+ *     (bin (i, j) at i + (nx + 2) j).
+ *
+ * It is written by `wignertable --binary` (or `--convert` from an existing ROOT table), and
+ * checksum() equals wignerUtils::getDeuteronChecksum() of the same table, so the ROOT and the
+ * ROOT-free layers share cache keys.
+ */
+class wignerTable
+{
+public:
+    static const uint32_t kMagic = 0x54474957; ///< "WIGT" in the file.
+    static const uint32_t kVersion = 1;        ///< File format version.
+
+    /// @brief Empty table (interpolates to 0).
+    wignerTable() = default;
+
+    /**
+     * @brief Table from its binning and bin contents.
+     * @param nx       Number of r bins.
+     * @param xmin     Lower r edge.
+     * @param xmax     Upper r edge.
+     * @param ny       Number of p bins.
+     * @param ymin     Lower p edge.
+     * @param ymax     Upper p edge.
+     * @param contents (nx + 2) (ny + 2) bin contents in the TH2 layout.
+     */
+    wignerTable(int nx, double xmin, double xmax, int ny, double ymin, double ymax, const std::vector<double> &contents);
+
+    /**
+     * @brief Read a table written by write().
+     * @param filename Binary file.
+     * @return Table; throws std::runtime_error if the file cannot be read.
+     */
+    static wignerTable read(const std::string &filename);
+
+    /**
+     * @brief Write the table.
+     * @param filename Binary file.
+     * @return True on success.
+     */
+    bool write(const std::string &filename) const;
+
+    /**
+     * @brief Bilinear interpolation between bin centers, as TH2::Interpolate.
+     *
+     * Constant along an axis in its outer half-bins, 0 outside the table.
+     * @param x Radius.
+     * @param y Momentum.
+     * @return Interpolated value.
+     */
+    double interpolate(double x, double y) const;
+
+    /// @brief Break points of the interpolation, as wignerUtils::getDeuteronBreaks.
+    void getBreaks(std::vector<double> &rBreaks, std::vector<double> &pBreaks) const;
+
+    /// @brief 64-bit hash of the binning and bin contents, as wignerUtils::getDeuteronChecksum.
+    uint64_t checksum() const;
+
+    /// @brief True if the table has no bins.
+    bool empty() const { return mNx == 0 || mNy == 0; }
+
+    /// @brief Bin content with the TH2 indices (0 and n + 1 are the flow bins).
+    double getBinContent(int i, int j) const { return mContents[i + (mNx + 2) * j]; }
+
+    /// @brief Number of r bins.
+    int getNx() const { return mNx; }
+
+    /// @brief Number of p bins.
+    int getNy() const { return mNy; }
+
+    /// @brief Lower r edge.
+    double getXMin() const { return mXMin; }
+
+    /// @brief Upper r edge.
+    double getXMax() const { return mXMax; }
+
+    /// @brief Lower p edge.
+    double getYMin() const { return mYMin; }
+
+    /// @brief Upper p edge.
+    double getYMax() const { return mYMax; }
+
+    /// @brief Center of r bin i (1 to nx).
+    double getXCenter(int i) const { return center(i, mNx, mXMin, mXMax); }
+
+    /// @brief Center of p bin j (1 to ny).
+    double getYCenter(int j) const { return center(j, mNy, mYMin, mYMax); }
+
+private:
+    int mNx = 0;                    ///< Number of r bins.
+    double mXMin = 0;               ///< Lower r edge.
+    double mXMax = 0;               ///< Upper r edge.
+    int mNy = 0;                    ///< Number of p bins.
+    double mYMin = 0;               ///< Lower p edge.
+    double mYMax = 0;               ///< Upper p edge.
+    std::vector<double> mContents;  ///< Bin contents with flow bins.
+
+    /// @brief Center of bin i of an axis (TAxis::GetBinCenter).
+    static double center(int i, int n, double lo, double hi);
+
+    /// @brief Bin containing x (TAxis::FindFixBin).
+    static int find(double x, int n, double lo, double hi);
+};
+
+#endif
+/// @}
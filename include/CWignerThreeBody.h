@@ -0,0 +1,230 @@
+/**
+ * @defgroup WignerThreeBody Three-Body Coalescence
+ * @brief Coalescence of A = 3 nuclei (triton, ³He) from a Gaussian three-nucleon source.
+ * @{
+ */
+
+#ifndef CWIGNERTHREEBODY
+#define CWIGNERTHREEBODY
+
+#include "CWignerSource.h"
+#include <string>
+#include <vector>
+
+class TH2D;
+
+/**
+ * @class wignerNucleusA3
+ * @brief Interface of the A = 3 nucleus Wigner function used by wignerThreeBody.
+ *
+ * The phase-space point is given in Jacobi coordinates
+ *
+ *     ρ = (r1 - r2) / √2,   λ = (r1 + r2 - 2 r3) / √6,
+ *
+ * with conjugate momenta q_ρ, q_λ, as x = {ρ(3), λ(3), q_ρ(3), q_λ(3)} in fm and GeV/c.
+ * The function must be normalized to ∫ d¹²x W = 1.
+ */
+class wignerNucleusA3
+{
+public:
+    virtual ~wignerNucleusA3() = default;
+
+    /**
+     * @brief Evaluate the nucleus Wigner function.
+     * @param x Phase-space point, 12 values.
+     * @return Wigner function value.
+     */
+    virtual double wigner(const double *x) const = 0;
+
+    /**
+     * @brief Approximate size (rms radius, fm) of the nucleus.
+     *
+     * Sets the width of the Monte Carlo proposal density; any reasonable value gives
+     * an unbiased result, a good one gives a small variance.
+     * @return Size in fm.
+     */
+    virtual double getSize() const { return 1.76; }
+};
+
+/**
+ * @class wignerGaussianA3
+ * @brief Harmonic-oscillator A = 3 wavefunction, whose Wigner function is Gaussian:
+ *
+ *     W = (1 / (π ħ))⁶ exp( -(ρ² + λ²) / b² - b² (q_ρ² + q_λ²) / ħ² )
+ *
+ * b is the matter rms radius (1.76 fm for the triton, about 1.97 fm for ³He).
+ */
+class wignerGaussianA3 : public wignerNucleusA3
+{
+public:
+    /**
+     * @brief Constructor.
+     * @param b Size parameter (rms radius) in fm.
+     */
+    wignerGaussianA3(double b = 1.76);
+
+    double wigner(const double *x) const override;
+
+    double getSize() const override;
+
+private:
+    double mB; ///< Size parameter (rms radius).
+};
+
+/**
+ * @class wignerHyperTableA3
+ * @brief Tabulated A = 3 Wigner function depending on the hyperradius sqrt(ρ² + λ²) and the
+ * hypermomentum sqrt(q_ρ² + q_λ²), read from a TH2D (the A = 3 analogue of the deuteron table).
+ */
+class wignerHyperTableA3 : public wignerNucleusA3
+{
+public:
+    /**
+     * @brief Constructor, loads the table into memory.
+     * @param filename ROOT file name.
+     * @param histname Name of the TH2D (x: hyperradius in fm, y: hypermomentum in GeV/c).
+     * @param size     Approximate rms radius of the nucleus in fm (see getSize()).
+     */
+    wignerHyperTableA3(const std::string &filename, const std::string &histname = "h", double size = 1.76);
+    ~wignerHyperTableA3() override;
+
+    double wigner(const double *x) const override;
+
+    double getSize() const override;
+
+private:
+    TH2D *mTable = nullptr; ///< Table, detached from its file.
+    double mSize;           ///< Approximate rms radius.
+};
+
+/**
+ * @class wignerThreeBody
+ * @brief Coalescence probability of three nucleons into an A = 3 nucleus.
+ *
+ * The source is the three-nucleon generalization of wignerSource: each Jacobi pair (ρ, q_ρ) and
+ * (λ, q_λ) has the Gaussian Wigner function exp(-x² / (4 R²) - 4 R² (q - k)² / ħ²), with the
+ * mean momentum k* along z for both pairs. The 12D overlap
+ *
+ *     P = (2πħ)⁶ ∫ d¹²x W_source W_nucleus
+ *
+ * is computed by Monte Carlo. The samples are drawn from the source Gaussian multiplied by a
+ * Gaussian envelope of the nucleus size (wignerNucleusA3::getSize()), which is again Gaussian,
+ * and weighted by W_source / proposal; for a Gaussian nucleus of that size the weights are
+ * constant and the variance vanishes. Samples are drawn in rounds of doubling size, spread over
+ * threads with independent random streams, until the relative standard error is below the
+ * tolerance. The same normal deviates also give exact source samples, from which the pairwise
+ * square-well ⟨V⟩ and the kinetic energy are estimated.
+ */
+class wignerThreeBody
+{
+public:
+    /**
+     * @brief Constructor.
+     * @param nucleus Nucleus Wigner function (not owned); a triton-sized wignerGaussianA3 if nullptr.
+     */
+    wignerThreeBody(const wignerNucleusA3 *nucleus = nullptr);
+
+    /// @brief Set the nucleus Wigner function (not owned).
+    void setNucleus(const wignerNucleusA3 *nucleus);
+
+    /// @brief Set the reference radius R0.
+    void setR0(double r0);
+
+    /// @brief Set the source radius directly.
+    void setRadius(double radius);
+
+    /// @brief Set relative momentum and update radius/k* as in wignerSource::setRadiusK.
+    void setRadiusK(double k);
+
+    /// @brief Set the reduced mass of a nucleon pair (m_N / 2).
+    void setMu(double mu);
+
+    /// @brief Set the potential spatial width (pairwise square well).
+    void setRWidth(double rWidth);
+
+    /// @brief Set the depth of the potential well.
+    void setV0(double v0);
+
+    /// @brief Set the number of threads.
+    void setThreads(int nThreads);
+
+    /// @brief Set the target relative standard error of the coalescence probability.
+    void setTolerance(double relTol);
+
+    /// @brief Set the maximum number of samples per point.
+    void setMaxSamples(long maxSamples);
+
+    /// @brief Set the seed of the random streams.
+    void setSeed(unsigned long seed);
+
+    /// @brief Set mu, rWidth, V0 and r0 from a `config/default.txt` style file.
+    void SetFromTxt(const std::string &txtfile);
+
+    /// @brief Get the source radius.
+    double getRadius();
+
+    /// @brief Get the effective k*.
+    double getKStar();
+
+    /**
+     * @brief Run the Monte Carlo for the current parameters.
+     * @return Coalescence probability.
+     */
+    double getcoal();
+
+    /// @brief Statistical error of the last getcoal() result.
+    double getcoalError();
+
+    /// @brief Number of samples used by the last getcoal() call.
+    long getSamples();
+
+    /// @brief Kinetic energy (q_ρ² + q_λ²) / (2 m_N) from the last getcoal() call.
+    double getwK();
+
+    /// @brief Pairwise square-well potential energy from the last getcoal() call.
+    double getwV();
+
+    /// @brief Monte Carlo estimate of (2πħ)⁶ ∫ W_source², must be 1.
+    double checkWxW();
+
+    /**
+     * @brief Closed-form coalescence probability for a wignerGaussianA3 nucleus, for cross-checks.
+     * @param b Size parameter of the Gaussian nucleus.
+     * @return Coalescence probability.
+     */
+    double getAnalyticGaussianCoal(double b);
+
+    /**
+     * @brief Compute all observables for one k* value, in the layout of the deuteron scan.
+     *
+     * norm is 1 (the source is sampled exactly), WW is checkWxW(), wH = wK + wV.
+     * @param k Relative momentum (k*).
+     * @return Observables of the point.
+     */
+    wignerPoint computePoint(double k);
+
+private:
+    const wignerNucleusA3 *mNucleus = nullptr; ///< Nucleus Wigner function (not owned).
+    wignerGaussianA3 mDefaultNucleus;          ///< Used when no nucleus is given.
+    double mR0 = 1.;                           ///< Reference radius R0.
+    double mRadius = 1.;                       ///< Source radius.
+    double mKin = 0.050;                       ///< Input k*.
+    double mKStar = 0.050;                     ///< Effective k*.
+    double mMu = 0.938 / 2;                    ///< Reduced mass of a pair.
+    double mRWidth = 3.2;                      ///< Width of the potential well.
+    double mV0 = -17.4E-3;                     ///< Depth of the potential well.
+    int mThreads = 1;                          ///< Number of threads.
+    double mTolerance = 1E-3;                  ///< Target relative error.
+    long mMaxSamples = 100000000;              ///< Maximum number of samples.
+    unsigned long mSeed = 12345;               ///< Seed of the random streams.
+
+    double mCoal = 0;    ///< Last coalescence probability.
+    double mCoalErr = 0; ///< Its statistical error.
+    double mK = 0;       ///< Last kinetic energy.
+    double mV = 0;       ///< Last potential energy.
+    double mWW = 0;      ///< Last WxW estimate.
+    long mSamples = 0;   ///< Samples of the last run.
+};
+
+#endif
+/// @}
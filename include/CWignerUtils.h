@@ -7,9 +7,12 @@
 #ifndef CWIGNERUTILS
 #define CWIGNERUTILS
 
+#include "CWignerLowRankTable.h"
+#include "CWignerTable.h"
 #include "TF2.h"
 #include "TFile.h"
 #include "TH2.h"
+#include <vector>
 
 /**
  * @class wignerUtils
@@ -18,6 +21,8 @@
  * This class provides TF2-compatible static functions for computing Wigner distributions,
  * energy components, and coalescence observables used in two-particle correlation studies.
  * It also includes tools for numerical integration and access to deuteron wavefunction data.
+ * The formulas and the integration grid are those of the ROOT-free wignerCore, which the
+ * callbacks forward to; this class adds the TF2 interface and the ROOT deuteron table.
  */
 class wignerUtils
 {
@@ -153,6 +158,58 @@ public:
      */
     static double integral(TF2 *function, double minX = mMinX, double maxX = mMaxX, double minP = mMinP, double maxP = mMaxP);
 
+    /**
+     * @brief Integrate a TF2 whose integrand is discontinuous (or has a kink) at known r or p values.
+     *
+     * The range is split into panels at the break points and each panel gets its own midpoint
+     * grid, with the step shrunk to the largest value <= dx (dp) that fits the panel exactly, so
+     * no cell straddles a break. A step of the integrand then converges at second order in the
+     * step instead of first order. In test mode TF2::Integral is called on each panel.
+     *
+     * @param function Pointer to TF2 object.
+     * @param xBreaks  Break points in r (those outside the range are ignored).
+     * @param pBreaks  Break points in p (those outside the range are ignored).
+     * @param minX Lower x (radius) limit.
+     * @param maxX Upper x (radius) limit.
+     * @param minP Lower p (momentum) limit.
+     * @param maxP Upper p (momentum) limit.
+     * @return Integral result.
+     */
+    static double integral(TF2 *function, const std::vector<double> &xBreaks, const std::vector<double> &pBreaks,
+                           double minX = mMinX, double maxX = mMaxX, double minP = mMinP, double maxP = mMaxP);
+
+    /**
+     * @brief Midpoint nodes of the grid of integral() along one axis.
+     *
+     * The range is split into panels at the break points exactly as in integral(), so a sum over
+     * these nodes reproduces the grid integration (e.g. a 1D marginal dotted with a function of r).
+     * @param lo      Lower limit.
+     * @param hi      Upper limit.
+     * @param breaks  Break points (those outside the range are ignored).
+     * @param step    Largest step (getDx() or getDp()).
+     * @param nodes   Filled with the cell midpoints.
+     * @param widths  Filled with the cell widths.
+     */
+    static void gridNodes(double lo, double hi, const std::vector<double> &breaks, double step,
+                          std::vector<double> &nodes, std::vector<double> &widths);
+
+    /**
+     * @brief Nodes and weights of the n-point Gauss-Legendre rule on [-1, 1].
+     * @param n Number of nodes.
+     * @param x Filled with the nodes.
+     * @param w Filled with the weights.
+     */
+    static void gaussLegendre(int n, std::vector<double> &x, std::vector<double> &w);
+
+    /**
+     * @brief Exponentially scaled modified Bessel function exp(-x) I0(x), for x >= 0.
+     *
+     * Unlike TMath::BesselI0 it does not overflow for large arguments.
+     * @param x Argument.
+     * @return exp(-x) I0(x).
+     */
+    static double besselI0Scaled(double x);
+
     /// @brief Get minimum radius used for integration.
     static double getMinX();
 
@@ -168,6 +225,71 @@ public:
     /// @brief Get the h-bar * c conversion constant in GeV·fm.
     static double getHCut();
 
+    /// @brief Get the dx step of the manual integration.
+    static double getDx();
+
+    /// @brief Get the dp step of the manual integration.
+    static double getDp();
+
+    /**
+     * @brief Checksum of the deuteron Wigner table (binning and bin contents).
+     *
+     * Computed once on first use; identifies the table in cache keys. Equal to
+     * wignerTable::checksum() of the same table in the binary format.
+     * @return 64-bit hash of the histogram.
+     */
+    static unsigned long long getDeuteronChecksum();
+
+    /**
+     * @brief Replace the deuteron Wigner table, e.g. by one made with wignerDeuteronTable.
+     *
+     * Must be called before any integration starts; sources already constructed use the new
+     * table from their next integral.
+     * @param filename ROOT file holding the table.
+     * @param histname Name of the 2D histogram (r in fm, p in GeV/c).
+     * @return True on success; on failure the current table is kept.
+     */
+    static bool setDeuteronTable(const TString &filename, const TString &histname = "h");
+
+    /// @brief Copy of the current deuteron table (see toTable()).
+    static wignerTable getDeuteronTable();
+
+    /**
+     * @brief Low-rank factorization of the deuteron table (see wignerLowRankTable).
+     *
+     * Built on first use from the current table with the tolerance of setLowRankTolerance(), and
+     * again after setDeuteronTable() or setLowRankTolerance(); thread safe.
+     * @return Factorization (owned by wignerUtils, valid for the rest of the program).
+     */
+    static const wignerLowRankTable *getLowRankTable();
+
+    /**
+     * @brief Set the relative truncation error of getLowRankTable().
+     *
+     * Like setDeuteronTable(), must be called before any integration starts.
+     * @param tolerance Tolerance (default 1e-4).
+     */
+    static void setLowRankTolerance(double tolerance);
+
+    /**
+     * @brief Break points of the interpolated deuteron table, for integral() with breaks.
+     *
+     * TH2::Interpolate is bilinear between the bin centers and changes form at the outermost
+     * centers; the table ends at the upper axis edges.
+     * @param rBreaks Filled with the r break points.
+     * @param pBreaks Filled with the p break points.
+     */
+    static void getDeuteronBreaks(std::vector<double> &rBreaks, std::vector<double> &pBreaks);
+
+    /**
+     * @brief Copy a 2D histogram into a ROOT-free table (e.g. for `wignertable --convert`).
+     *
+     * The table interpolates as the histogram and has the same checksum.
+     * @param hist Histogram (r in fm, p in GeV/c).
+     * @return Table.
+     */
+    static wignerTable toTable(const TH2 *hist);
+
     /// @brief Set minimum radius for integration.
     static void setMinX(double minX);
 
@@ -189,6 +311,13 @@ public:
      */
     static void setIntegrationRanges(double minX, double maxX, double minP, double maxP);
 
+    /**
+     * @brief Set the steps of the manual grid integration.
+     * @param dx Step in r (fm).
+     * @param dp Step in p (GeV/c).
+     */
+    static void setSteps(double dx, double dp);
+
     /// @brief If true, uses TF2::Integral instead of manual integration, good for testing.
     static bool testMode;
 
@@ -206,6 +335,9 @@ private:
     // ROOT objects for deuteron Wigner function
     static TH2D *mH;             ///< 2D histogram with deuteron Wigner data.
     static TFile *mFileDeuteron; ///< ROOT file holding the histogram.
+    static unsigned long long mDeuteronChecksum; ///< Cached table checksum, 0 if not computed yet.
+    static wignerLowRankTable *mLowRank;         ///< Low-rank factorization of the table, nullptr if not built yet.
+    static double mLowRankTolerance;             ///< Relative truncation error of mLowRank.
 };
 
 #endif
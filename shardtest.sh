@@ -0,0 +1,54 @@
+#!/bin/bash
+
+# ------------------------------------------------------------------------------
+# shardtest.sh - Checks the shard/merge workflow locally with several processes
+#
+# Usage:
+#   ./shardtest.sh [n_shards] [bin_dir] [config_file]
+#
+# Example:
+#   ./shardtest.sh 4 bin config/default.txt
+#
+# Explanation:
+# - Runs a short k* scan once without shards (the reference).
+# - Writes a manifest splitting the same scan into n shards (default 4) and runs
+#   every shard as a separate wignersim process, all at the same time.
+# - Merges the shards with `wignermerge` and compares the merged points with the
+#   reference (`--compare`); the exit code is non-zero on any difference.
+# - Works in a temporary directory, removed at the end; run it from the
+#   repository root, where the configuration and the deuteron table are found.
+# ------------------------------------------------------------------------------
+
+set -euo pipefail
+export LC_NUMERIC=C
+
+NSHARDS=${1:-4}
+BINDIR=${2:-bin}
+CONFIG_FILE=${3:-config/default.txt}
+START=0.01
+END=0.25
+STEP=0.02
+
+WORKDIR=$(mktemp -d)
+trap 'rm -rf "$WORKDIR"' EXIT
+
+echo "Reference scan [$START, $END) step $STEP"
+"$BINDIR/wignersim" --start "$START" --end "$END" --step "$STEP" --config "$CONFIG_FILE" \
+    --output "$WORKDIR/single.root" --quiet
+
+MANIFEST="$WORKDIR/shards.manifest"
+"$BINDIR/wignersim" --start "$START" --end "$END" --step "$STEP" --config "$CONFIG_FILE" \
+    --shards "$NSHARDS" --prefix "$WORKDIR/shards" --manifest "$MANIFEST"
+
+# one process per shard, checking the exit code of each
+PIDS=()
+for ((i=0; i<NSHARDS; i++)); do
+    "$BINDIR/wignersim" --manifest "$MANIFEST" --shard "$i" --threads 1 --quiet &
+    PIDS+=($!)
+done
+for pid in "${PIDS[@]}"; do
+    wait "$pid"
+done
+
+"$BINDIR/wignermerge" --manifest "$MANIFEST" --output "$WORKDIR/merged.root" --compare "$WORKDIR/single.root"
+echo "Sharded and unsharded scans agree"
@@ -10,11 +10,13 @@
 #   ./simulation.sh 0.001 2.0 8 0.005 simres res input.txt
 #
 # Explanation:
-# - Runs n parallel jobs covering the k* range from 0.001 to 2.0.
-# - Each job incrementally steps by 0.005 in the range.
+# - Writes a shard manifest splitting the k* range from 0.001 to 2.0 (step 0.005)
+#   into n shards, and runs one job per shard.
+# - The shards are validated, sorted and merged with `wignermerge`.
 # - Output ROOT files are saved into the directory `simres/`.
 # - Files are named using the prefix `res`.
 # - Simulation parameters are read from `input.txt`.
+# - Jobs run the compiled `wignersim` and `makeplots` tools (no ROOT interpreter).
 # ------------------------------------------------------------------------------
 
 
@@ -41,35 +43,26 @@ CONFIG_FILE=${7:-config/default.txt}  # Default value
 
 echo "START=$START END=$END NJOBS=$NJOBS INCREMENT=$INCREMENT OUTDIR=$OUTDIR PREFIX=$PREFIX CONFIG_FILE=$CONFIG_FILE"
 
-# Compute range step using awk
-RANGE_STEP=$(awk "BEGIN { printf \"%.6f\", ($END - $START)/$NJOBS }")
-echo "RANGE_STEP=$RANGE_STEP"
-
 mkdir -p "$OUTDIR"
 
-# Loop over jobs
-for ((i=0; i<NJOBS; i++)); do
-    JOB_START=$(awk "BEGIN { printf \"%.6f\", $START + $i * $RANGE_STEP }")
-    JOB_END=$(awk "BEGIN { printf \"%.6f\", $JOB_START + $RANGE_STEP }")
-    OUTFILE="$OUTDIR/${PREFIX}_part_$i.root"
-
-    echo "Launching job $i: [$JOB_START, $JOB_END] -> $OUTFILE"
+# Split the scan into one shard per job and record it in a manifest
+MANIFEST="$OUTDIR/${PREFIX}.manifest"
+wignersim --start "$START" --end "$END" --step "$INCREMENT" --config "$CONFIG_FILE" \
+    --shards "$NJOBS" --prefix "$OUTDIR/$PREFIX" --manifest "$MANIFEST"
 
-    if [[ -z "$JOB_START" || -z "$JOB_END" ]]; then
-        echo "ERROR: Empty range in job $i"
-        exit 1
-    fi
-
-    wigneroot -l -b -q "macros/wignersim.cpp($JOB_START, $JOB_END, $INCREMENT, \"$OUTFILE\", \"$CONFIG_FILE\")" &
+# Loop over jobs (each could run on a different node sharing $OUTDIR)
+for ((i=0; i<NJOBS; i++)); do
+    echo "Launching shard $i"
+    wignersim --manifest "$MANIFEST" --shard "$i" --threads 1 &
 done
 
 wait
 
 MERGED="$OUTDIR/${PREFIX}_merged.root"
 echo "Merging to $MERGED"
-hadd -f "$MERGED" "$OUTDIR/${PREFIX}_part_"*.root
+wignermerge --manifest "$MANIFEST" --output "$MERGED"
 
 echo "All done. Merged output: $MERGED"
 echo "Making the plots"
 
-wigneroot -l -q -b "macros/makeplots.cpp(\"$OUTDIR\",\"${PREFIX}_merged.root\")"
+makeplots --folder "$OUTDIR" --input "${PREFIX}_merged.root"
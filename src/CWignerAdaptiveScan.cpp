@@ -0,0 +1,190 @@
+#include "CWignerAdaptiveScan.h"
+#include "TFile.h"
+#include "TSpline.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <utility>
+
+//_________________________________________________________________________
+wignerAdaptiveScan::wignerAdaptiveScan(wignerScan &scan) : mScan(&scan)
+{
+}
+//_________________________________________________________________________
+void wignerAdaptiveScan::setTolerance(double tolerance)
+{
+    if (tolerance <= 0)
+    {
+        std::cerr << "Error: adaptive tolerance must be positive\n";
+        std::abort();
+    }
+    mTolerance = tolerance;
+}
+//_________________________________________________________________________
+void wignerAdaptiveScan::setMinStep(double step)
+{
+    if (step <= 0)
+    {
+        std::cerr << "Error: minimum step must be positive\n";
+        std::abort();
+    }
+    mMinStep = step;
+}
+//_________________________________________________________________________
+void wignerAdaptiveScan::setMaxPoints(size_t n)
+{
+    mMaxPoints = n;
+}
+//_________________________________________________________________________
+int wignerAdaptiveScan::getRounds() const
+{
+    return mRounds;
+}
+//_________________________________________________________________________
+double wignerAdaptiveScan::observable(const wignerPoint &pt, int i)
+{
+    switch (i)
+    {
+    case 0:
+        return pt.coal;
+    case 1:
+        return pt.wK;
+    case 2:
+        return pt.wV;
+    default:
+        return pt.wH;
+    }
+}
+//_________________________________________________________________________
+double wignerAdaptiveScan::divided(const std::vector<wignerPoint> &points, size_t i, int obs)
+{
+    const wignerPoint &a = points[i - 1], &b = points[i], &c = points[i + 1];
+    double left = (observable(b, obs) - observable(a, obs)) / (b.k - a.k);
+    double right = (observable(c, obs) - observable(b, obs)) / (c.k - b.k);
+    return (right - left) / (c.k - a.k);
+}
+//_________________________________________________________________________
+double wignerAdaptiveScan::intervalError(const std::vector<wignerPoint> &points, size_t i, const double *scale) const
+{
+    double h = points[i + 1].k - points[i].k;
+    double worst = 0;
+    for (int obs = 0; obs < kObservables; ++obs)
+    {
+        // |f''| h² / 8 with f'' = 2 f[., ., .], from the triples on either side of the interval
+        double curvature = 0;
+        if (i > 0)
+        {
+            curvature = std::max(curvature, std::fabs(divided(points, i, obs)));
+        }
+        if (i + 2 < points.size())
+        {
+            curvature = std::max(curvature, std::fabs(divided(points, i + 1, obs)));
+        }
+        worst = std::max(worst, curvature * h * h / 4 / (mTolerance * scale[obs]));
+    }
+    return worst;
+}
+//_________________________________________________________________________
+std::vector<wignerPoint> wignerAdaptiveScan::run(double start, double end, double step)
+{
+    mRounds = 0;
+    std::vector<double> kValues = wignerScan::kGrid(start, end, step);
+    if (kValues.empty())
+    {
+        return {};
+    }
+    if (end > kValues.back())
+    {
+        kValues.push_back(end);
+    }
+    std::vector<wignerPoint> points = mScan->run(kValues);
+
+    while (points.size() >= 3 && points.size() < mMaxPoints)
+    {
+        double scale[kObservables];
+        for (int obs = 0; obs < kObservables; ++obs)
+        {
+            auto range = std::minmax_element(points.begin(), points.end(), [obs](const wignerPoint &a, const wignerPoint &b)
+                                             { return observable(a, obs) < observable(b, obs); });
+            double width = observable(*range.second, obs) - observable(*range.first, obs);
+            // a constant observable (e.g. V0 = 0) never asks for points
+            scale[obs] = width > 0 ? width : HUGE_VAL;
+        }
+
+        std::vector<std::pair<double, double>> candidates; // (error, midpoint)
+        for (size_t i = 0; i + 1 < points.size(); ++i)
+        {
+            if (points[i + 1].k - points[i].k < 2 * mMinStep)
+            {
+                continue;
+            }
+            double error = intervalError(points, i, scale);
+            if (error > 1)
+            {
+                candidates.emplace_back(error, 0.5 * (points[i].k + points[i + 1].k));
+            }
+        }
+        if (candidates.empty())
+        {
+            break;
+        }
+        // over budget: the worst intervals first
+        size_t room = mMaxPoints - points.size();
+        if (candidates.size() > room)
+        {
+            std::partial_sort(candidates.begin(), candidates.begin() + room, candidates.end(),
+                              [](const std::pair<double, double> &a, const std::pair<double, double> &b)
+                              { return a.first > b.first; });
+            candidates.resize(room);
+        }
+
+        std::vector<double> inserted;
+        for (const auto &c : candidates)
+        {
+            inserted.push_back(c.second);
+        }
+        std::vector<wignerPoint> added = mScan->run(inserted);
+        points.insert(points.end(), added.begin(), added.end());
+        std::sort(points.begin(), points.end(), [](const wignerPoint &a, const wignerPoint &b)
+                  { return a.k < b.k; });
+        ++mRounds;
+        std::cout << "Refinement " << mRounds << ": " << added.size() << " new points, " << points.size() << " in total\n";
+    }
+    return points;
+}
+//_________________________________________________________________________
+bool wignerAdaptiveScan::writeInterpolants(const std::vector<wignerPoint> &points, const TString &outfile)
+{
+    if (points.size() < 2)
+    {
+        std::cerr << "Error: at least two points are needed for the interpolants\n";
+        return false;
+    }
+    TFile file(outfile, "UPDATE");
+    if (file.IsZombie())
+    {
+        std::cerr << "Error: could not open " << outfile << "\n";
+        return false;
+    }
+
+    const char *names[kObservables] = {"coal", "wK", "wV", "wH"};
+    std::vector<double> k(points.size()), y(points.size());
+    for (size_t i = 0; i < points.size(); ++i)
+    {
+        k[i] = points[i].k;
+    }
+    for (int obs = 0; obs < kObservables; ++obs)
+    {
+        for (size_t i = 0; i < points.size(); ++i)
+        {
+            y[i] = observable(points[i], obs);
+        }
+        TString name = TString::Format("%s_spline", names[obs]);
+        TSpline3 spline(name, k.data(), y.data(), points.size());
+        spline.SetName(name);
+        spline.Write(name);
+    }
+    file.Close();
+    return true;
+}
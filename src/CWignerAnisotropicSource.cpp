@@ -0,0 +1,400 @@
+#include "CWignerAnisotropicSource.h"
+#include "CWignerCore.h"
+#include "CWignerUtils.h"
+#include "TMath.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+namespace
+{
+    /// Gauss-Legendre rule used on every panel of the polar integral.
+    struct polarRule
+    {
+        std::vector<double> x, w;
+        polarRule() { wignerUtils::gaussLegendre(6, x, w); }
+    };
+
+    /**
+     * Integrate f over [lo, hi] with 16 uniform Gauss-Legendre panels. If the interval touches
+     * u = -1 or u = 1, the corresponding end panel is refined geometrically, since the Bessel
+     * factor varies on a scale 1 / (x² |c_side - c_long|) there.
+     */
+    template <typename F>
+    double integratePanels(F &&f, double lo, double hi)
+    {
+        static const polarRule rule;
+        const int nUniform = 16;
+        const int nGraded = 12;
+        const double ratio = 0.25;
+
+        auto panel = [&](double a, double b)
+        {
+            double half = 0.5 * (b - a), mid = 0.5 * (a + b), sum = 0;
+            for (size_t i = 0; i < rule.x.size(); ++i)
+            {
+                sum += rule.w[i] * f(mid + half * rule.x[i]);
+            }
+            return sum * half;
+        };
+
+        double h = (hi - lo) / nUniform;
+        double res = 0;
+        for (int i = 0; i < nUniform; ++i)
+        {
+            double a = lo + i * h, b = a + h;
+            bool gradeLow = (i == 0 && lo <= -1.);
+            bool gradeHigh = (i == nUniform - 1 && hi >= 1.);
+            if (!gradeLow && !gradeHigh)
+            {
+                res += panel(a, b);
+                continue;
+            }
+            // geometric sub-panels accumulating towards the end point
+            double len = h;
+            for (int j = 0; j < nGraded; ++j)
+            {
+                double inner = len * ratio;
+                res += gradeHigh ? panel(b - len, b - inner) : panel(a + inner, a + len);
+                len = inner;
+            }
+            res += gradeHigh ? panel(b - len, b) : panel(a, a + len);
+        }
+        return res;
+    }
+}
+//_________________________________________________________________________
+double wignerAnisotropicSource::angularAverage(double x, const double c[3], double shift)
+{
+    // polar axis along out: n = (u, sqrt(1-u²) cos(phi), sqrt(1-u²) sin(phi)).
+    // The phi integral is analytic: 2π exp(-(a+b)/2) I0((a-b)/2), a,b = c_side,long x² (1-u²),
+    // written as 2π exp(-min(a,b)) * [exp(-|a-b|/2) I0(|a-b|/2)].
+    double x2 = x * x;
+    double m = x2 * std::min(c[kSide], c[kLong]);
+    double d = 0.5 * x2 * fabs(c[kSide] - c[kLong]);
+
+    // remaining exponent E(u) = A u² + B u + C
+    double A = -c[kOut] * x2 + m;
+    double B = 2 * c[kOut] * x * shift;
+    double C = -c[kOut] * shift * shift - m;
+    auto E = [&](double u)
+    { return (A * u + B) * u + C; };
+
+    double eMax = std::max(E(-1.), E(1.));
+    if (A < 0)
+    {
+        double vertex = -B / (2 * A);
+        if (vertex > -1 && vertex < 1)
+        {
+            eMax = std::max(eMax, E(vertex));
+        }
+    }
+
+    // restrict to E(u) >= eMax - 46 (relative contribution below 1E-20)
+    double c0 = C - eMax + 46;
+    std::vector<double> edges = {-1., 1.};
+    if (fabs(A) > 1E-300)
+    {
+        double disc = B * B - 4 * A * c0;
+        if (disc > 0)
+        {
+            double sq = sqrt(disc);
+            edges.push_back((-B - sq) / (2 * A));
+            edges.push_back((-B + sq) / (2 * A));
+        }
+    }
+    else if (fabs(B) > 1E-300)
+    {
+        edges.push_back(-c0 / B);
+    }
+    edges.erase(std::remove_if(edges.begin() + 2, edges.end(), [](double u)
+                               { return !(u > -1 && u < 1); }),
+                edges.end());
+    std::sort(edges.begin(), edges.end());
+
+    auto integrand = [&](double u)
+    {
+        double s = 1 - u * u;
+        return exp(E(u) - eMax) * wignerUtils::besselI0Scaled(d * s);
+    };
+
+    double res = 0;
+    for (size_t i = 0; i + 1 < edges.size(); ++i)
+    {
+        double lo = edges[i], hi = edges[i + 1];
+        double mid = 0.5 * (lo + hi);
+        if (hi > lo && (A * mid + B) * mid + c0 >= 0)
+        {
+            res += integratePanels(integrand, lo, hi);
+        }
+    }
+    return 2 * TMath::Pi() * res * exp(eMax);
+}
+//_________________________________________________________________________
+void wignerAnisotropicSource::setR0(double rOut, double rSide, double rLong)
+{
+    if (rOut < 0 || rSide < 0 || rLong < 0)
+    {
+        std::cerr << "Error: r0 is negative\n";
+        std::abort();
+    }
+    mR0[kOut] = rOut;
+    mR0[kSide] = rSide;
+    mR0[kLong] = rLong;
+}
+//_________________________________________________________________________
+void wignerAnisotropicSource::setRadii(double rOut, double rSide, double rLong)
+{
+    if (rOut <= 0 || rSide <= 0 || rLong <= 0)
+    {
+        std::cerr << "Error: source radius is not positive\n";
+        std::abort();
+    }
+    mRadius[kOut] = rOut;
+    mRadius[kSide] = rSide;
+    mRadius[kLong] = rLong;
+    mDirty = true;
+}
+//_________________________________________________________________________
+void wignerAnisotropicSource::setRadiusK(double k)
+{
+    if (k < 0)
+    {
+        std::cerr << "Error: k is negative\n";
+        std::abort();
+    }
+    mKin = k;
+    for (int i = 0; i < 3; ++i)
+    {
+        mRadius[i] = wignerUtils::radius(k, mR0[i]);
+    }
+    mKStar = wignerUtils::kStarEff(k, mRadius[kOut]);
+    mDirty = true;
+}
+//_________________________________________________________________________
+void wignerAnisotropicSource::setKstar(double k)
+{
+    if (k < 0)
+    {
+        std::cerr << "Error: k is negative\n";
+        std::abort();
+    }
+    mKStar = k;
+    mDirty = true;
+}
+//_________________________________________________________________________
+void wignerAnisotropicSource::setMu(double mu)
+{
+    if (mu <= 0)
+    {
+        std::cerr << "Error: reduced mass is not positive\n";
+        std::abort();
+    }
+    mMu = mu;
+}
+//_________________________________________________________________________
+void wignerAnisotropicSource::setRWidth(double rWidth)
+{
+    if (rWidth < 0)
+    {
+        std::cerr << "Error: potential well width is negative\n";
+        std::abort();
+    }
+    mRWidth = rWidth;
+    // the well edge is a panel break of the radial grid
+    mDirty = true;
+}
+//_________________________________________________________________________
+void wignerAnisotropicSource::setV0(double v0)
+{
+    mV0 = v0;
+}
+//_________________________________________________________________________
+double wignerAnisotropicSource::getRadius(int axis)
+{
+    return mRadius[axis];
+}
+//_________________________________________________________________________
+double wignerAnisotropicSource::getMeanRadius()
+{
+    return std::cbrt(mRadius[kOut] * mRadius[kSide] * mRadius[kLong]);
+}
+//_________________________________________________________________________
+double wignerAnisotropicSource::getKStar()
+{
+    return mKStar;
+}
+//_________________________________________________________________________
+void wignerAnisotropicSource::update()
+{
+    if (!mDirty)
+    {
+        return;
+    }
+
+    double hCut = wignerUtils::getHCut();
+    // panels of wignerUtils::integral, split at the edge of the well so that ⟨V⟩ counts whole cells
+    std::vector<double> hr, hp;
+    wignerCore::gridNodes(wignerUtils::getMinX(), wignerUtils::getMaxX(), {mRWidth}, wignerUtils::getDx(), mR, hr);
+    wignerCore::gridNodes(wignerUtils::getMinP(), wignerUtils::getMaxP(), {}, wignerUtils::getDp(), mP, hp);
+
+    double cR[3], cP[3], cR2[3], cP2[3];
+    for (int i = 0; i < 3; ++i)
+    {
+        cR[i] = 0.25 / (mRadius[i] * mRadius[i]);
+        cP[i] = 4 * mRadius[i] * mRadius[i] / (hCut * hCut);
+        cR2[i] = 2 * cR[i];
+        cP2[i] = 2 * cP[i];
+    }
+
+    mAr.resize(mR.size());
+    double sumR = 0, sumR2 = 0;
+    for (size_t i = 0; i < mR.size(); ++i)
+    {
+        double r = mR[i];
+        mAr[i] = r * r * angularAverage(r, cR, 0.) * hr[i];
+        sumR += mAr[i];
+        sumR2 += r * r * angularAverage(r, cR2, 0.) * hr[i];
+    }
+
+    mAp.resize(mP.size());
+    double sumP = 0, sumP2 = 0;
+    for (size_t j = 0; j < mP.size(); ++j)
+    {
+        double p = mP[j];
+        mAp[j] = p * p * angularAverage(p, cP, mKStar) * hp[j];
+        sumP += mAp[j];
+        sumP2 += p * p * angularAverage(p, cP2, mKStar) * hp[j];
+    }
+
+    mNorm = 1. / (sumR * sumP);
+    mWW = sumR2 * sumP2;
+    mDirty = false;
+}
+//_________________________________________________________________________
+double wignerAnisotropicSource::getNorm()
+{
+    // relative to the analytic normalization 1 / (π ħ)³, as in wignerSource
+    update();
+    double piH = TMath::Pi() * wignerUtils::getHCut();
+    return mNorm * piH * piH * piH;
+}
+//_________________________________________________________________________
+double wignerAnisotropicSource::getwK()
+{
+    update();
+    double sumR = 0, sumK = 0;
+    for (double a : mAr)
+    {
+        sumR += a;
+    }
+    for (size_t j = 0; j < mP.size(); ++j)
+    {
+        sumK += mAp[j] * mP[j] * mP[j] / (2 * mMu);
+    }
+    return mNorm * sumR * sumK;
+}
+//_________________________________________________________________________
+double wignerAnisotropicSource::getwV()
+{
+    update();
+    double sumWell = 0, sumP = 0;
+    for (size_t i = 0; i < mR.size() && mR[i] < mRWidth; ++i)
+    {
+        sumWell += mAr[i];
+    }
+    for (double a : mAp)
+    {
+        sumP += a;
+    }
+    return mNorm * sumWell * sumP * mV0;
+}
+//_________________________________________________________________________
+double wignerAnisotropicSource::getwH()
+{
+    return getwK() + getwV();
+}
+//_________________________________________________________________________
+double wignerAnisotropicSource::getcoal()
+{
+    update();
+    double x[2];
+    double res = 0;
+    for (size_t i = 0; i < mR.size(); ++i)
+    {
+        x[0] = mR[i];
+        double row = 0;
+        for (size_t j = 0; j < mP.size(); ++j)
+        {
+            x[1] = mP[j];
+            row += mAp[j] * wignerUtils::wignerDeuteron(x, nullptr);
+        }
+        res += mAr[i] * row;
+    }
+    double h = wignerUtils::getHCut() * 2 * TMath::Pi();
+    return res * mNorm * h * h * h;
+}
+//_________________________________________________________________________
+double wignerAnisotropicSource::checkWxW()
+{
+    update();
+    double h = wignerUtils::getHCut() * 2 * TMath::Pi();
+    return mWW * mNorm * mNorm * h * h * h;
+}
+//_________________________________________________________________________
+wignerPoint wignerAnisotropicSource::computePoint(double k)
+{
+    wignerPoint pt;
+    pt.k = k;
+    setRadiusK(k);
+
+    if (mCache && mCache->fetch(getCacheKey(), pt))
+    {
+        return pt;
+    }
+
+    pt.r0 = getMeanRadius();
+    pt.norm = getNorm();
+    pt.WW = checkWxW();
+    pt.wK = getwK();
+    pt.wV = getwV();
+    pt.wH = pt.wK + pt.wV;
+    pt.coal = getcoal();
+
+    if (mCache)
+    {
+        mCache->store(getCacheKey(), pt);
+    }
+    return pt;
+}
+//_________________________________________________________________________
+void wignerAnisotropicSource::setCache(wignerCache *cache)
+{
+    mCache = cache;
+}
+//_________________________________________________________________________
+wignerCacheKey wignerAnisotropicSource::getCacheKey()
+{
+    wignerCacheKey key;
+    key.params = {mR0[kOut], mR0[kSide], mR0[kLong], mKin,
+                  mRadius[kOut], mRadius[kSide], mRadius[kLong], mKStar, mMu, mRWidth, mV0,
+                  wignerUtils::getMinX(), wignerUtils::getMaxX(), wignerUtils::getMinP(), wignerUtils::getMaxP(),
+                  wignerUtils::getDx(), wignerUtils::getDp(),
+                  2.}; // revision of the grid: panels of wignerUtils::integral split at the edge of the well
+    key.table = wignerUtils::getDeuteronChecksum();
+    return key;
+}
+//_________________________________________________________________________
+void wignerAnisotropicSource::SetFromTxt(const std::string &txtfile)
+{
+    std::vector<double> params = wignerSource::readParamsFromFile(txtfile);
+    if (params.size() < 8)
+    {
+        std::cerr << "Error: expected 8 parameters, got " << params.size() << "\n";
+        return;
+    }
+    setR0(params[0], params[0], params[0]);
+    setMu(params[1]);
+    setRWidth(params[2]);
+    setV0(params[3]);
+}
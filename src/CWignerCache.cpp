@@ -0,0 +1,184 @@
+#include "CWignerCache.h"
+#include "CWignerManifest.h"
+#include "CWignerSource.h"
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fcntl.h>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <sys/file.h>
+#include <thread>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+    const uint32_t kMagic = 0x31434757; ///< "WGC1"
+    const size_t kNumValues = 7;        ///< r0, norm, WW, coal, wK, wV, wH.
+}
+//_________________________________________________________________________
+uint64_t wignerCacheKey::hash() const
+{
+    uint64_t h = wignerManifest::hash(&table, sizeof(table));
+    return wignerManifest::hash(params.data(), params.size() * sizeof(double), h);
+}
+//_________________________________________________________________________
+wignerCache::wignerCache(const std::string &dir, size_t maxEntries) : mDir(dir), mMaxEntries(maxEntries)
+{
+    std::error_code ec;
+    fs::create_directories(mDir, ec);
+    if (ec)
+    {
+        std::cerr << "Error: could not create cache directory " << mDir << ": " << ec.message() << "\n";
+    }
+}
+//_________________________________________________________________________
+std::string wignerCache::entryPath(uint64_t hash) const
+{
+    std::ostringstream name;
+    name << std::hex << std::setw(16) << std::setfill('0') << hash << ".wgc";
+    return (fs::path(mDir) / name.str()).string();
+}
+//_________________________________________________________________________
+bool wignerCache::fetch(const wignerCacheKey &key, wignerPoint &pt)
+{
+    std::string path = entryPath(key.hash());
+    FILE *f = std::fopen(path.c_str(), "rb");
+    if (!f)
+    {
+        ++mMisses;
+        return false;
+    }
+
+    uint32_t magic = 0, nParams = 0;
+    uint64_t table = 0;
+    std::vector<double> params;
+    double values[kNumValues];
+    bool ok = std::fread(&magic, sizeof(magic), 1, f) == 1 && magic == kMagic &&
+              std::fread(&nParams, sizeof(nParams), 1, f) == 1 && nParams == key.params.size() &&
+              std::fread(&table, sizeof(table), 1, f) == 1 && table == key.table;
+    if (ok)
+    {
+        params.resize(nParams);
+        ok = std::fread(params.data(), sizeof(double), nParams, f) == nParams && params == key.params &&
+             std::fread(values, sizeof(double), kNumValues, f) == kNumValues;
+    }
+    std::fclose(f);
+
+    if (!ok)
+    {
+        ++mMisses;
+        return false;
+    }
+
+    pt.r0 = values[0];
+    pt.norm = values[1];
+    pt.WW = values[2];
+    pt.coal = values[3];
+    pt.wK = values[4];
+    pt.wV = values[5];
+    pt.wH = values[6];
+
+    // refresh the LRU timestamp; failure (entry evicted meanwhile) is harmless
+    std::error_code ec;
+    fs::last_write_time(path, fs::file_time_type::clock::now(), ec);
+    ++mHits;
+    return true;
+}
+//_________________________________________________________________________
+void wignerCache::store(const wignerCacheKey &key, const wignerPoint &pt)
+{
+    std::string path = entryPath(key.hash());
+    std::ostringstream tmp;
+    tmp << path << ".tmp." << getpid() << "." << std::hash<std::thread::id>()(std::this_thread::get_id());
+
+    FILE *f = std::fopen(tmp.str().c_str(), "wb");
+    if (!f)
+    {
+        return;
+    }
+    uint32_t nParams = key.params.size();
+    double values[kNumValues] = {pt.r0, pt.norm, pt.WW, pt.coal, pt.wK, pt.wV, pt.wH};
+    bool ok = std::fwrite(&kMagic, sizeof(kMagic), 1, f) == 1 &&
+              std::fwrite(&nParams, sizeof(nParams), 1, f) == 1 &&
+              std::fwrite(&key.table, sizeof(key.table), 1, f) == 1 &&
+              std::fwrite(key.params.data(), sizeof(double), nParams, f) == nParams &&
+              std::fwrite(values, sizeof(double), kNumValues, f) == kNumValues;
+    ok = (std::fclose(f) == 0) && ok;
+
+    if (!ok || std::rename(tmp.str().c_str(), path.c_str()) != 0)
+    {
+        std::remove(tmp.str().c_str());
+        return;
+    }
+
+    // counting the entries costs a directory scan, so only check every few stores
+    long checkEvery = std::max<long>(1, std::min<long>(1000, mMaxEntries / 10));
+    if (++mStores % checkEvery == 0)
+    {
+        evict();
+    }
+}
+//_________________________________________________________________________
+void wignerCache::evict()
+{
+    std::string lockPath = (fs::path(mDir) / ".lock").string();
+    int fd = open(lockPath.c_str(), O_CREAT | O_RDWR, 0644);
+    if (fd < 0)
+    {
+        return;
+    }
+    // another process already evicting: let it do the work
+    if (flock(fd, LOCK_EX | LOCK_NB) != 0)
+    {
+        close(fd);
+        return;
+    }
+
+    std::vector<std::pair<fs::file_time_type, fs::path>> entries;
+    std::error_code ec;
+    for (const auto &entry : fs::directory_iterator(mDir, ec))
+    {
+        if (entry.path().extension() == ".wgc")
+        {
+            auto t = fs::last_write_time(entry.path(), ec);
+            if (!ec)
+            {
+                entries.emplace_back(t, entry.path());
+            }
+        }
+    }
+
+    if (entries.size() > mMaxEntries)
+    {
+        // evict down to 90% of the limit so that the next pass is not triggered immediately
+        size_t target = mMaxEntries - mMaxEntries / 10;
+        size_t nRemove = entries.size() - target;
+        std::nth_element(entries.begin(), entries.begin() + nRemove, entries.end());
+        for (size_t i = 0; i < nRemove; ++i)
+        {
+            fs::remove(entries[i].second, ec);
+        }
+    }
+
+    flock(fd, LOCK_UN);
+    close(fd);
+}
+//_________________________________________________________________________
+const std::string &wignerCache::getDir() const
+{
+    return mDir;
+}
+//_________________________________________________________________________
+long wignerCache::getHits() const
+{
+    return mHits;
+}
+//_________________________________________________________________________
+long wignerCache::getMisses() const
+{
+    return mMisses;
+}
@@ -0,0 +1,117 @@
+#include "CWignerContributionMap.h"
+#include "TH1.h"
+#include "TH2.h"
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <numeric>
+
+namespace
+{
+    const int kFine = 4; ///< Marginal bins per bin of the 2D map.
+}
+//_________________________________________________________________________
+wignerContributionMap::wignerContributionMap(int nr, int np, double rMin, double rMax, double pMin, double pMax)
+    : mNR(nr), mNP(np), mRMin(rMin), mRMax(rMax), mPMin(pMin), mPMax(pMax)
+{
+    if (nr < 1 || np < 1 || rMax <= rMin || pMax <= pMin)
+    {
+        std::cerr << "Error: invalid binning of the contribution maps\n";
+        std::abort();
+    }
+    reset();
+}
+//_________________________________________________________________________
+void wignerContributionMap::reset()
+{
+    for (int obs = 0; obs < kObservables; ++obs)
+    {
+        mRP[obs].assign(size_t(mNR) * mNP, 0.);
+        mR[obs].assign(size_t(mNR) * kFine, 0.);
+        mP[obs].assign(size_t(mNP) * kFine, 0.);
+    }
+}
+//_________________________________________________________________________
+int wignerContributionMap::bin(double x, double lo, double hi, int n)
+{
+    if (x < lo || x >= hi)
+    {
+        return -1;
+    }
+    return std::min(n - 1, int((x - lo) / (hi - lo) * n));
+}
+//_________________________________________________________________________
+void wignerContributionMap::fill(int obs, double r, double p, double w)
+{
+    int i = bin(r, mRMin, mRMax, mNR), j = bin(p, mPMin, mPMax, mNP);
+    if (i >= 0 && j >= 0)
+    {
+        mRP[obs][i + size_t(mNR) * j] += w;
+    }
+    i = bin(r, mRMin, mRMax, mNR * kFine);
+    if (i >= 0)
+    {
+        mR[obs][i] += w;
+    }
+    j = bin(p, mPMin, mPMax, mNP * kFine);
+    if (j >= 0)
+    {
+        mP[obs][j] += w;
+    }
+}
+//_________________________________________________________________________
+double wignerContributionMap::getTotal(int obs) const
+{
+    return std::accumulate(mRP[obs].begin(), mRP[obs].end(), 0.);
+}
+//_________________________________________________________________________
+double wignerContributionMap::getK() const
+{
+    return mK;
+}
+//_________________________________________________________________________
+void wignerContributionMap::setK(double k)
+{
+    mK = k;
+}
+//_________________________________________________________________________
+const char *wignerContributionMap::name(int obs)
+{
+    static const char *names[kObservables] = {"coal", "wK", "wV"};
+    return names[obs];
+}
+//_________________________________________________________________________
+void wignerContributionMap::write(TDirectory *dir, const TString &suffix) const
+{
+    dir->cd();
+    for (int obs = 0; obs < kObservables; ++obs)
+    {
+        TString title = TString::Format("%s contributions, k* = %g;r (fm);p (GeV/c)", name(obs), mK);
+        TH2D rp(TString::Format("%s_rp_%s", name(obs), suffix.Data()), title, mNR, mRMin, mRMax, mNP, mPMin, mPMax);
+        rp.SetDirectory(nullptr);
+        for (int j = 0; j < mNP; ++j)
+        {
+            for (int i = 0; i < mNR; ++i)
+            {
+                rp.SetBinContent(i + 1, j + 1, mRP[obs][i + size_t(mNR) * j]);
+            }
+        }
+        title = TString::Format("%s contributions, k* = %g;r (fm)", name(obs), mK);
+        TH1D hr(TString::Format("%s_r_%s", name(obs), suffix.Data()), title, mNR * kFine, mRMin, mRMax);
+        hr.SetDirectory(nullptr);
+        for (int i = 0; i < mNR * kFine; ++i)
+        {
+            hr.SetBinContent(i + 1, mR[obs][i]);
+        }
+        title = TString::Format("%s contributions, k* = %g;p (GeV/c)", name(obs), mK);
+        TH1D hp(TString::Format("%s_p_%s", name(obs), suffix.Data()), title, mNP * kFine, mPMin, mPMax);
+        hp.SetDirectory(nullptr);
+        for (int j = 0; j < mNP * kFine; ++j)
+        {
+            hp.SetBinContent(j + 1, mP[obs][j]);
+        }
+        rp.Write();
+        hr.Write();
+        hp.Write();
+    }
+}
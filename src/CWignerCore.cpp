@@ -0,0 +1,171 @@
+#include "CWignerCore.h"
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+//_________________________________________________________________________
+double wignerCore::wigner(double r, double p, double norm, double radius, double kStar)
+{
+    double n = 1. / (kPi * kHCut);
+    n *= n * n;
+
+    return norm * n * std::exp(-r * r * 0.25 / (radius * radius) - 4 * (p * p + kStar * kStar - 2 * p * kStar) * (radius * radius) / (kHCut * kHCut));
+}
+//_________________________________________________________________________
+double wignerCore::jacobian(double r, double p, double radius, double kStar, bool squared)
+{
+    double jacobian = (r * p) * (r * p) * 16 * kPi * kPi;
+
+    // single precision as in the original TF2 callbacks, so that both layers agree bit for bit
+    float kstarP = kStar * p;
+    if (kstarP < 1E-16)
+    {
+        kstarP = 1E-16;
+    }
+    double alpha = (squared ? 16 : 8) * kstarP * radius * radius / (kHCut * kHCut);
+
+    return jacobian * (0.5 * (1 - std::exp(-2 * alpha)) / alpha);
+}
+//_________________________________________________________________________
+double wignerCore::radius(double k, double r0)
+{
+    double radiusWave = std::sqrt(3. / 8) * kHCut / k;
+    return std::sqrt(radiusWave * radiusWave + r0 * r0);
+}
+//_________________________________________________________________________
+double wignerCore::kStarEff(double k, double radius)
+{
+    double kstarWave = std::sqrt(3. / 8) * kHCut / radius;
+    return std::sqrt(k * k - kstarWave * kstarWave);
+}
+//_________________________________________________________________________
+std::vector<double> wignerCore::panels(double lo, double hi, std::vector<double> breaks)
+{
+    std::sort(breaks.begin(), breaks.end());
+    std::vector<double> edges = {lo};
+    for (double b : breaks)
+    {
+        if (b > edges.back() && b < hi)
+        {
+            edges.push_back(b);
+        }
+    }
+    edges.push_back(hi);
+    return edges;
+}
+//_________________________________________________________________________
+void wignerCore::gridNodes(double lo, double hi, const std::vector<double> &breaks, double step,
+                           std::vector<double> &nodes, std::vector<double> &widths)
+{
+    std::vector<double> edges = panels(lo, hi, breaks);
+
+    nodes.clear();
+    widths.clear();
+    for (size_t i = 0; i + 1 < edges.size(); ++i)
+    {
+        double x0 = edges[i], x1 = edges[i + 1];
+        int n = std::max(1, int(std::ceil((x1 - x0) / step - 1E-6)));
+        double h = (x1 - x0) / n;
+        for (int ix = 0; ix < n; ++ix)
+        {
+            nodes.push_back(x0 + (ix + 0.5) * h);
+            widths.push_back(h);
+        }
+    }
+}
+//_________________________________________________________________________
+void wignerCore::sourceMoments(double norm, double radius, double kStar, double minX, double maxX, double minP, double maxP,
+                               double dx, double dp, std::vector<double> &edges, std::vector<double> &cumulative, double &p2)
+{
+    std::vector<double> p, hp;
+    gridNodes(minP, maxP, {}, dp, p, hp);
+
+    double g = 0, gp2 = 0;
+    for (size_t j = 0; j < p.size(); ++j)
+    {
+        double w = wigner(0, p[j], norm, radius, kStar) * jacobian(1, p[j], radius, kStar) * hp[j];
+        g += w;
+        gp2 += p[j] * p[j] * w;
+    }
+    radialSource(radius, minX, maxX, dx, edges, cumulative);
+    p2 = cumulative.back() * gp2;
+    for (double &c : cumulative)
+    {
+        c *= g;
+    }
+}
+//_________________________________________________________________________
+void wignerCore::radialSource(double radius, double minX, double maxX, double dx, std::vector<double> &edges,
+                              std::vector<double> &cumulative)
+{
+    std::vector<double> r, hr;
+    gridNodes(minX, maxX, {}, dx, r, hr);
+    edges.assign(1, minX);
+    cumulative.assign(1, 0.);
+    double f = 0;
+    for (size_t i = 0; i < r.size(); ++i)
+    {
+        f += std::exp(-r[i] * r[i] * 0.25 / (radius * radius)) * r[i] * r[i] * hr[i];
+        edges.push_back(r[i] + 0.5 * hr[i]);
+        cumulative.push_back(f);
+    }
+}
+//_________________________________________________________________________
+double wignerCore::interpolateCumulative(const std::vector<double> &edges, const std::vector<double> &cumulative, double x)
+{
+    if (edges.empty() || x <= edges.front())
+    {
+        return 0;
+    }
+    if (x >= edges.back())
+    {
+        return cumulative.back();
+    }
+    size_t c = std::upper_bound(edges.begin(), edges.end(), x) - edges.begin() - 1;
+    return cumulative[c] + (x - edges[c]) / (edges[c + 1] - edges[c]) * (cumulative[c + 1] - cumulative[c]);
+}
+//_________________________________________________________________________
+double wignerCore::gaussianCdf(double a, double radius)
+{
+    double x = a / radius;
+    return std::erf(0.5 * x) - x * std::exp(-0.25 * x * x) / std::sqrt(kPi);
+}
+//_________________________________________________________________________
+uint64_t wignerCore::hash(const void *data, size_t size, uint64_t seed)
+{
+    const unsigned char *bytes = static_cast<const unsigned char *>(data);
+    uint64_t h = seed;
+    for (size_t i = 0; i < size; ++i)
+    {
+        h ^= bytes[i];
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+//_________________________________________________________________________
+std::vector<double> wignerCore::readParams(const std::string &filename)
+{
+    std::ifstream infile(filename);
+    std::vector<double> values;
+    std::string line;
+
+    if (!infile.is_open())
+    {
+        std::cerr << "Could not open file: " << filename << "\n";
+        throw std::runtime_error("File open failed.");
+    }
+    while (std::getline(infile, line))
+    {
+        std::istringstream iss(line);
+        double val;
+        if (!(iss >> val))
+        {
+            std::cerr << "Warning: skipping invalid or empty line: " << line << "\n";
+            continue;
+        }
+        values.push_back(val);
+    }
+
+    return values;
+}
@@ -0,0 +1,259 @@
+#include "CWignerCoreSource.h"
+#include <cstdlib>
+#include <iostream>
+
+//_________________________________________________________________________
+wignerCoreSource::wignerCoreSource(const wignerTable *table) : mTable(table)
+{
+}
+//_________________________________________________________________________
+void wignerCoreSource::setTable(const wignerTable *table)
+{
+    mTable = table;
+}
+//_________________________________________________________________________
+void wignerCoreSource::setLowRankTable(const wignerLowRankTable *table)
+{
+    mLowRank = table;
+    mLowRankDirty = true;
+}
+//_________________________________________________________________________
+void wignerCoreSource::setR0(double r0)
+{
+    if (r0 < 0)
+    {
+        std::cerr << "Error: r0 is negative\n";
+        std::abort();
+    }
+    mR0 = r0;
+}
+//_________________________________________________________________________
+void wignerCoreSource::setMu(double mu)
+{
+    if (mu < 0)
+    {
+        std::cerr << "Error: mu is negative\n";
+        std::abort();
+    }
+    mMu = mu;
+}
+//_________________________________________________________________________
+void wignerCoreSource::setRWidth(double rWidth)
+{
+    if (rWidth < 0)
+    {
+        std::cerr << "Error: potential well width is negative\n";
+        std::abort();
+    }
+    mRWidth = rWidth;
+    mWell = squareWellPotential(mRWidth, mV0);
+    mPotentialDirty = true;
+}
+//_________________________________________________________________________
+void wignerCoreSource::setV0(double v0)
+{
+    mV0 = v0;
+    mWell = squareWellPotential(mRWidth, mV0);
+    mPotentialDirty = true;
+}
+//_________________________________________________________________________
+void wignerCoreSource::setPotential(const wignerPotential *potential)
+{
+    mPotential = potential;
+    mPotentialDirty = true;
+}
+//_________________________________________________________________________
+const wignerPotential *wignerCoreSource::getPotential() const
+{
+    return mPotential ? mPotential : &mWell;
+}
+//_________________________________________________________________________
+void wignerCoreSource::setIntegrationRanges(double minX, double maxX, double minP, double maxP)
+{
+    mMinX = minX;
+    mMaxX = maxX;
+    mMinP = minP;
+    mMaxP = maxP;
+    mPotentialDirty = true;
+    mLowRankDirty = true;
+}
+//_________________________________________________________________________
+void wignerCoreSource::setSteps(double dx, double dp)
+{
+    if (dx <= 0 || dp <= 0)
+    {
+        std::cerr << "Error: integration steps must be positive\n";
+        std::abort();
+    }
+    mDx = dx;
+    mDp = dp;
+    mPotentialDirty = true;
+    mLowRankDirty = true;
+}
+//_________________________________________________________________________
+void wignerCoreSource::SetFromTxt(const std::string &txtfile)
+{
+    std::vector<double> params = wignerCore::readParams(txtfile);
+    if (params.size() < 4)
+    {
+        std::cerr << "Error: expected at least 4 parameters, got " << params.size() << "\n";
+        return;
+    }
+    setR0(params[0]);
+    setMu(params[1]);
+    setRWidth(params[2]);
+    setV0(params[3]);
+}
+//_________________________________________________________________________
+uint64_t wignerCoreSource::getTableChecksum() const
+{
+    return mTable ? mTable->checksum() : 0;
+}
+//_________________________________________________________________________
+void wignerCoreSource::updatePotential()
+{
+    if (!mPotentialDirty)
+    {
+        return;
+    }
+    const wignerPotential *potential = getPotential();
+    wignerCore::gridNodes(mMinX, mMaxX, potential->getBreaks(), mDx, mRNodes, mRWidths);
+    wignerCore::gridNodes(mMinP, mMaxP, {}, mDp, mPNodes, mPWidths);
+    mVNodes = potential->onNodes(mRNodes);
+    mPotentialDirty = false;
+}
+//_________________________________________________________________________
+double wignerCoreSource::potentialEnergy()
+{
+    updatePotential();
+    double res = 0;
+    for (size_t i = 0; i < mRNodes.size(); ++i)
+    {
+        double sum = 0;
+        for (size_t j = 0; j < mPNodes.size(); ++j)
+        {
+            double r = mRNodes[i], p = mPNodes[j];
+            sum += wignerCore::wigner(r, p, mNorm, mRadius, mKStar) * wignerCore::jacobian(r, p, mRadius, mKStar) * mPWidths[j];
+        }
+        res += mVNodes[i] * (sum * mRWidths[i]);
+    }
+    return res;
+}
+//_________________________________________________________________________
+wignerPoint wignerCoreSource::computePoint(double k)
+{
+    if (k < 0)
+    {
+        std::cerr << "Error: k is negative\n";
+        std::abort();
+    }
+    wignerPoint pt;
+    pt.k = k;
+
+    mRadius = wignerCore::radius(k, mR0);
+    mKStar = wignerCore::kStarEff(k, mRadius);
+    if (mLowRank)
+    {
+        computeSeparable(pt);
+        return pt;
+    }
+    const double radius = mRadius, kStar = mKStar;
+
+    // W·J with norm 1 on the range of wignerSource::normalization()
+    mNorm = 1. / wignerCore::integrate([&](double r, double p)
+                                       { return wignerCore::wigner(r, p, 1., radius, kStar) * wignerCore::jacobian(r, p, radius, kStar); },
+                                       0., std::max(5. * radius, 20.), 0., 0.6, mDx, mDp);
+    const double norm = mNorm, mu = mMu;
+    const double h = wignerCore::kHCut * 2 * wignerCore::kPi;
+
+    pt.r0 = mRadius;
+    pt.norm = mNorm;
+    pt.WW = wignerCore::integrate([&](double r, double p)
+                                  {
+                                      double w = wignerCore::wigner(r, p, norm, radius, kStar);
+                                      return w * (wignerCore::jacobian(r, p, radius, kStar, true) * w); },
+                                  mMinX, mMaxX, mMinP, mMaxP, mDx, mDp) *
+            h * h * h;
+    // ⟨K⟩ and the square well only need the cumulative marginal and the p² moment, as in wignerSource
+    std::vector<double> edges, cumulative;
+    double p2;
+    wignerCore::sourceMoments(norm, radius, kStar, mMinX, mMaxX, mMinP, mMaxP, mDx, mDp, edges, cumulative, p2);
+    pt.wK = p2 / (2 * mu);
+    pt.wV = mPotential ? potentialEnergy() : mV0 * wignerCore::interpolateCumulative(edges, cumulative, mRWidth);
+    pt.wH = pt.wK + pt.wV;
+
+    if (mTable)
+    {
+        std::vector<double> rBreaks, pBreaks;
+        mTable->getBreaks(rBreaks, pBreaks);
+        const wignerTable &table = *mTable;
+        pt.coal = wignerCore::integrate([&](double r, double p)
+                                        { return table.interpolate(r, p) * wignerCore::wigner(r, p, norm, radius, kStar) * wignerCore::jacobian(r, p, radius, kStar); },
+                                        mMinX, mMaxX, mMinP, mMaxP, mDx, mDp, rBreaks, pBreaks) *
+                  h * h * h;
+    }
+    return pt;
+}
+//_________________________________________________________________________
+void wignerCoreSource::computeSeparable(wignerPoint &pt)
+{
+    const double radius = mRadius, kStar = mKStar;
+    const double h = wignerCore::kHCut * 2 * wignerCore::kPi;
+    std::vector<double> nodes, widths;
+
+    // W·J = F(r) G(p) with F = exp(-r² / 4R²) r²; the normalization is on the range of wignerSource::normalization()
+    double a = 0, b = 0;
+    wignerCore::gridNodes(0., std::max(5. * radius, 20.), {}, mDx, nodes, widths);
+    for (size_t i = 0; i < nodes.size(); ++i)
+    {
+        a += std::exp(-nodes[i] * nodes[i] * 0.25 / (radius * radius)) * nodes[i] * nodes[i] * widths[i];
+    }
+    wignerCore::gridNodes(0., 0.6, {}, mDp, nodes, widths);
+    for (size_t j = 0; j < nodes.size(); ++j)
+    {
+        b += wignerCore::wigner(0, nodes[j], 1., radius, kStar) * wignerCore::jacobian(1, nodes[j], radius, kStar) * widths[j];
+    }
+    mNorm = 1. / (a * b);
+    pt.r0 = mRadius;
+    pt.norm = mNorm;
+
+    // W·W·J₂ = exp(-r² / 2R²) r² times a function of p
+    a = b = 0;
+    wignerCore::gridNodes(mMinX, mMaxX, {}, mDx, nodes, widths);
+    for (size_t i = 0; i < nodes.size(); ++i)
+    {
+        a += std::exp(-nodes[i] * nodes[i] * 0.5 / (radius * radius)) * nodes[i] * nodes[i] * widths[i];
+    }
+    wignerCore::gridNodes(mMinP, mMaxP, {}, mDp, nodes, widths);
+    for (size_t j = 0; j < nodes.size(); ++j)
+    {
+        double w = wignerCore::wigner(0, nodes[j], mNorm, radius, kStar);
+        b += w * w * wignerCore::jacobian(1, nodes[j], radius, kStar, true) * widths[j];
+    }
+    pt.WW = a * b * h * h * h;
+
+    std::vector<double> edges, cumulative;
+    double p2;
+    wignerCore::sourceMoments(mNorm, radius, kStar, mMinX, mMaxX, mMinP, mMaxP, mDx, mDp, edges, cumulative, p2);
+    pt.wK = p2 / (2 * mMu);
+    pt.wV = mPotential ? potentialEnergy() : mV0 * wignerCore::interpolateCumulative(edges, cumulative, mRWidth);
+    pt.wH = pt.wK + pt.wV;
+
+    if (mLowRankDirty)
+    {
+        // same nodes as the grid integration, with the measure folded into the factors
+        mLowRank->projectGrid(mMinX, mMaxX, mMinP, mMaxP, mDx, mDp, mLowRankR, mLowRankP, mLowRankU, mLowRankV);
+        mLowRankDirty = false;
+    }
+    const size_t nr = mLowRankR.size(), np = mLowRankP.size();
+    std::vector<double> f(nr), g(np);
+    for (size_t i = 0; i < nr; ++i)
+    {
+        f[i] = std::exp(-mLowRankR[i] * mLowRankR[i] * 0.25 / (radius * radius));
+    }
+    for (size_t j = 0; j < np; ++j)
+    {
+        g[j] = wignerCore::wigner(0, mLowRankP[j], mNorm, radius, kStar) * wignerCore::jacobian(1, mLowRankP[j], radius, kStar);
+    }
+    pt.coal = mLowRank->coal(mLowRankU, mLowRankV, f, g) * h * h * h;
+}
@@ -0,0 +1,124 @@
+#include "CWignerCorrelation.h"
+#include "CWignerCore.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+
+//_________________________________________________________________________
+void wignerCorrelation::addChannel(const wignerTable &table, double weight)
+{
+    if (table.empty())
+    {
+        std::cerr << "Error: empty wavefunction table\n";
+        std::abort();
+    }
+    mTables.push_back(table);
+    mWeights.push_back(weight);
+}
+//_________________________________________________________________________
+bool wignerCorrelation::addChannel(const std::string &spec)
+{
+    std::string file = spec;
+    double weight = 1.;
+    size_t colon = spec.rfind(':');
+    if (colon != std::string::npos)
+    {
+        file = spec.substr(0, colon);
+        try
+        {
+            size_t used = 0;
+            weight = std::stod(spec.substr(colon + 1), &used);
+            if (used != spec.size() - colon - 1)
+            {
+                throw std::invalid_argument(spec);
+            }
+        }
+        catch (const std::exception &)
+        {
+            std::cerr << "Error: invalid weight in wavefunction " << spec << " (<file>[:<weight>])\n";
+            return false;
+        }
+    }
+    wignerTable table;
+    try
+    {
+        table = wignerTable::read(file);
+    }
+    catch (const std::runtime_error &)
+    {
+        return false;
+    }
+    if (table.empty())
+    {
+        std::cerr << "Error: empty wavefunction table " << file << "\n";
+        return false;
+    }
+    addChannel(table, weight);
+    return true;
+}
+//_________________________________________________________________________
+size_t wignerCorrelation::size() const
+{
+    return mTables.size();
+}
+//_________________________________________________________________________
+double wignerCorrelation::getRMax() const
+{
+    double rMax = 0;
+    for (const wignerTable &t : mTables)
+    {
+        rMax = std::max(rMax, t.getXMax());
+    }
+    return rMax;
+}
+//_________________________________________________________________________
+double wignerCorrelation::compute(double kStar, double radius, double minX, double maxX, double dx) const
+{
+    std::vector<double> edges, cumulative;
+    wignerCore::radialSource(radius, minX, std::min(maxX, getRMax()), dx, edges, cumulative);
+    return compute(kStar, radius, edges, cumulative);
+}
+//_________________________________________________________________________
+double wignerCorrelation::compute(double kStar, double radius, const std::vector<double> &edges, const std::vector<double> &cumulative) const
+{
+    double c = 0;
+    for (size_t t = 0; t < mTables.size(); ++t)
+    {
+        if (!(kStar >= mTables[t].getYMin() && kStar < mTables[t].getYMax()))
+        {
+            return std::numeric_limits<double>::quiet_NaN();
+        }
+        c += mWeights[t];
+    }
+    if (edges.size() < 2 || !(cumulative.back() > 0))
+    {
+        return c;
+    }
+
+    // the cumulative covers a fraction of the source: rescale it to S normalized over all r
+    const double scale = fraction(edges.front(), edges.back(), radius) / cumulative.back();
+    const double rMax = getRMax();
+    double sum = 0;
+    for (size_t i = 0; i + 1 < edges.size() && edges[i] < rMax; ++i)
+    {
+        double r = 0.5 * (edges[i] + edges[i + 1]), excess = 0;
+        for (size_t t = 0; t < mTables.size(); ++t)
+        {
+            const wignerTable &table = mTables[t];
+            if (r >= table.getXMin() && r < table.getXMax())
+            {
+                excess += mWeights[t] * (table.interpolate(r, kStar) - 1);
+            }
+        }
+        sum += (cumulative[i + 1] - cumulative[i]) * excess;
+    }
+    return c + scale * sum;
+}
+//_________________________________________________________________________
+double wignerCorrelation::fraction(double lo, double hi, double radius)
+{
+    return wignerCore::gaussianCdf(hi, radius) - wignerCore::gaussianCdf(std::max(lo, 0.), radius);
+}
@@ -0,0 +1,422 @@
+#include "CWignerDaemon.h"
+#include "CWignerSource.h"
+#include "TROOT.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fcntl.h>
+#include <iostream>
+#include <poll.h>
+#include <stdexcept>
+#include <sys/stat.h>
+#include <thread>
+
+//_________________________________________________________________________
+wignerDaemon::wignerDaemon(const std::string &txtinput, int nThreads) : mConfig(txtinput), mLatency(kLatencyBins, 0)
+{
+    setThreads(nThreads);
+}
+//_________________________________________________________________________
+void wignerDaemon::setThreads(int nThreads)
+{
+    mThreads = nThreads < 1 ? 1 : nThreads;
+}
+//_________________________________________________________________________
+void wignerDaemon::setVerbose(bool verbose)
+{
+    mVerbose = verbose;
+}
+//_________________________________________________________________________
+void wignerDaemon::setCache(wignerCache *cache)
+{
+    mCache = cache;
+}
+//_________________________________________________________________________
+void wignerDaemon::setMemoSize(size_t size)
+{
+    mMemoSize = size;
+}
+//_________________________________________________________________________
+void wignerDaemon::setReportInterval(double seconds)
+{
+    mReportInterval = seconds;
+}
+//_________________________________________________________________________
+void wignerDaemon::stop()
+{
+    mStop = true;
+}
+//_________________________________________________________________________
+bool wignerDaemon::serve(const std::string &path)
+{
+    sockaddr_un addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(addr.sun_path))
+    {
+        std::cerr << "Error: socket path too long: " << path << "\n";
+        return false;
+    }
+    std::strcpy(addr.sun_path, path.c_str());
+
+    struct stat st;
+    if (::stat(path.c_str(), &st) == 0)
+    {
+        if (!S_ISSOCK(st.st_mode))
+        {
+            std::cerr << "Error: " << path << " exists and is not a socket\n";
+            return false;
+        }
+        wignerClient probe;
+        if (probe.open(path))
+        {
+            std::cerr << "Error: a daemon is already listening on " << path << "\n";
+            return false;
+        }
+        ::unlink(path.c_str());
+    }
+
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0 || ::bind(fd, (sockaddr *)&addr, sizeof(addr)) < 0 || ::listen(fd, 64) < 0)
+    {
+        std::cerr << "Error: could not listen on " << path << ": " << std::strerror(errno) << "\n";
+        if (fd >= 0)
+        {
+            ::close(fd);
+        }
+        return false;
+    }
+
+    // workers write to the pipe when a connection is to be polled again; neither end may block
+    if (::pipe(mWake) < 0 || ::fcntl(mWake[0], F_SETFL, O_NONBLOCK) < 0 || ::fcntl(mWake[1], F_SETFL, O_NONBLOCK) < 0)
+    {
+        std::cerr << "Error: could not create the wake-up pipe: " << std::strerror(errno) << "\n";
+        ::close(fd);
+        return false;
+    }
+
+    mStop = false;
+    mStart = std::chrono::steady_clock::now();
+    ROOT::EnableThreadSafety();
+    std::vector<std::thread> workers;
+    for (int i = 0; i < mThreads; ++i)
+    {
+        workers.emplace_back(&wignerDaemon::work, this, i);
+    }
+    std::cout << "Listening on " << path << " with " << mThreads << " worker(s)\n";
+
+    auto lastReport = mStart;
+    std::vector<pollfd> pfds;
+    while (!mStop)
+    {
+        // the listening socket, the wake-up pipe and the connections waiting for a request
+        pfds.assign({{fd, POLLIN, 0}, {mWake[0], POLLIN, 0}});
+        {
+            std::lock_guard<std::mutex> lock(mQueueMutex);
+            for (int client : mIdle)
+            {
+                pfds.push_back({client, POLLIN, 0});
+            }
+        }
+        int ready = ::poll(pfds.data(), pfds.size(), 200);
+        if (ready > 0)
+        {
+            if (pfds[1].revents & POLLIN)
+            {
+                char buffer[64];
+                while (::read(mWake[0], buffer, sizeof(buffer)) > 0)
+                {
+                }
+            }
+            // a request or a hang-up: either way a worker reads the connection
+            bool queued = false;
+            {
+                std::lock_guard<std::mutex> lock(mQueueMutex);
+                for (size_t i = 2; i < pfds.size(); ++i)
+                {
+                    if (pfds[i].revents & (POLLIN | POLLHUP | POLLERR))
+                    {
+                        mIdle.erase(std::find(mIdle.begin(), mIdle.end(), pfds[i].fd));
+                        mPending.push_back(pfds[i].fd);
+                        queued = true;
+                    }
+                }
+            }
+            if (queued)
+            {
+                mQueueCond.notify_all();
+            }
+            if (pfds[0].revents & POLLIN)
+            {
+                int client = ::accept(fd, nullptr, nullptr);
+                if (client >= 0)
+                {
+                    {
+                        std::lock_guard<std::mutex> lock(mQueueMutex);
+                        mIdle.push_back(client);
+                    }
+                    std::lock_guard<std::mutex> lock(mStatsMutex);
+                    ++mStats.connections;
+                }
+            }
+        }
+        auto now = std::chrono::steady_clock::now();
+        if (mReportInterval > 0 && std::chrono::duration<double>(now - lastReport).count() >= mReportInterval)
+        {
+            printStats(getStats(), std::cout);
+            lastReport = now;
+        }
+    }
+
+    mQueueCond.notify_all();
+    for (auto &t : workers)
+    {
+        t.join();
+    }
+    for (int client : mPending)
+    {
+        ::close(client);
+    }
+    for (int client : mIdle)
+    {
+        ::close(client);
+    }
+    mPending.clear();
+    mIdle.clear();
+    ::close(mWake[0]);
+    ::close(mWake[1]);
+    ::close(fd);
+    ::unlink(path.c_str());
+
+    printStats(getStats(), std::cout);
+    return true;
+}
+//_________________________________________________________________________
+void wignerDaemon::work(int worker)
+{
+    // TF2 objects and configuration are built once per worker, not per query
+    wignerSource fw(TString::Format("_d%d", worker));
+    fw.initFunctions();
+    fw.SetFromTxt(mConfig);
+    fw.setCache(mCache);
+
+    while (true)
+    {
+        int fd;
+        {
+            std::unique_lock<std::mutex> lock(mQueueMutex);
+            mQueueCond.wait(lock, [this]()
+                            { return mStop || !mPending.empty(); });
+            if (mStop)
+            {
+                return;
+            }
+            fd = mPending.front();
+            mPending.pop_front();
+        }
+        if (!serveRequest(fd, fw))
+        {
+            ::close(fd);
+            continue;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mQueueMutex);
+            mIdle.push_back(fd);
+        }
+        // a full pipe means the accept loop is already due to wake up
+        char byte = 0;
+        if (::write(mWake[1], &byte, 1) < 0 && errno != EAGAIN)
+        {
+            std::cerr << "Error: could not wake the accept loop: " << std::strerror(errno) << "\n";
+        }
+    }
+}
+//_________________________________________________________________________
+bool wignerDaemon::serveRequest(int fd, wignerSource &fw)
+{
+    wignerMessageHeader header;
+    if (!wignerClient::readAll(fd, &header, sizeof(header)))
+    {
+        return false;
+    }
+    wignerMessageHeader reply;
+    reply.type = header.type;
+
+    bool valid = header.magic == wignerProtocol::kMagic && header.version == wignerProtocol::kVersion &&
+                 (header.type == wignerProtocol::kQuery || header.type == wignerProtocol::kStats) &&
+                 header.count <= wignerProtocol::kMaxCount;
+    if (!valid)
+    {
+        // the length of the payload is unknown: answer and drop the connection
+        reply.status = wignerProtocol::kBadHeader;
+        wignerClient::writeAll(fd, &reply, sizeof(reply));
+        record(0, 0, 0, true);
+        return false;
+    }
+
+    if (header.type == wignerProtocol::kStats)
+    {
+        wignerDaemonStats stats = getStats();
+        reply.count = 1;
+        return wignerClient::writeAll(fd, &reply, sizeof(reply)) && wignerClient::writeAll(fd, &stats, sizeof(stats));
+    }
+
+    std::vector<wignerQueryPoint> queries(header.count);
+    std::vector<wignerReplyPoint> replies;
+    if (!wignerClient::readAll(fd, queries.data(), queries.size() * sizeof(wignerQueryPoint)))
+    {
+        return false;
+    }
+    auto start = std::chrono::steady_clock::now();
+
+    bool good = std::all_of(queries.begin(), queries.end(), [](const wignerQueryPoint &q)
+                            { return q.k >= 0 && q.r0 >= 0 && std::isfinite(q.k) && std::isfinite(q.r0); });
+    size_t memoHits = 0;
+    if (good)
+    {
+        try
+        {
+            memoHits = compute(fw, queries, replies);
+            reply.count = replies.size();
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Error: request of " << queries.size() << " points failed: " << e.what() << "\n";
+            reply.status = wignerProtocol::kServerError;
+        }
+    }
+    else
+    {
+        reply.status = wignerProtocol::kBadQuery;
+    }
+    bool served = reply.status == wignerProtocol::kOk;
+    bool sent = wignerClient::writeAll(fd, &reply, sizeof(reply)) &&
+                (!served || wignerClient::writeAll(fd, replies.data(), replies.size() * sizeof(wignerReplyPoint)));
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    record(seconds, served ? queries.size() : 0, memoHits, !served);
+    if (mVerbose)
+    {
+        std::lock_guard<std::mutex> lock(mStatsMutex);
+        std::cout << "request: " << queries.size() << " points, " << memoHits << " in memory, "
+                  << seconds * 1E3 << " ms" << (served ? "" : good ? " (failed)" : " (rejected)") << "\n";
+    }
+    return sent;
+}
+//_________________________________________________________________________
+size_t wignerDaemon::compute(wignerSource &fw, const std::vector<wignerQueryPoint> &queries, std::vector<wignerReplyPoint> &replies)
+{
+    replies.resize(queries.size());
+    size_t hits = 0;
+    for (size_t i = 0; i < queries.size(); ++i)
+    {
+        const wignerQueryPoint &q = queries[i];
+        std::pair<double, double> key(q.k, q.r0);
+        if (mMemoSize > 0)
+        {
+            std::lock_guard<std::mutex> lock(mMemoMutex);
+            auto it = mMemo.find(key);
+            if (it != mMemo.end())
+            {
+                replies[i] = it->second;
+                ++hits;
+                continue;
+            }
+        }
+
+        fw.setR0(q.r0);
+        wignerPoint pt = fw.computePoint(q.k);
+        wignerReplyPoint &r = replies[i];
+        r.radius = pt.r0;
+        r.norm = pt.norm;
+        r.WW = pt.WW;
+        r.coal = pt.coal;
+        r.wK = pt.wK;
+        r.wV = pt.wV;
+        r.wH = pt.wH;
+        for (double v : {r.radius, r.norm, r.WW, r.coal, r.wK, r.wV, r.wH})
+        {
+            if (!std::isfinite(v))
+            {
+                throw std::runtime_error("non-finite observables at k* = " + std::to_string(q.k) + ", r0 = " + std::to_string(q.r0));
+            }
+        }
+
+        if (mMemoSize > 0)
+        {
+            std::lock_guard<std::mutex> lock(mMemoMutex);
+            // no eviction order to maintain: a full table is simply started again
+            if (mMemo.size() >= mMemoSize)
+            {
+                mMemo.clear();
+            }
+            mMemo[key] = r;
+        }
+    }
+    return hits;
+}
+//_________________________________________________________________________
+void wignerDaemon::record(double seconds, size_t points, size_t memoHits, bool error)
+{
+    std::lock_guard<std::mutex> lock(mStatsMutex);
+    if (error)
+    {
+        ++mStats.errors;
+        return;
+    }
+    ++mStats.requests;
+    mStats.points += points;
+    mStats.memoHits += memoHits;
+    mStats.busy += seconds;
+    mStats.latencyMax = std::max(mStats.latencyMax, seconds);
+    int bin = seconds > 0 ? int(std::floor(10 * std::log10(seconds / 1E-6))) : 0;
+    ++mLatency[std::min(std::max(bin, 0), kLatencyBins - 1)];
+}
+//_________________________________________________________________________
+wignerDaemonStats wignerDaemon::getStats() const
+{
+    std::lock_guard<std::mutex> lock(mStatsMutex);
+    wignerDaemonStats stats = mStats;
+    stats.uptime = std::chrono::duration<double>(std::chrono::steady_clock::now() - mStart).count();
+    if (stats.requests > 0)
+    {
+        stats.latencyMean = stats.busy / stats.requests;
+    }
+    if (stats.uptime > 0)
+    {
+        stats.pointsPerSecond = stats.points / stats.uptime;
+    }
+
+    // quantiles at the geometric center of the histogram bin
+    auto quantile = [&](double q)
+    {
+        uint64_t target = uint64_t(std::ceil(q * stats.requests));
+        uint64_t sum = 0;
+        for (int i = 0; i < kLatencyBins; ++i)
+        {
+            sum += mLatency[i];
+            if (sum >= target && sum > 0)
+            {
+                return 1E-6 * std::pow(10., (i + 0.5) / 10.);
+            }
+        }
+        return 0.;
+    };
+    stats.latencyP50 = std::min(quantile(0.5), stats.latencyMax);
+    stats.latencyP99 = std::min(quantile(0.99), stats.latencyMax);
+    return stats;
+}
+//_________________________________________________________________________
+void wignerDaemon::printStats(const wignerDaemonStats &stats, std::ostream &out)
+{
+    char line[512];
+    std::snprintf(line, sizeof(line),
+                  "Requests: %llu (%llu rejected), points: %llu (%llu in memory), connections: %llu\n"
+                  "Latency: mean %.3g ms, median %.3g ms, p99 %.3g ms, max %.3g ms\n"
+                  "Throughput: %.4g points/s over %.1f s (busy %.1f s)\n",
+                  (unsigned long long)stats.requests, (unsigned long long)stats.errors, (unsigned long long)stats.points,
+                  (unsigned long long)stats.memoHits, (unsigned long long)stats.connections,
+                  stats.latencyMean * 1E3, stats.latencyP50 * 1E3, stats.latencyP99 * 1E3, stats.latencyMax * 1E3,
+                  stats.pointsPerSecond, stats.uptime, stats.busy);
+    out << line;
+}
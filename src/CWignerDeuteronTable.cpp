@@ -0,0 +1,366 @@
+#include "CWignerDeuteronTable.h"
+#include "CWignerUtils.h"
+#include "TFile.h"
+#include "TH2.h"
+#include "TMath.h"
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+namespace
+{
+    /**
+     * @brief In-place iterative radix-2 FFT, X_k = Σ_n x_n exp(+2πi kn / N).
+     * @param a Data, size a power of two.
+     */
+    void fft(std::vector<std::complex<double>> &a)
+    {
+        size_t n = a.size();
+        for (size_t i = 1, j = 0; i < n; ++i)
+        {
+            size_t bit = n >> 1;
+            for (; j & bit; bit >>= 1)
+            {
+                j ^= bit;
+            }
+            j ^= bit;
+            if (i < j)
+            {
+                std::swap(a[i], a[j]);
+            }
+        }
+        for (size_t len = 2; len <= n; len <<= 1)
+        {
+            double angle = 2 * TMath::Pi() / len;
+            std::complex<double> wl(cos(angle), sin(angle));
+            for (size_t i = 0; i < n; i += len)
+            {
+                std::complex<double> w(1.);
+                for (size_t j = 0; j < len / 2; ++j)
+                {
+                    std::complex<double> u = a[i + j];
+                    std::complex<double> v = a[i + j + len / 2] * w;
+                    a[i + j] = u + v;
+                    a[i + j + len / 2] = u - v;
+                    w *= wl;
+                }
+            }
+        }
+    }
+}
+//_________________________________________________________________________
+wignerDeuteronTable wignerDeuteronTable::hulthen(double alpha, double beta)
+{
+    if (alpha <= 0 || beta <= alpha)
+    {
+        std::cerr << "Error: Hulthen parameters must satisfy 0 < alpha < beta\n";
+        std::abort();
+    }
+    wignerDeuteronTable table;
+    // sampled until u is negligible (exp(-alpha r) < 1e-8)
+    double rMax = 18.4 / alpha;
+    int n = int(rMax / table.mStep) + 2;
+    double norm = sqrt(2 * alpha * beta * (alpha + beta)) / (beta - alpha);
+    std::vector<double> u(n);
+    for (int i = 0; i < n; ++i)
+    {
+        double r = i * table.mStep;
+        u[i] = norm * (exp(-alpha * r) - exp(-beta * r));
+    }
+    table.setWavefunction(u, {});
+    return table;
+}
+//_________________________________________________________________________
+wignerDeuteronTable wignerDeuteronTable::fromFile(const std::string &filename)
+{
+    std::ifstream file(filename);
+    if (!file.is_open())
+    {
+        std::cerr << "Error opening file: " << filename << "\n";
+        throw std::runtime_error("Wavefunction file open failed.");
+    }
+
+    std::vector<double> r, u, w;
+    bool withD = true;
+    std::string line;
+    while (std::getline(file, line))
+    {
+        if (line.empty() || line[0] == '#')
+        {
+            continue;
+        }
+        std::istringstream iss(line);
+        double x, y, z;
+        if (!(iss >> x >> y))
+        {
+            continue;
+        }
+        if (!(iss >> z))
+        {
+            withD = false;
+            z = 0;
+        }
+        r.push_back(x);
+        u.push_back(y);
+        w.push_back(z);
+    }
+    if (r.size() < 2 || !std::is_sorted(r.begin(), r.end()))
+    {
+        std::cerr << "Error: " << filename << " needs at least two points in increasing r\n";
+        throw std::runtime_error("Wavefunction file invalid.");
+    }
+
+    // resample on the uniform grid; u and w vanish at r = 0
+    wignerDeuteronTable table;
+    int n = int(r.back() / table.mStep) + 1;
+    std::vector<double> us(n), ws(withD ? n : 0);
+    auto resample = [&](const std::vector<double> &f, double x)
+    {
+        if (x <= r.front())
+        {
+            return r.front() > 0 ? f.front() * x / r.front() : f.front();
+        }
+        size_t j = std::upper_bound(r.begin(), r.end(), x) - r.begin();
+        if (j >= r.size())
+        {
+            return f.back();
+        }
+        double t = (x - r[j - 1]) / (r[j] - r[j - 1]);
+        return f[j - 1] + t * (f[j] - f[j - 1]);
+    };
+    for (int i = 0; i < n; ++i)
+    {
+        us[i] = resample(u, i * table.mStep);
+        if (withD)
+        {
+            ws[i] = resample(w, i * table.mStep);
+        }
+    }
+
+    double norm = 0;
+    for (int i = 0; i < n; ++i)
+    {
+        norm += us[i] * us[i] + (withD ? ws[i] * ws[i] : 0.);
+    }
+    norm = sqrt(norm * table.mStep);
+    if (norm <= 0)
+    {
+        std::cerr << "Error: wavefunction in " << filename << " is zero\n";
+        throw std::runtime_error("Wavefunction file invalid.");
+    }
+    for (int i = 0; i < n; ++i)
+    {
+        us[i] /= norm;
+        if (withD)
+        {
+            ws[i] /= norm;
+        }
+    }
+    table.setWavefunction(us, ws);
+    return table;
+}
+//_________________________________________________________________________
+void wignerDeuteronTable::setWavefunction(const std::vector<double> &u, const std::vector<double> &w)
+{
+    auto divide = [&](const std::vector<double> &f, std::vector<double> &phi)
+    {
+        phi.resize(f.size());
+        for (size_t i = 1; i < f.size(); ++i)
+        {
+            phi[i] = f[i] / (i * mStep);
+        }
+        // u(r) / r is finite at the origin
+        phi[0] = f.size() > 2 ? 2 * phi[1] - phi[2] : phi[1];
+    };
+    divide(u, mPhiS);
+    mPhiD.clear();
+    mPD = 0;
+    if (!w.empty())
+    {
+        divide(w, mPhiD);
+        for (double x : w)
+        {
+            mPD += x * x;
+        }
+        mPD *= mStep;
+        // P2 vanishes at the origin for the D-wave
+        mPhiD[0] = 0;
+    }
+}
+//_________________________________________________________________________
+double wignerDeuteronTable::interpolate(const std::vector<double> &phi, double r) const
+{
+    double x = r / mStep;
+    size_t i = size_t(x);
+    if (i + 1 >= phi.size())
+    {
+        return 0;
+    }
+    double t = x - i;
+    return phi[i] + t * (phi[i + 1] - phi[i]);
+}
+//_________________________________________________________________________
+void wignerDeuteronTable::setGrid(int nR, double rMin, double rMax, int nP, double pMin, double pMax)
+{
+    if (nR < 1 || nP < 1 || rMin < 0 || rMax <= rMin || pMin < 0 || pMax <= pMin)
+    {
+        std::cerr << "Error: invalid grid of the deuteron table\n";
+        std::abort();
+    }
+    mNR = nR;
+    mRMin = rMin;
+    mRMax = rMax;
+    mNP = nP;
+    mPMin = pMin;
+    mPMax = pMax;
+}
+//_________________________________________________________________________
+void wignerDeuteronTable::setThreads(int nThreads)
+{
+    mThreads = nThreads < 1 ? 1 : nThreads;
+}
+//_________________________________________________________________________
+void wignerDeuteronTable::setStep(double dy)
+{
+    if (dy <= 0)
+    {
+        std::cerr << "Error: step is not positive\n";
+        std::abort();
+    }
+    mDy = dy;
+}
+//_________________________________________________________________________
+void wignerDeuteronTable::setAngularNodes(int n)
+{
+    mNMu = n < 2 ? 2 : n;
+}
+//_________________________________________________________________________
+double wignerDeuteronTable::getDProbability() const
+{
+    return mPD;
+}
+//_________________________________________________________________________
+wignerOverlap wignerDeuteronTable::overlap() const
+{
+    std::vector<double> u(mPhiS.size()), w(mPhiD.size());
+    for (size_t i = 0; i < u.size(); ++i)
+    {
+        u[i] = mPhiS[i] * (i * mStep);
+    }
+    for (size_t i = 0; i < w.size(); ++i)
+    {
+        w[i] = mPhiD[i] * (i * mStep);
+    }
+    return wignerOverlap(mStep, u, w);
+}
+//_________________________________________________________________________
+TH2D *wignerDeuteronTable::compute(const char *name)
+{
+    double hCut = wignerUtils::getHCut();
+    double dr = (mRMax - mRMin) / mNR;
+    double dp = (mPMax - mPMin) / mNP;
+    double rWave = (mPhiS.size() - 1) * mStep;
+    // ρ(r + y/2, r - y/2) vanishes for y > 2 (r + rWave)
+    double yExtent = 2 * (mRMax + rWave);
+
+    // y step commensurate with a refined p step dp / L: (dp / L) dy / ħ = π / M, so that
+    // sin(p_j y_n / ħ) = Im exp(iπ n (jL + c) / M), a DFT of length 2M in n
+    int l = std::max(1, int(ceil(yExtent * dp / (TMath::Pi() * hCut))));
+    double yMax = l * TMath::Pi() * hCut / dp;
+    size_t m = 1;
+    while (m < yMax / mDy || m < size_t(mNP) * l)
+    {
+        m <<= 1;
+    }
+    double dy = yMax / m;
+    double c = mPMin / dp * l + 0.5 * l;
+
+    std::vector<double> mu, wMu;
+    wignerUtils::gaussLegendre(mNMu, mu, wMu);
+
+    double h = 2 * TMath::Pi() * hCut;
+    double scale = 1. / (h * h * h); // 4π from the directions of y, 1 / (4π) from ρ
+    std::vector<double> table(size_t(mNR) * mNP);
+
+    auto worker = [&](int thread)
+    {
+        std::vector<std::complex<double>> a(2 * m);
+        for (int i = thread; i < mNR; i += mThreads)
+        {
+            double r = mRMin + (i + 0.5) * dr;
+            size_t nMax = std::min(m, size_t(2 * (r + rWave) / dy) + 1);
+            std::fill(a.begin(), a.end(), 0.);
+            for (size_t n = 1; n < nMax; ++n)
+            {
+                double y = n * dy;
+                // F(r, y): the integrand is even in μ, Gauss-Legendre on [0, 1]
+                double f = 0;
+                for (int k = 0; k < mNMu; ++k)
+                {
+                    double x = 0.5 * (mu[k] + 1);
+                    double s = r * r + 0.25 * y * y;
+                    double aPlus = sqrt(s + r * y * x);
+                    double aMinus = sqrt(std::max(0., s - r * y * x));
+                    double rho = interpolate(mPhiS, aPlus) * interpolate(mPhiS, aMinus);
+                    if (!mPhiD.empty() && aPlus * aMinus > 0)
+                    {
+                        double cosg = (r * r - 0.25 * y * y) / (aPlus * aMinus);
+                        rho += interpolate(mPhiD, aPlus) * interpolate(mPhiD, aMinus) * 0.5 * (3 * cosg * cosg - 1);
+                    }
+                    f += 0.5 * wMu[k] * rho;
+                }
+                a[n] = y * f * dy * std::polar(1., TMath::Pi() * n * c / m);
+            }
+            fft(a);
+            for (int j = 0; j < mNP; ++j)
+            {
+                double p = mPMin + (j + 0.5) * dp;
+                table[size_t(i) * mNP + j] = scale * hCut / p * a[size_t(j) * l].imag();
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < mThreads; ++t)
+    {
+        threads.emplace_back(worker, t);
+    }
+    for (auto &t : threads)
+    {
+        t.join();
+    }
+
+    TH2D *hist = new TH2D(name, "r,q", mNR, mRMin, mRMax, mNP, mPMin, mPMax);
+    hist->SetDirectory(nullptr);
+    for (int i = 0; i < mNR; ++i)
+    {
+        for (int j = 0; j < mNP; ++j)
+        {
+            hist->SetBinContent(i + 1, j + 1, table[size_t(i) * mNP + j]);
+        }
+    }
+    return hist;
+}
+//_________________________________________________________________________
+bool wignerDeuteronTable::write(const TString &filename, const std::string &binary)
+{
+    TH2D *hist = compute("h");
+    TFile file(filename, "RECREATE");
+    if (file.IsZombie())
+    {
+        std::cerr << "Error: could not create " << filename << "\n";
+        delete hist;
+        return false;
+    }
+    hist->Write("h");
+    file.Close();
+    bool ok = binary.empty() || wignerUtils::toTable(hist).write(binary);
+    delete hist;
+    return ok;
+}
@@ -0,0 +1,563 @@
+#include "CWignerEnsemble.h"
+#include "CWignerCore.h"
+#include "CWignerSource.h"
+#include "CWignerUtils.h"
+#include "TFile.h"
+#include "TH2.h"
+#include "TMath.h"
+#include "TROOT.h"
+#include "TTree.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+namespace
+{
+    /// Quantile levels of wignerBand::q.
+    const double gLevels[5] = {0.025, 0.16, 0.5, 0.84, 0.975};
+}
+//_________________________________________________________________________
+wignerEnsemble::wignerEnsemble(const std::string &txtinput, int nThreads) : mConfig(txtinput)
+{
+    setThreads(nThreads);
+    for (int i = 0; i < kNParameters; ++i)
+    {
+        for (int j = 0; j < kNParameters; ++j)
+        {
+            mCorr[i][j] = i == j ? 1. : 0.;
+        }
+    }
+
+    std::vector<double> params = wignerSource::readParamsFromFile(txtinput);
+    if (params.size() < 8)
+    {
+        std::cerr << "Error: expected 8 parameters, got " << params.size() << "\n";
+        std::abort();
+    }
+    setFixed(kR0, params[0]);
+    setFixed(kMu, params[1]);
+    setFixed(kRWidth, params[2]);
+    setFixed(kV0, params[3]);
+}
+//_________________________________________________________________________
+wignerEnsemble::~wignerEnsemble()
+{
+    for (TH2 *h : mTables)
+    {
+        delete h;
+    }
+}
+//_________________________________________________________________________
+void wignerEnsemble::setThreads(int nThreads)
+{
+    mThreads = nThreads < 1 ? 1 : nThreads;
+}
+//_________________________________________________________________________
+void wignerEnsemble::setVerbose(bool verbose)
+{
+    mVerbose = verbose;
+}
+//_________________________________________________________________________
+void wignerEnsemble::setSamples(int nSamples)
+{
+    if (nSamples < 1)
+    {
+        std::cerr << "Error: number of samples is not positive\n";
+        std::abort();
+    }
+    mSamples = nSamples;
+}
+//_________________________________________________________________________
+void wignerEnsemble::setSeed(unsigned long seed)
+{
+    mSeed = seed;
+}
+//_________________________________________________________________________
+void wignerEnsemble::setNodes(int nNodes)
+{
+    mNodes = nNodes < 2 ? 2 : nNodes;
+}
+//_________________________________________________________________________
+void wignerEnsemble::setFixed(int par, double value)
+{
+    mDist[par] = {0, value, 0.};
+}
+//_________________________________________________________________________
+void wignerEnsemble::setGaussian(int par, double mean, double sigma)
+{
+    if (sigma < 0)
+    {
+        std::cerr << "Error: Gaussian width is negative\n";
+        std::abort();
+    }
+    mDist[par] = {1, mean, sigma};
+}
+//_________________________________________________________________________
+void wignerEnsemble::setUniform(int par, double lo, double hi)
+{
+    if (hi < lo)
+    {
+        std::cerr << "Error: empty uniform range\n";
+        std::abort();
+    }
+    mDist[par] = {2, lo, hi};
+}
+//_________________________________________________________________________
+void wignerEnsemble::setCorrelation(int a, int b, double rho)
+{
+    if (a == b || rho <= -1 || rho >= 1)
+    {
+        std::cerr << "Error: invalid correlation\n";
+        std::abort();
+    }
+    mCorr[a][b] = mCorr[b][a] = rho;
+}
+//_________________________________________________________________________
+void wignerEnsemble::addDeuteronTable(const TString &filename, double weight)
+{
+    if (weight <= 0)
+    {
+        std::cerr << "Error: table weight is not positive\n";
+        std::abort();
+    }
+    mTableFiles.push_back(filename);
+    mTableWeights.push_back(weight);
+}
+//_________________________________________________________________________
+int wignerEnsemble::parameterIndex(const std::string &name)
+{
+    if (name == "r0")
+        return kR0;
+    if (name == "mu")
+        return kMu;
+    if (name == "rWidth")
+        return kRWidth;
+    if (name == "V0" || name == "v0")
+        return kV0;
+    return -1;
+}
+//_________________________________________________________________________
+void wignerEnsemble::readSpec(const std::string &specfile)
+{
+    std::ifstream file(specfile);
+    if (!file.is_open())
+    {
+        std::cerr << "Could not open file: " << specfile << "\n";
+        throw std::runtime_error("Ensemble file open failed.");
+    }
+
+    std::string line;
+    while (std::getline(file, line))
+    {
+        line = line.substr(0, line.find('#'));
+        std::istringstream iss(line);
+        std::string key;
+        if (!(iss >> key))
+        {
+            continue;
+        }
+
+        bool ok = true;
+        if (key == "samples" || key == "seed" || key == "nodes")
+        {
+            double value;
+            ok = bool(iss >> value);
+            if (ok && key == "samples")
+                setSamples(int(value));
+            else if (ok && key == "seed")
+                setSeed((unsigned long)value);
+            else if (ok)
+                setNodes(int(value));
+        }
+        else if (key == "table")
+        {
+            std::string name;
+            double weight = 1.;
+            ok = bool(iss >> name);
+            iss >> weight;
+            if (ok)
+                addDeuteronTable(name, weight);
+        }
+        else if (key == "corr")
+        {
+            std::string a, b;
+            double rho;
+            ok = (iss >> a >> b >> rho) && parameterIndex(a) >= 0 && parameterIndex(b) >= 0;
+            if (ok)
+                setCorrelation(parameterIndex(a), parameterIndex(b), rho);
+        }
+        else if (parameterIndex(key) >= 0)
+        {
+            int par = parameterIndex(key);
+            std::string type;
+            double a, b = 0;
+            ok = bool(iss >> type >> a);
+            if (ok && type == "fixed")
+                setFixed(par, a);
+            else if (ok && (type == "gauss" || type == "uniform") && (iss >> b))
+                type == "gauss" ? setGaussian(par, a, b) : setUniform(par, a, b);
+            else
+                ok = false;
+        }
+        else
+        {
+            ok = false;
+        }
+
+        if (!ok)
+        {
+            std::cerr << "Error: invalid line in " << specfile << ": " << line << "\n";
+            throw std::runtime_error("Ensemble file invalid.");
+        }
+    }
+}
+//_________________________________________________________________________
+void wignerEnsemble::prepare()
+{
+    for (TH2 *h : mTables)
+    {
+        delete h;
+    }
+    mTables.clear();
+    for (const TString &name : mTableFiles)
+    {
+        TFile file(name, "READ");
+        TH2 *h = file.IsZombie() ? nullptr : dynamic_cast<TH2 *>(file.Get("h"));
+        if (!h)
+        {
+            std::cerr << "Could not read h from " << name << "\n";
+            throw std::runtime_error("Deuteron table open failed.");
+        }
+        h->SetDirectory(nullptr);
+        mTables.push_back(h);
+    }
+    if (mTables.empty())
+    {
+        mTables.push_back(nullptr);
+    }
+
+    // Cholesky factor of the copula correlation matrix
+    double l[kNParameters][kNParameters] = {};
+    for (int i = 0; i < kNParameters; ++i)
+    {
+        for (int j = 0; j <= i; ++j)
+        {
+            double s = mCorr[i][j];
+            for (int m = 0; m < j; ++m)
+            {
+                s -= l[i][m] * l[j][m];
+            }
+            if (i == j)
+            {
+                if (s <= 0)
+                {
+                    std::cerr << "Error: correlation matrix is not positive definite\n";
+                    std::abort();
+                }
+                l[i][i] = sqrt(s);
+            }
+            else
+            {
+                l[i][j] = s / l[j][j];
+            }
+        }
+    }
+
+    std::mt19937_64 rng(mSeed);
+    std::normal_distribution<double> gaus(0., 1.);
+    std::discrete_distribution<int> pick(mTableWeights.begin(), mTableWeights.end());
+    mDraws.assign(mSamples, std::vector<double>(kNParameters));
+    mDrawTables.assign(mSamples, 0);
+    for (int s = 0; s < mSamples; ++s)
+    {
+        double z[kNParameters];
+        for (int i = 0; i < kNParameters; ++i)
+        {
+            z[i] = gaus(rng);
+        }
+        for (int i = 0; i < kNParameters; ++i)
+        {
+            double y = 0;
+            for (int j = 0; j <= i; ++j)
+            {
+                y += l[i][j] * z[j];
+            }
+            const distribution &d = mDist[i];
+            double &x = mDraws[s][i];
+            if (d.type == 1)
+                x = d.a + d.b * y;
+            else if (d.type == 2)
+                x = d.a + (d.b - d.a) * 0.5 * std::erfc(-y / sqrt(2.));
+            else
+                x = d.a;
+        }
+        if (!mTableFiles.empty())
+        {
+            mDrawTables[s] = pick(rng);
+        }
+
+        // radii are truncated at 0; a non-positive mass has no meaning
+        mDraws[s][kR0] = std::max(0., mDraws[s][kR0]);
+        mDraws[s][kRWidth] = std::max(0., mDraws[s][kRWidth]);
+        if (mDraws[s][kMu] <= 0)
+        {
+            std::cerr << "Error: sampled mu is not positive, reduce the width of its distribution\n";
+            std::abort();
+        }
+    }
+}
+//_________________________________________________________________________
+wignerEnsemble::node wignerEnsemble::computeNode(wignerSource &fw, const std::vector<TF2 *> &coals, double k, double r0) const
+{
+    node n;
+    fw.setR0(r0);
+    fw.setRadiusK(k);
+
+    // radial marginal of W·J and ∫ p² W·J on the grid of wignerUtils::integral
+    wignerCore::sourceMoments(fw.getNorm(), fw.getRadius(), fw.getKStar(),
+                              wignerUtils::getMinX(), wignerUtils::getMaxX(), wignerUtils::getMinP(), wignerUtils::getMaxP(),
+                              wignerUtils::getDx(), wignerUtils::getDp(), n.edges, n.cdf, n.p2);
+
+    double h = wignerUtils::getHCut() * 2 * TMath::Pi();
+    for (size_t t = 0; t < coals.size(); ++t)
+    {
+        if (!coals[t])
+        {
+            n.coal.push_back(fw.getcoal());
+            continue;
+        }
+        coals[t]->SetParameter(0, fw.getNorm());
+        coals[t]->SetParameter(1, fw.getRadius());
+        coals[t]->SetParameter(2, fw.getKStar());
+        const TAxis *xaxis = mTables[t]->GetXaxis();
+        const TAxis *yaxis = mTables[t]->GetYaxis();
+        std::vector<double> rBreaks = {xaxis->GetBinCenter(1), xaxis->GetBinCenter(xaxis->GetNbins()), xaxis->GetXmax()};
+        std::vector<double> pBreaks = {yaxis->GetBinCenter(1), yaxis->GetBinCenter(yaxis->GetNbins()), yaxis->GetXmax()};
+        n.coal.push_back(wignerUtils::integral(coals[t], rBreaks, pBreaks) * h * h * h);
+    }
+    return n;
+}
+//_________________________________________________________________________
+wignerBand wignerEnsemble::summarize(std::vector<double> &values)
+{
+    wignerBand band;
+    size_t n = values.size();
+    for (double v : values)
+    {
+        band.mean += v;
+    }
+    band.mean /= n;
+    for (double v : values)
+    {
+        band.sigma += (v - band.mean) * (v - band.mean);
+    }
+    band.sigma = n > 1 ? sqrt(band.sigma / (n - 1)) : 0.;
+
+    std::sort(values.begin(), values.end());
+    for (int i = 0; i < 5; ++i)
+    {
+        double pos = gLevels[i] * (n - 1);
+        size_t j = std::min(size_t(pos), n - 1);
+        double t = pos - j;
+        band.q[i] = j + 1 < n ? values[j] + t * (values[j + 1] - values[j]) : values[j];
+    }
+    return band;
+}
+//_________________________________________________________________________
+std::vector<wignerBandPoint> wignerEnsemble::run(const std::vector<double> &kValues)
+{
+    prepare();
+
+    // Chebyshev points of the second kind over the sampled r0 range
+    double lo = mDraws[0][kR0], hi = lo;
+    for (const auto &d : mDraws)
+    {
+        lo = std::min(lo, d[kR0]);
+        hi = std::max(hi, d[kR0]);
+    }
+    int nNodes = hi > lo ? mNodes : 1;
+    std::vector<double> r0Nodes(nNodes, lo), baryWeights(nNodes, 1.);
+    for (int j = 0; j < nNodes && nNodes > 1; ++j)
+    {
+        r0Nodes[j] = 0.5 * (lo + hi) + 0.5 * (hi - lo) * cos(TMath::Pi() * j / (nNodes - 1));
+        baryWeights[j] = (j % 2 ? -1. : 1.) * ((j == 0 || j == nNodes - 1) ? 0.5 : 1.);
+    }
+
+    std::cout << "Ensemble of " << mSamples << " samples, " << mTables.size() << " deuteron table(s), "
+              << nNodes << " r0 node(s) in [" << lo << ", " << hi << "]\n";
+
+    // the node integrals: the only part whose cost grows with the scan
+    size_t nTasks = kValues.size() * nNodes;
+    std::vector<node> nodes(nTasks);
+    int nWorkers = std::min<int>(mThreads, std::max<size_t>(nTasks, 1));
+    auto worker = [&](int w)
+    {
+        wignerSource fw(TString::Format("_ens%d", w));
+        fw.initFunctions();
+        fw.SetFromTxt(mConfig);
+        std::vector<TF2 *> coals(mTables.size(), nullptr);
+        for (size_t t = 0; t < mTables.size(); ++t)
+        {
+            TH2 *table = mTables[t];
+            if (!table)
+            {
+                continue;
+            }
+            auto integrand = [table](double *x, double *pm)
+            {
+                return table->Interpolate(x[0], x[1]) * wignerUtils::jacobianFun(x, pm);
+            };
+            coals[t] = new TF2(TString::Format("ensCoal%d_%zu", w, t), integrand,
+                               wignerUtils::getMinX(), wignerUtils::getMaxX(), wignerUtils::getMinP(), wignerUtils::getMaxP(), 3);
+        }
+        for (size_t i = w; i < nTasks; i += nWorkers)
+        {
+            nodes[i] = computeNode(fw, coals, kValues[i / nNodes], r0Nodes[i % nNodes]);
+        }
+        for (TF2 *f : coals)
+        {
+            delete f;
+        }
+    };
+    if (nWorkers == 1)
+    {
+        worker(0);
+    }
+    else
+    {
+        ROOT::EnableThreadSafety();
+        std::vector<std::thread> threads;
+        for (int w = 0; w < nWorkers; ++w)
+        {
+            threads.emplace_back(worker, w);
+        }
+        for (auto &t : threads)
+        {
+            t.join();
+        }
+    }
+
+    // barycentric interpolation weights of each sample, shared by all k*
+    std::vector<std::vector<double>> lambda(mSamples, std::vector<double>(nNodes, 0.));
+    for (int s = 0; s < mSamples; ++s)
+    {
+        double x = mDraws[s][kR0];
+        auto exact = std::find(r0Nodes.begin(), r0Nodes.end(), x);
+        if (exact != r0Nodes.end())
+        {
+            lambda[s][exact - r0Nodes.begin()] = 1.;
+            continue;
+        }
+        double sum = 0;
+        for (int j = 0; j < nNodes; ++j)
+        {
+            lambda[s][j] = baryWeights[j] / (x - r0Nodes[j]);
+            sum += lambda[s][j];
+        }
+        for (int j = 0; j < nNodes; ++j)
+        {
+            lambda[s][j] /= sum;
+        }
+    }
+
+    std::vector<wignerBandPoint> points(kValues.size());
+    std::vector<double> coal(mSamples), wK(mSamples), wV(mSamples), wH(mSamples);
+    for (size_t i = 0; i < kValues.size(); ++i)
+    {
+        const node *kNodes = &nodes[i * nNodes];
+        for (int s = 0; s < mSamples; ++s)
+        {
+            const std::vector<double> &d = mDraws[s];
+            // ∫_{r < rWidth} W·J, linear within the cell containing rWidth
+            double inside = 0, p2 = 0;
+            coal[s] = 0;
+            for (int j = 0; j < nNodes; ++j)
+            {
+                const node &n = kNodes[j];
+                inside += lambda[s][j] * wignerCore::interpolateCumulative(n.edges, n.cdf, d[kRWidth]);
+                p2 += lambda[s][j] * n.p2;
+                coal[s] += lambda[s][j] * n.coal[mDrawTables[s]];
+            }
+            wK[s] = p2 / (2 * d[kMu]);
+            wV[s] = d[kV0] * inside;
+            wH[s] = wK[s] + wV[s];
+        }
+
+        wignerBandPoint &pt = points[i];
+        pt.k = kValues[i];
+        pt.coal = summarize(coal);
+        pt.wK = summarize(wK);
+        pt.wV = summarize(wV);
+        pt.wH = summarize(wH);
+        if (mVerbose)
+        {
+            std::cout << "k*: " << pt.k
+                      << " coal: " << pt.coal.mean << " +- " << pt.coal.sigma
+                      << " K: " << pt.wK.mean << " +- " << pt.wK.sigma
+                      << " V: " << pt.wV.mean << " +- " << pt.wV.sigma
+                      << " H: " << pt.wH.mean << " +- " << pt.wH.sigma << "\n";
+        }
+    }
+    return points;
+}
+//_________________________________________________________________________
+bool wignerEnsemble::writeTree(const std::vector<wignerBandPoint> &points, const TString &outfile) const
+{
+    TFile file(outfile, "RECREATE");
+    if (file.IsZombie())
+    {
+        std::cerr << "Error: could not create " << outfile << "\n";
+        return false;
+    }
+    std::cout << "Creating " << outfile << "\n";
+
+    TTree *bands = new TTree("bands", "ensemble bands");
+    wignerBandPoint pt;
+    bands->Branch("k", &pt.k, "k/D");
+    const char *suffixes[5] = {"q025", "q16", "q50", "q84", "q975"};
+    auto branches = [&](const char *name, wignerBand &band)
+    {
+        bands->Branch(TString::Format("%s_mean", name), &band.mean, TString::Format("%s_mean/D", name));
+        bands->Branch(TString::Format("%s_sigma", name), &band.sigma, TString::Format("%s_sigma/D", name));
+        for (int i = 0; i < 5; ++i)
+        {
+            TString branch = TString::Format("%s_%s", name, suffixes[i]);
+            bands->Branch(branch, &band.q[i], branch + "/D");
+        }
+    };
+    branches("coal", pt.coal);
+    branches("wK", pt.wK);
+    branches("wV", pt.wV);
+    branches("wH", pt.wH);
+    for (const auto &p : points)
+    {
+        pt = p;
+        bands->Fill();
+    }
+
+    TTree *samples = new TTree("samples", "ensemble samples");
+    double par[kNParameters];
+    int table = 0;
+    samples->Branch("r0", &par[kR0], "r0/D");
+    samples->Branch("mu", &par[kMu], "mu/D");
+    samples->Branch("rWidth", &par[kRWidth], "rWidth/D");
+    samples->Branch("V0", &par[kV0], "V0/D");
+    samples->Branch("table", &table, "table/I");
+    for (size_t s = 0; s < mDraws.size(); ++s)
+    {
+        std::copy(mDraws[s].begin(), mDraws[s].end(), par);
+        table = mDrawTables[s];
+        samples->Fill();
+    }
+
+    bands->Write();
+    samples->Write();
+    file.Close();
+    return true;
+}
@@ -0,0 +1,178 @@
+#include "CWignerFrame.h"
+#include "CWignerUtils.h"
+#include "TROOT.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+
+//_________________________________________________________________________
+wignerFrame::wignerFrame(unsigned int nSlots, const std::string &txtinput)
+    : mTable(wignerUtils::getDeuteronTable())
+{
+    if (nSlots == 0)
+    {
+        nSlots = std::max(ROOT::GetThreadPoolSize(), 1u);
+    }
+    mSource.SetFromTxt(txtinput);
+    mSource.setIntegrationRanges(wignerUtils::getMinX(), wignerUtils::getMaxX(), wignerUtils::getMinP(), wignerUtils::getMaxP());
+    mSource.setSteps(wignerUtils::getDx(), wignerUtils::getDp());
+    mSource.setTable(&mTable);
+    mEngines.resize(nSlots);
+    setup();
+}
+//_________________________________________________________________________
+void wignerFrame::setCoalPrecision(double precision)
+{
+    if (precision < 0)
+    {
+        std::cerr << "Error: coal precision is negative\n";
+        std::abort();
+    }
+    mCoalPrecision = precision;
+    setup();
+}
+//_________________________________________________________________________
+void wignerFrame::setLattice(double dk, double dr0)
+{
+    if (dk < 0 || dr0 < 0 || (dk == 0) != (dr0 == 0))
+    {
+        std::cerr << "Error: lattice spacings must be both positive or both 0\n";
+        std::abort();
+    }
+    mDk = dk;
+    mDr0 = dr0;
+    setup();
+}
+//_________________________________________________________________________
+void wignerFrame::setup()
+{
+    mLowRank.reset(mCoalPrecision > 0 ? new wignerLowRankTable(mTable, mCoalPrecision) : nullptr);
+    mSource.setLowRankTable(mLowRank.get());
+    for (std::unique_ptr<engine> &e : mEngines)
+    {
+        e.reset(new engine);
+        e->source = mSource;
+    }
+}
+//_________________________________________________________________________
+const wignerPoint &wignerFrame::node(engine &e, uint32_t i, uint32_t j)
+{
+    uint64_t key = (uint64_t(i) << 32) | j;
+    auto it = e.nodes.find(key);
+    if (it == e.nodes.end())
+    {
+        e.source.setR0(j * mDr0);
+        it = e.nodes.emplace(key, e.source.computePoint(i * mDk)).first;
+    }
+    return it->second;
+}
+//_________________________________________________________________________
+wignerPoint wignerFrame::evaluate(unsigned int slot, double k, double r0)
+{
+    if (slot >= mEngines.size())
+    {
+        std::cerr << "Error: slot " << slot << " out of " << mEngines.size() << " slots of wignerFrame\n";
+        std::abort();
+    }
+    engine &e = *mEngines[slot];
+    wignerPoint pt;
+    pt.k = k;
+    if (!(k > 0) || !(r0 >= 0))
+    {
+        pt.r0 = pt.norm = pt.WW = pt.coal = pt.wK = pt.wV = pt.wH = std::numeric_limits<double>::quiet_NaN();
+        return pt;
+    }
+    if (mDk == 0)
+    {
+        e.source.setR0(r0);
+        pt = e.source.computePoint(k);
+        return pt;
+    }
+
+    // bilinear between the lattice points around (k*, r0); a zero weight needs no point
+    double u = std::max(k / mDk, 1.), v = r0 / mDr0;
+    uint32_t i = uint32_t(u), j = uint32_t(v);
+    double t = u - i, s = v - j;
+    double w[4] = {(1 - t) * (1 - s), t * (1 - s), (1 - t) * s, t * s};
+    pt.r0 = pt.norm = pt.WW = pt.coal = pt.wK = pt.wV = pt.wH = 0;
+    for (int c = 0; c < 4; ++c)
+    {
+        if (w[c] == 0)
+        {
+            continue;
+        }
+        const wignerPoint &n = node(e, i + (c & 1), j + (c >> 1));
+        pt.r0 += w[c] * n.r0;
+        pt.norm += w[c] * n.norm;
+        pt.WW += w[c] * n.WW;
+        pt.coal += w[c] * n.coal;
+        pt.wK += w[c] * n.wK;
+        pt.wV += w[c] * n.wV;
+        pt.wH += w[c] * n.wH;
+    }
+    return pt;
+}
+//_________________________________________________________________________
+double wignerFrame::value(const wignerPoint &pt, observable obs)
+{
+    switch (obs)
+    {
+    case kCoal:
+        return pt.coal;
+    case kWK:
+        return pt.wK;
+    case kWV:
+        return pt.wV;
+    case kWH:
+        return pt.wH;
+    case kR:
+        return pt.r0;
+    }
+    return 0;
+}
+//_________________________________________________________________________
+wignerFrame::vectorColumn wignerFrame::column(observable obs)
+{
+    return [this, obs](unsigned int slot, const ROOT::RVecD &k, const ROOT::RVecD &r0)
+    {
+        if (k.size() != r0.size())
+        {
+            std::cerr << "Error: k* and r0 columns of different sizes (" << k.size() << ", " << r0.size() << ")\n";
+            std::abort();
+        }
+        ROOT::RVecD res(k.size());
+        for (size_t i = 0; i < k.size(); ++i)
+        {
+            res[i] = value(evaluate(slot, k[i], r0[i]), obs);
+        }
+        return res;
+    };
+}
+//_________________________________________________________________________
+wignerFrame::scalarColumn wignerFrame::scalar(observable obs)
+{
+    return [this, obs](unsigned int slot, double k, double r0)
+    { return value(evaluate(slot, k, r0), obs); };
+}
+//_________________________________________________________________________
+unsigned int wignerFrame::getSlots() const
+{
+    return mEngines.size();
+}
+//_________________________________________________________________________
+size_t wignerFrame::getNodes() const
+{
+    size_t n = 0;
+    for (const std::unique_ptr<engine> &e : mEngines)
+    {
+        n += e->nodes.size();
+    }
+    return n;
+}
+//_________________________________________________________________________
+int wignerFrame::getRank() const
+{
+    return mLowRank ? mLowRank->getRank() : 0;
+}
@@ -0,0 +1,375 @@
+#include "CWignerGaussianMixture.h"
+#include "CWignerCore.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+namespace
+{
+    /**
+     * @brief n values from lo to hi in geometric progression.
+     * @param lo First value.
+     * @param hi Last value.
+     * @param n  Number of values.
+     * @return Ladder.
+     */
+    std::vector<double> ladder(double lo, double hi, int n)
+    {
+        std::vector<double> values(n);
+        for (int i = 0; i < n; ++i)
+        {
+            values[i] = n == 1 ? std::sqrt(lo * hi) : lo * std::pow(hi / lo, double(i) / (n - 1));
+        }
+        return values;
+    }
+
+    /**
+     * @brief Thin QR factorization by modified Gram-Schmidt, run twice for orthogonality.
+     * @param m Number of rows.
+     * @param n Number of columns.
+     * @param a Matrix (column-major), replaced by Q.
+     * @param r Upper-triangular R (column-major n x n).
+     */
+    void qr(int m, int n, std::vector<double> &a, std::vector<double> &r)
+    {
+        r.assign(size_t(n) * n, 0.);
+        for (int k = 0; k < n; ++k)
+        {
+            double *q = &a[size_t(m) * k];
+            for (int pass = 0; pass < 2; ++pass)
+            {
+                for (int l = 0; l < k; ++l)
+                {
+                    const double *ql = &a[size_t(m) * l];
+                    double dot = 0;
+                    for (int i = 0; i < m; ++i)
+                    {
+                        dot += ql[i] * q[i];
+                    }
+                    for (int i = 0; i < m; ++i)
+                    {
+                        q[i] -= dot * ql[i];
+                    }
+                    r[l + size_t(n) * k] += dot;
+                }
+            }
+            double norm = 0;
+            for (int i = 0; i < m; ++i)
+            {
+                norm += q[i] * q[i];
+            }
+            norm = std::sqrt(norm);
+            r[k + size_t(n) * k] = norm;
+            for (int i = 0; i < m; ++i)
+            {
+                q[i] = norm > 0 ? q[i] / norm : 0.;
+            }
+        }
+    }
+
+    /**
+     * @brief Solve R x = y for an upper-triangular R, in place.
+     * @param n Size.
+     * @param r R (column-major n x n).
+     * @param x Right-hand side (stride apart), replaced by the solution.
+     * @param stride Distance between consecutive elements of x.
+     */
+    void backSolve(int n, const std::vector<double> &r, double *x, size_t stride)
+    {
+        for (int k = n - 1; k >= 0; --k)
+        {
+            double sum = x[k * stride];
+            for (int l = k + 1; l < n; ++l)
+            {
+                sum -= r[k + size_t(n) * l] * x[l * stride];
+            }
+            double diag = r[k + size_t(n) * k];
+            x[k * stride] = diag != 0 ? sum / diag : 0.;
+        }
+    }
+}
+//_________________________________________________________________________
+wignerGaussianMixture::wignerGaussianMixture(const std::vector<double> &a, const std::vector<double> &b, const std::vector<double> &c,
+                                             double residual)
+    : mA(a), mB(b), mC(c), mResidual(residual)
+{
+    if (a.size() != c.size() || b.size() != c.size())
+    {
+        std::cerr << "Error: inconsistent Gaussian mixture components\n";
+        std::abort();
+    }
+    for (size_t i = 0; i < c.size(); ++i)
+    {
+        if (a[i] <= 0 || b[i] <= 0)
+        {
+            std::cerr << "Error: Gaussian mixture widths must be positive\n";
+            std::abort();
+        }
+    }
+    // the fit gives a tensor basis: few distinct widths, each shared by many components
+    auto index = [](const std::vector<double> &values, std::vector<double> &distinct, std::vector<int> &idx)
+    {
+        for (double v : values)
+        {
+            auto it = std::find(distinct.begin(), distinct.end(), v);
+            idx.push_back(int(it - distinct.begin()));
+            if (it == distinct.end())
+            {
+                distinct.push_back(v);
+            }
+        }
+    };
+    index(mA, mWidthsA, mIndexA);
+    index(mB, mWidthsB, mIndexB);
+}
+//_________________________________________________________________________
+wignerGaussianMixture wignerGaussianMixture::fit(const wignerTable &table, double tolerance, int maxWidths)
+{
+    const int nx = table.getNx(), ny = table.getNy();
+    if (nx < 2 || ny < 2 || maxWidths < 1)
+    {
+        std::cerr << "Error: the table needs at least 2 x 2 bins for the Gaussian mixture fit\n";
+        std::abort();
+    }
+
+    // square roots of the r² p² weights, and the weighted table
+    std::vector<double> x(nx), y(ny);
+    for (int i = 0; i < nx; ++i)
+    {
+        x[i] = table.getXCenter(i + 1);
+    }
+    for (int j = 0; j < ny; ++j)
+    {
+        y[j] = table.getYCenter(j + 1);
+    }
+    std::vector<double> t(size_t(nx) * ny);
+    double tNorm = 0;
+    for (int j = 0; j < ny; ++j)
+    {
+        for (int i = 0; i < nx; ++i)
+        {
+            double v = x[i] * y[j] * table.getBinContent(i + 1, j + 1);
+            t[i + size_t(nx) * j] = v;
+            tNorm += v * v;
+        }
+    }
+    if (tNorm <= 0)
+    {
+        std::cerr << "Error: the table to fit is zero\n";
+        std::abort();
+    }
+
+    // widths from two bins to half the range of each axis
+    const double sMin = 2 * (x[1] - x[0]), sMax = 0.5 * x[nx - 1];
+    const double tMin = 2 * (y[1] - y[0]), tMax = 0.5 * y[ny - 1];
+
+    wignerGaussianMixture best;
+    for (int nw = std::min(2, maxWidths); nw <= maxWidths; ++nw)
+    {
+        std::vector<double> s = ladder(sMin, sMax, nw), w = ladder(tMin, tMax, nw);
+        std::vector<double> a(nw), b(nw);
+        std::vector<double> qf(size_t(nx) * nw), qg(size_t(ny) * nw), rf, rg;
+        for (int k = 0; k < nw; ++k)
+        {
+            a[k] = 1 / (s[k] * s[k]);
+            b[k] = 1 / (w[k] * w[k]);
+            for (int i = 0; i < nx; ++i)
+            {
+                qf[i + size_t(nx) * k] = x[i] * std::exp(-a[k] * x[i] * x[i]);
+            }
+            for (int j = 0; j < ny; ++j)
+            {
+                qg[j + size_t(ny) * k] = y[j] * std::exp(-b[k] * y[j] * y[j]);
+            }
+        }
+        qr(nx, nw, qf, rf);
+        qr(ny, nw, qg, rg);
+
+        // projection of the table on the tensor basis: QF^T T QG
+        std::vector<double> m1(size_t(nw) * ny, 0.), m2(size_t(nw) * nw, 0.);
+        for (int j = 0; j < ny; ++j)
+        {
+            for (int k = 0; k < nw; ++k)
+            {
+                double sum = 0;
+                for (int i = 0; i < nx; ++i)
+                {
+                    sum += qf[i + size_t(nx) * k] * t[i + size_t(nx) * j];
+                }
+                m1[k + size_t(nw) * j] = sum;
+            }
+        }
+        double projected = 0;
+        for (int l = 0; l < nw; ++l)
+        {
+            for (int k = 0; k < nw; ++k)
+            {
+                double sum = 0;
+                for (int j = 0; j < ny; ++j)
+                {
+                    sum += m1[k + size_t(nw) * j] * qg[j + size_t(ny) * l];
+                }
+                m2[k + size_t(nw) * l] = sum;
+                projected += sum * sum;
+            }
+        }
+        // the fit is the orthogonal projection: |T - fit|² = |T|² - |QF^T T QG|²
+        double residual = std::sqrt(std::max(0., tNorm - projected) / tNorm);
+
+        // C = RF^-1 (QF^T T QG) RG^-T
+        for (int l = 0; l < nw; ++l)
+        {
+            backSolve(nw, rf, &m2[size_t(nw) * l], 1);
+        }
+        for (int k = 0; k < nw; ++k)
+        {
+            backSolve(nw, rg, &m2[k], nw);
+        }
+
+        std::vector<double> ca, cb, cc;
+        for (int l = 0; l < nw; ++l)
+        {
+            for (int k = 0; k < nw; ++k)
+            {
+                ca.push_back(a[k]);
+                cb.push_back(b[l]);
+                cc.push_back(m2[k + size_t(nw) * l]);
+            }
+        }
+        best = wignerGaussianMixture(ca, cb, cc, residual);
+        std::cout << "Gaussian mixture with " << nw << " x " << nw << " components: relative residual " << residual << "\n";
+        if (residual <= tolerance)
+        {
+            break;
+        }
+    }
+    return best;
+}
+//_________________________________________________________________________
+wignerGaussianMixture wignerGaussianMixture::read(const std::string &filename)
+{
+    std::ifstream infile(filename);
+    if (!infile.is_open())
+    {
+        std::cerr << "Could not open file: " << filename << "\n";
+        throw std::runtime_error("File open failed.");
+    }
+    std::vector<double> a, b, c;
+    double residual = 0;
+    std::string line;
+    while (std::getline(infile, line))
+    {
+        if (line.empty() || line[0] == '#')
+        {
+            continue;
+        }
+        std::istringstream iss(line);
+        std::string key;
+        if (line.compare(0, 8, "residual") == 0)
+        {
+            iss >> key >> residual;
+            continue;
+        }
+        double va, vb, vc;
+        if (!(iss >> va >> vb >> vc))
+        {
+            std::cerr << "Warning: skipping invalid line: " << line << "\n";
+            continue;
+        }
+        a.push_back(va);
+        b.push_back(vb);
+        c.push_back(vc);
+    }
+    return wignerGaussianMixture(a, b, c, residual);
+}
+//_________________________________________________________________________
+bool wignerGaussianMixture::write(const std::string &filename) const
+{
+    std::ofstream out(filename);
+    if (!out.is_open())
+    {
+        std::cerr << "Error: could not create " << filename << "\n";
+        return false;
+    }
+    out << "# Gaussian mixture of the deuteron Wigner function, W_d(r, p) = sum c exp(-a r^2 - b p^2)\n"
+        << "# a (fm^-2)  b ((GeV/c)^-2)  c\n"
+        << std::setprecision(17)
+        << "residual " << mResidual << "\n";
+    for (size_t i = 0; i < mC.size(); ++i)
+    {
+        out << mA[i] << " " << mB[i] << " " << mC[i] << "\n";
+    }
+    return bool(out);
+}
+//_________________________________________________________________________
+double wignerGaussianMixture::evaluate(double r, double p) const
+{
+    double res = 0;
+    for (size_t i = 0; i < mC.size(); ++i)
+    {
+        res += mC[i] * std::exp(-mA[i] * r * r - mB[i] * p * p);
+    }
+    return res;
+}
+//_________________________________________________________________________
+double wignerGaussianMixture::coal(double radius, double kStar, double norm) const
+{
+    const double pi = wignerCore::kPi;
+    const double beta = 4 * radius * radius / (wignerCore::kHCut * wignerCore::kHCut);
+    double fr[64], fp[64];
+    std::vector<double> heapR, heapP;
+    double *factorR = fr, *factorP = fp;
+    if (mWidthsA.size() > 64 || mWidthsB.size() > 64)
+    {
+        heapR.resize(mWidthsA.size());
+        heapP.resize(mWidthsB.size());
+        factorR = heapR.data();
+        factorP = heapP.data();
+    }
+    for (size_t i = 0; i < mWidthsA.size(); ++i)
+    {
+        double rr = pi / (0.25 / (radius * radius) + mWidthsA[i]);
+        factorR[i] = rr * std::sqrt(rr);
+    }
+    for (size_t i = 0; i < mWidthsB.size(); ++i)
+    {
+        double b = mWidthsB[i];
+        double pp = pi / (beta + b);
+        factorP[i] = pp * std::sqrt(pp) * std::exp(-beta * b * kStar * kStar / (beta + b));
+    }
+    double res = 0;
+    for (size_t i = 0; i < mC.size(); ++i)
+    {
+        res += mC[i] * factorR[mIndexA[i]] * factorP[mIndexB[i]];
+    }
+    // (2πħ)³ times the 1 / (πħ)³ of the source
+    return 8 * norm * res;
+}
+//_________________________________________________________________________
+double wignerGaussianMixture::computeCoal(double k, double r0) const
+{
+    double radius = wignerCore::radius(k, r0);
+    return coal(radius, wignerCore::kStarEff(k, radius));
+}
+//_________________________________________________________________________
+size_t wignerGaussianMixture::size() const
+{
+    return mC.size();
+}
+//_________________________________________________________________________
+double wignerGaussianMixture::getResidual() const
+{
+    return mResidual;
+}
+//_________________________________________________________________________
+uint64_t wignerGaussianMixture::checksum() const
+{
+    uint64_t h = wignerCore::hash(mA.data(), mA.size() * sizeof(double));
+    h = wignerCore::hash(mB.data(), mB.size() * sizeof(double), h);
+    return wignerCore::hash(mC.data(), mC.size() * sizeof(double), h);
+}
@@ -0,0 +1,431 @@
+#include "CWignerLowRankTable.h"
+#include "CWignerCore.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+//_________________________________________________________________________
+wignerLowRankTable::wignerLowRankTable(const wignerTable &table, double tolerance, int maxRank)
+{
+    if (tolerance < 0 || maxRank < 1)
+    {
+        std::cerr << "Error: invalid tolerance or rank of the low-rank table\n";
+        std::abort();
+    }
+    if (table.empty())
+    {
+        return;
+    }
+    mNx = table.getNx();
+    mXMin = table.getXMin();
+    mXMax = table.getXMax();
+    mNy = table.getNy();
+    mYMin = table.getYMin();
+    mYMax = table.getYMax();
+
+    // Gram matrix of the smaller dimension: its eigenvalues are the σ²
+    bool rows = mNx <= mNy;
+    int n = rows ? mNx : mNy, m = rows ? mNy : mNx;
+    auto t = [&](int a, int b)
+    { return rows ? table.getBinContent(a + 1, b + 1) : table.getBinContent(b + 1, a + 1); };
+    std::vector<double> gram(size_t(n) * n, 0.);
+    for (int a = 0; a < n; ++a)
+    {
+        for (int b = a; b < n; ++b)
+        {
+            double sum = 0;
+            for (int c = 0; c < m; ++c)
+            {
+                sum += t(a, c) * t(b, c);
+            }
+            gram[a + size_t(n) * b] = gram[b + size_t(n) * a] = sum;
+        }
+    }
+    std::vector<double> lambda;
+    eigen(n, gram, lambda);
+
+    double total = 0;
+    for (double l : lambda)
+    {
+        total += std::max(l, 0.);
+    }
+    if (total == 0)
+    {
+        return;
+    }
+
+    // keep the largest eigenvalues until the rest is below the tolerance
+    double rest = total;
+    for (int k = n - 1; k >= 0 && n - 1 - k < maxRank; --k)
+    {
+        if (std::sqrt(std::max(rest, 0.) / total) <= tolerance)
+        {
+            break;
+        }
+        double sigma = std::sqrt(std::max(lambda[k], 0.));
+        rest -= std::max(lambda[k], 0.);
+        if (sigma == 0)
+        {
+            break;
+        }
+        // the other singular vector is T x / σ
+        std::vector<double> x(gram.begin() + size_t(n) * k, gram.begin() + size_t(n) * (k + 1));
+        std::vector<double> y(m, 0.);
+        for (int c = 0; c < m; ++c)
+        {
+            for (int a = 0; a < n; ++a)
+            {
+                y[c] += t(a, c) * x[a];
+            }
+            y[c] /= sigma;
+        }
+        mSigma.push_back(sigma);
+        std::vector<double> &u = rows ? x : y, &v = rows ? y : x;
+        mU.insert(mU.end(), u.begin(), u.end());
+        mV.insert(mV.end(), v.begin(), v.end());
+    }
+    mError = std::sqrt(std::max(rest, 0.) / total);
+}
+//_________________________________________________________________________
+void wignerLowRankTable::eigen(int n, std::vector<double> &a, std::vector<double> &d)
+{
+    // Householder reduction to tridiagonal form and implicit QL (tred2 / tql2)
+    std::vector<double> e(n, 0.);
+    d.assign(n, 0.);
+    auto z = [&](int i, int j) -> double &
+    { return a[i + size_t(n) * j]; };
+    for (int j = 0; j < n; ++j)
+    {
+        d[j] = z(n - 1, j);
+    }
+    for (int i = n - 1; i > 0; --i)
+    {
+        double scale = 0, h = 0;
+        for (int k = 0; k < i; ++k)
+        {
+            scale += std::fabs(d[k]);
+        }
+        if (scale == 0)
+        {
+            e[i] = d[i - 1];
+            for (int j = 0; j < i; ++j)
+            {
+                d[j] = z(i - 1, j);
+                z(i, j) = 0;
+                z(j, i) = 0;
+            }
+        }
+        else
+        {
+            for (int k = 0; k < i; ++k)
+            {
+                d[k] /= scale;
+                h += d[k] * d[k];
+            }
+            double f = d[i - 1];
+            double g = f > 0 ? -std::sqrt(h) : std::sqrt(h);
+            e[i] = scale * g;
+            h -= f * g;
+            d[i - 1] = f - g;
+            for (int j = 0; j < i; ++j)
+            {
+                e[j] = 0;
+            }
+            for (int j = 0; j < i; ++j)
+            {
+                f = d[j];
+                z(j, i) = f;
+                g = e[j] + z(j, j) * f;
+                for (int k = j + 1; k <= i - 1; ++k)
+                {
+                    g += z(k, j) * d[k];
+                    e[k] += z(k, j) * f;
+                }
+                e[j] = g;
+            }
+            f = 0;
+            for (int j = 0; j < i; ++j)
+            {
+                e[j] /= h;
+                f += e[j] * d[j];
+            }
+            double hh = f / (h + h);
+            for (int j = 0; j < i; ++j)
+            {
+                e[j] -= hh * d[j];
+            }
+            for (int j = 0; j < i; ++j)
+            {
+                f = d[j];
+                g = e[j];
+                for (int k = j; k <= i - 1; ++k)
+                {
+                    z(k, j) -= f * e[k] + g * d[k];
+                }
+                d[j] = z(i - 1, j);
+                z(i, j) = 0;
+            }
+        }
+        d[i] = h;
+    }
+    for (int i = 0; i < n - 1; ++i)
+    {
+        z(n - 1, i) = z(i, i);
+        z(i, i) = 1;
+        double h = d[i + 1];
+        if (h != 0)
+        {
+            for (int k = 0; k <= i; ++k)
+            {
+                d[k] = z(k, i + 1) / h;
+            }
+            for (int j = 0; j <= i; ++j)
+            {
+                double g = 0;
+                for (int k = 0; k <= i; ++k)
+                {
+                    g += z(k, i + 1) * z(k, j);
+                }
+                for (int k = 0; k <= i; ++k)
+                {
+                    z(k, j) -= g * d[k];
+                }
+            }
+        }
+        for (int k = 0; k <= i; ++k)
+        {
+            z(k, i + 1) = 0;
+        }
+    }
+    for (int j = 0; j < n; ++j)
+    {
+        d[j] = z(n - 1, j);
+        z(n - 1, j) = 0;
+    }
+    z(n - 1, n - 1) = 1;
+    e[0] = 0;
+
+    for (int i = 1; i < n; ++i)
+    {
+        e[i - 1] = e[i];
+    }
+    e[n - 1] = 0;
+    double f = 0, tst1 = 0;
+    const double eps = std::pow(2., -52.);
+    for (int l = 0; l < n; ++l)
+    {
+        tst1 = std::max(tst1, std::fabs(d[l]) + std::fabs(e[l]));
+        int m = l;
+        while (m < n && std::fabs(e[m]) > eps * tst1)
+        {
+            ++m;
+        }
+        m = std::min(m, n - 1);
+        if (m > l)
+        {
+            do
+            {
+                double g = d[l];
+                double p = (d[l + 1] - g) / (2 * e[l]);
+                double r = std::hypot(p, 1.);
+                if (p < 0)
+                {
+                    r = -r;
+                }
+                d[l] = e[l] / (p + r);
+                d[l + 1] = e[l] * (p + r);
+                double dl1 = d[l + 1];
+                double h = g - d[l];
+                for (int i = l + 2; i < n; ++i)
+                {
+                    d[i] -= h;
+                }
+                f += h;
+
+                p = d[m];
+                double c = 1, c2 = 1, c3 = 1, s = 0, s2 = 0;
+                double el1 = e[l + 1];
+                for (int i = m - 1; i >= l; --i)
+                {
+                    c3 = c2;
+                    c2 = c;
+                    s2 = s;
+                    g = c * e[i];
+                    h = c * p;
+                    r = std::hypot(p, e[i]);
+                    e[i + 1] = s * r;
+                    s = e[i] / r;
+                    c = p / r;
+                    p = c * d[i] - s * g;
+                    d[i + 1] = h + s * (c * g + s * d[i]);
+                    for (int k = 0; k < n; ++k)
+                    {
+                        h = z(k, i + 1);
+                        z(k, i + 1) = s * z(k, i) + c * h;
+                        z(k, i) = c * z(k, i) - s * h;
+                    }
+                }
+                p = -s * s2 * c3 * el1 * e[l] / dl1;
+                e[l] = s * p;
+                d[l] = c * p;
+            } while (std::fabs(e[l]) > eps * tst1);
+        }
+        d[l] += f;
+        e[l] = 0;
+    }
+
+    // increasing order
+    for (int i = 0; i < n - 1; ++i)
+    {
+        int k = i;
+        for (int j = i + 1; j < n; ++j)
+        {
+            if (d[j] < d[k])
+            {
+                k = j;
+            }
+        }
+        if (k != i)
+        {
+            std::swap(d[k], d[i]);
+            for (int j = 0; j < n; ++j)
+            {
+                std::swap(z(j, i), z(j, k));
+            }
+        }
+    }
+}
+//_________________________________________________________________________
+bool wignerLowRankTable::weights(double x, int n, double lo, double hi, int &b1, int &b2, double &w1, double &w2)
+{
+    b1 = b2 = 0;
+    w1 = w2 = 0;
+    if (!(x >= lo && x < hi))
+    {
+        return false;
+    }
+    double width = (hi - lo) / double(n);
+    auto center = [&](int i)
+    { return lo + (i - 1) * width + 0.5 * width; };
+    auto find = [&](double c)
+    { return c < lo ? 0 : (!(c < hi) ? n + 1 : 1 + int(n * (c - lo) / (hi - lo))); };
+    int bin = find(x);
+    int i1 = (lo + bin * width) - x <= width / 2 ? bin : bin - 1;
+    double x1 = center(i1), x2 = center(i1 + 1);
+    b1 = std::max(find(x1), 1) - 1;
+    b2 = std::min(find(x2), n) - 1;
+    w1 = (x2 - x) / (x2 - x1);
+    w2 = (x - x1) / (x2 - x1);
+    return true;
+}
+//_________________________________________________________________________
+double wignerLowRankTable::interpolate(double x, double y) const
+{
+    int i1, i2, j1, j2;
+    double wx1, wx2, wy1, wy2;
+    if (!weights(x, mNx, mXMin, mXMax, i1, i2, wx1, wx2) || !weights(y, mNy, mYMin, mYMax, j1, j2, wy1, wy2))
+    {
+        return 0;
+    }
+    double res = 0;
+    for (size_t k = 0; k < mSigma.size(); ++k)
+    {
+        const double *u = &mU[k * mNx], *v = &mV[k * mNy];
+        res += mSigma[k] * (wx1 * u[i1] + wx2 * u[i2]) * (wy1 * v[j1] + wy2 * v[j2]);
+    }
+    return res;
+}
+//_________________________________________________________________________
+void wignerLowRankTable::project(const std::vector<double> &r, const std::vector<double> &p, std::vector<double> &u, std::vector<double> &v) const
+{
+    const size_t rank = mSigma.size();
+    u.assign(rank * r.size(), 0.);
+    v.assign(rank * p.size(), 0.);
+    int b1, b2;
+    double w1, w2;
+    for (size_t i = 0; i < r.size(); ++i)
+    {
+        if (weights(r[i], mNx, mXMin, mXMax, b1, b2, w1, w2))
+        {
+            for (size_t k = 0; k < rank; ++k)
+            {
+                u[k * r.size() + i] = mSigma[k] * (w1 * mU[k * mNx + b1] + w2 * mU[k * mNx + b2]);
+            }
+        }
+    }
+    for (size_t j = 0; j < p.size(); ++j)
+    {
+        if (weights(p[j], mNy, mYMin, mYMax, b1, b2, w1, w2))
+        {
+            for (size_t k = 0; k < rank; ++k)
+            {
+                v[k * p.size() + j] = w1 * mV[k * mNy + b1] + w2 * mV[k * mNy + b2];
+            }
+        }
+    }
+}
+//_________________________________________________________________________
+void wignerLowRankTable::projectGrid(double minX, double maxX, double minP, double maxP, double dx, double dp,
+                                     std::vector<double> &r, std::vector<double> &p, std::vector<double> &u, std::vector<double> &v) const
+{
+    std::vector<double> rBreaks, pBreaks, rWidths, pWidths;
+    getBreaks(rBreaks, pBreaks);
+    wignerCore::gridNodes(minX, maxX, rBreaks, dx, r, rWidths);
+    wignerCore::gridNodes(minP, maxP, pBreaks, dp, p, pWidths);
+    project(r, p, u, v);
+    const size_t nr = r.size(), np = p.size();
+    for (size_t k = 0; k < mSigma.size(); ++k)
+    {
+        for (size_t i = 0; i < nr; ++i)
+        {
+            u[k * nr + i] *= r[i] * r[i] * rWidths[i];
+        }
+        for (size_t j = 0; j < np; ++j)
+        {
+            v[k * np + j] *= pWidths[j];
+        }
+    }
+}
+//_________________________________________________________________________
+double wignerLowRankTable::coal(const std::vector<double> &u, const std::vector<double> &v, const std::vector<double> &f, const std::vector<double> &g) const
+{
+    const size_t nr = f.size(), np = g.size();
+    double res = 0;
+    for (size_t k = 0; k < mSigma.size(); ++k)
+    {
+        double a = 0, b = 0;
+        for (size_t i = 0; i < nr; ++i)
+        {
+            a += u[k * nr + i] * f[i];
+        }
+        for (size_t j = 0; j < np; ++j)
+        {
+            b += v[k * np + j] * g[j];
+        }
+        res += a * b;
+    }
+    return res;
+}
+//_________________________________________________________________________
+void wignerLowRankTable::getBreaks(std::vector<double> &rBreaks, std::vector<double> &pBreaks) const
+{
+    double wx = (mXMax - mXMin) / double(mNx), wy = (mYMax - mYMin) / double(mNy);
+    rBreaks = {mXMin + 0.5 * wx, mXMin + (mNx - 1) * wx + 0.5 * wx, mXMax};
+    pBreaks = {mYMin + 0.5 * wy, mYMin + (mNy - 1) * wy + 0.5 * wy, mYMax};
+}
+//_________________________________________________________________________
+int wignerLowRankTable::getRank() const
+{
+    return int(mSigma.size());
+}
+//_________________________________________________________________________
+double wignerLowRankTable::getError() const
+{
+    return mError;
+}
+//_________________________________________________________________________
+const std::vector<double> &wignerLowRankTable::getSingularValues() const
+{
+    return mSigma;
+}
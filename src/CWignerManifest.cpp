@@ -0,0 +1,322 @@
+#include "CWignerManifest.h"
+#include "CWignerCore.h"
+#include "CWignerScan.h"
+#include "CWignerUtils.h"
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+
+//_________________________________________________________________________
+std::string wignerScanSettings::str() const
+{
+    std::ostringstream out;
+    out << std::setprecision(17);
+    if (testMode)
+    {
+        out << " test_mode=1";
+    }
+    if (!radii.empty())
+    {
+        out << " radii=";
+        for (size_t i = 0; i < radii.size(); ++i)
+        {
+            out << (i ? "," : "") << radii[i];
+        }
+    }
+    if (!shape.empty())
+    {
+        out << " shape=" << shape;
+    }
+    if (!potential.empty())
+    {
+        out << " potential=" << potential;
+    }
+    if (!nucleus.empty())
+    {
+        out << " nucleus=" << nucleus;
+    }
+    if (!nucleusTable.empty())
+    {
+        out << " nucleus_table=" << nucleusTable;
+    }
+    // the Monte Carlo only runs for an A = 3 nucleus
+    if ((!nucleus.empty() || !nucleusTable.empty()) && tolerance != wignerScanSettings().tolerance)
+    {
+        out << " mc_tolerance=" << tolerance;
+    }
+    std::string text = out.str();
+    return text.empty() ? text : text.substr(1);
+}
+//_________________________________________________________________________
+std::vector<std::string> wignerScanSettings::files() const
+{
+    std::vector<std::string> names;
+    if (potential.compare(0, 6, "table:") == 0)
+    {
+        names.push_back(potential.substr(6));
+    }
+    if (!nucleusTable.empty())
+    {
+        names.push_back(nucleusTable);
+    }
+    return names;
+}
+//_________________________________________________________________________
+wignerManifest wignerManifest::create(double start, double end, double step, int nShards,
+                                      const std::string &config, const std::string &prefix, const std::string &deuteron,
+                                      const wignerScanSettings &settings)
+{
+    wignerManifest m;
+    m.start = start;
+    m.end = end;
+    m.step = step;
+    m.config = config;
+    m.deuteron = deuteron;
+    m.settings = settings;
+    m.configHash = configHashOf(config, settings);
+    m.points = wignerScan::kGrid(start, end, step).size();
+
+    if (m.points == 0 || nShards < 1)
+    {
+        return m;
+    }
+    if (nShards > m.points)
+    {
+        nShards = m.points;
+    }
+
+    long base = m.points / nShards;
+    long extra = m.points % nShards;
+    long first = 0;
+    for (int i = 0; i < nShards; ++i)
+    {
+        wignerShard s;
+        s.index = i;
+        s.first = first;
+        s.count = base + (i < extra ? 1 : 0);
+        s.kMin = m.kAt(s.first);
+        s.kMax = m.kAt(s.first + s.count - 1);
+        s.output = prefix + "_part_" + std::to_string(i) + ".root";
+        m.shards.push_back(s);
+        first += s.count;
+    }
+    return m;
+}
+//_________________________________________________________________________
+wignerManifest wignerManifest::read(const std::string &filename)
+{
+    std::ifstream infile(filename);
+    if (!infile.is_open())
+    {
+        std::cerr << "Could not open manifest: " << filename << "\n";
+        throw std::runtime_error("Manifest open failed.");
+    }
+
+    wignerManifest m;
+    int nShards = -1;
+    std::string line;
+    while (std::getline(infile, line))
+    {
+        if (line.empty() || line[0] == '#')
+        {
+            continue;
+        }
+        std::istringstream iss(line);
+        std::string key;
+        iss >> key;
+        if (key == "shard")
+        {
+            wignerShard s;
+            if (!(iss >> s.index >> s.first >> s.count >> s.kMin >> s.kMax >> s.output))
+            {
+                throw std::runtime_error("Invalid shard line in manifest: " + line);
+            }
+            m.shards.push_back(s);
+            continue;
+        }
+
+        std::string eq, value;
+        if (!(iss >> eq >> value) || eq != "=")
+        {
+            std::cerr << "Warning: skipping invalid manifest line: " << line << "\n";
+            continue;
+        }
+        if (key == "start")
+            m.start = std::stod(value);
+        else if (key == "end")
+            m.end = std::stod(value);
+        else if (key == "step")
+            m.step = std::stod(value);
+        else if (key == "points")
+            m.points = std::stol(value);
+        else if (key == "config")
+            m.config = value;
+        else if (key == "deuteron")
+            m.deuteron = value;
+        else if (key == "test_mode")
+            m.settings.testMode = value == "1";
+        else if (key == "radii")
+        {
+            std::stringstream ss(value);
+            std::string item;
+            while (std::getline(ss, item, ','))
+                m.settings.radii.push_back(std::stod(item));
+        }
+        else if (key == "shape")
+            m.settings.shape = value;
+        else if (key == "potential")
+            m.settings.potential = value;
+        else if (key == "nucleus")
+            m.settings.nucleus = value;
+        else if (key == "nucleus_table")
+            m.settings.nucleusTable = value;
+        else if (key == "mc_tolerance")
+            m.settings.tolerance = std::stod(value);
+        else if (key == "config_hash")
+            m.configHash = std::stoull(value, nullptr, 16);
+        else if (key == "shards")
+            nShards = std::stoi(value);
+    }
+
+    if (nShards != (int)m.shards.size())
+    {
+        throw std::runtime_error("Manifest " + filename + " declares " + std::to_string(nShards) +
+                                 " shards but lists " + std::to_string(m.shards.size()));
+    }
+    for (size_t i = 0; i < m.shards.size(); ++i)
+    {
+        if (m.shards[i].index != (int)i)
+        {
+            throw std::runtime_error("Manifest " + filename + " has shards out of order");
+        }
+    }
+    return m;
+}
+//_________________________________________________________________________
+bool wignerManifest::write(const std::string &filename) const
+{
+    // written next to the target and renamed, so that nodes never read a partial manifest
+    std::string tmp = filename + ".tmp";
+    {
+        std::ofstream out(tmp);
+        if (!out.is_open())
+        {
+            std::cerr << "Could not write manifest: " << filename << "\n";
+            return false;
+        }
+        out << "# wignersim shard manifest\n"
+            << std::setprecision(17)
+            << "start = " << start << "\n"
+            << "end = " << end << "\n"
+            << "step = " << step << "\n"
+            << "config = " << config << "\n";
+        if (!deuteron.empty())
+        {
+            out << "deuteron = " << deuteron << "\n";
+        }
+        // one `key = value` line per item of the settings
+        std::istringstream items(settings.str());
+        std::string item;
+        while (items >> item)
+        {
+            size_t eq = item.find('=');
+            out << item.substr(0, eq) << " = " << item.substr(eq + 1) << "\n";
+        }
+        out << "config_hash = " << std::hex << std::setw(16) << std::setfill('0') << configHash
+            << std::dec << std::setfill(' ') << "\n"
+            << "points = " << points << "\n"
+            << "shards = " << shards.size() << "\n";
+        for (const auto &s : shards)
+        {
+            out << "shard " << s.index << " " << s.first << " " << s.count << " "
+                << s.kMin << " " << s.kMax << " " << s.output << "\n";
+        }
+        if (!out.good())
+        {
+            return false;
+        }
+    }
+    return std::rename(tmp.c_str(), filename.c_str()) == 0;
+}
+//_________________________________________________________________________
+double wignerManifest::kAt(long i) const
+{
+    return start + i * step;
+}
+//_________________________________________________________________________
+std::vector<double> wignerManifest::kValues(int shard) const
+{
+    std::vector<double> values;
+    if (shard < 0 || shard >= (int)shards.size())
+    {
+        return values;
+    }
+    const wignerShard &s = shards[shard];
+    for (long i = 0; i < s.count; ++i)
+    {
+        values.push_back(kAt(s.first + i));
+    }
+    return values;
+}
+//_________________________________________________________________________
+bool wignerManifest::configMatches() const
+{
+    return configHashOf(config, settings) == configHash;
+}
+//_________________________________________________________________________
+std::string wignerManifest::stamp() const
+{
+    std::ostringstream out;
+    out << std::hex << std::setw(16) << std::setfill('0') << configHash << " " << settings.str();
+    return out.str();
+}
+//_________________________________________________________________________
+uint64_t wignerManifest::configHashOf(const std::string &config, const wignerScanSettings &settings)
+{
+    uint64_t h = fileHash(config);
+    if (h == 0)
+    {
+        return 0;
+    }
+    // the table changes the results as much as the parameters do
+    unsigned long long checksum = wignerUtils::getDeuteronChecksum();
+    h = hash(&checksum, sizeof(checksum), h);
+
+    // default settings leave the hash of older manifests unchanged
+    std::string text = settings.str();
+    if (text.empty())
+    {
+        return h;
+    }
+    h = hash(text.data(), text.size(), h);
+    for (const auto &name : settings.files())
+    {
+        uint64_t content = fileHash(name);
+        if (content == 0)
+        {
+            return 0;
+        }
+        h = hash(&content, sizeof(content), h);
+    }
+    return h;
+}
+//_________________________________________________________________________
+uint64_t wignerManifest::hash(const void *data, size_t size, uint64_t seed)
+{
+    return wignerCore::hash(data, size, seed);
+}
+//_________________________________________________________________________
+uint64_t wignerManifest::fileHash(const std::string &filename)
+{
+    std::ifstream infile(filename, std::ios::binary);
+    if (!infile.is_open())
+    {
+        return 0;
+    }
+    std::string content((std::istreambuf_iterator<char>(infile)), std::istreambuf_iterator<char>());
+    return hash(content.data(), content.size());
+}
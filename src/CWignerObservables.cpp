@@ -0,0 +1,92 @@
+#include "CWignerObservables.h"
+#include "TFormula.h"
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <sstream>
+
+//_________________________________________________________________________
+void wignerObservables::add(const std::string &name, integrand f, int factors)
+{
+    if (name.empty() || !f || factors < 0 || factors > kAll)
+    {
+        std::cerr << "Error: invalid observable " << name << "\n";
+        std::abort();
+    }
+    mNames.push_back(name);
+    mIntegrands.push_back(std::move(f));
+    mFactors.push_back(factors);
+}
+//_________________________________________________________________________
+bool wignerObservables::add(const std::string &name, const std::string &formula, int factors)
+{
+    std::shared_ptr<TFormula> tf(new TFormula(("obs_" + name).c_str(), formula.c_str()));
+    if (!tf->IsValid() || tf->GetNpar() > 0 || tf->GetNdim() > 2)
+    {
+        std::cerr << "Error: invalid formula " << formula << " for observable " << name << "\n";
+        return false;
+    }
+    // the first evaluation compiles the formula: done here, before the workers share it
+    double x[2] = {1., 0.1};
+    tf->EvalPar(x);
+    add(name, [tf](double r, double p)
+        {
+            double x[2] = {r, p};
+            return tf->EvalPar(x); },
+        factors);
+    return true;
+}
+//_________________________________________________________________________
+bool wignerObservables::add(const std::string &spec)
+{
+    size_t first = spec.find(':'), second = first == std::string::npos ? first : spec.find(':', first + 1);
+    if (second == std::string::npos)
+    {
+        std::cerr << "Error: observable " << spec << " is not <name>:<factors>:<formula>\n";
+        return false;
+    }
+    int factors = kNone;
+    std::stringstream ss(spec.substr(first + 1, second - first - 1));
+    std::string item;
+    while (std::getline(ss, item, ','))
+    {
+        if (item == "source")
+        {
+            factors |= kSource;
+        }
+        else if (item == "jacobian")
+        {
+            factors |= kJacobian;
+        }
+        else if (item == "deuteron")
+        {
+            factors |= kDeuteron;
+        }
+        else if (item != "none")
+        {
+            std::cerr << "Error: unknown factor " << item << " in observable " << spec << "\n";
+            return false;
+        }
+    }
+    return add(spec.substr(0, first), spec.substr(second + 1), factors);
+}
+//_________________________________________________________________________
+size_t wignerObservables::size() const
+{
+    return mNames.size();
+}
+//_________________________________________________________________________
+const std::vector<std::string> &wignerObservables::getNames() const
+{
+    return mNames;
+}
+//_________________________________________________________________________
+int wignerObservables::getFactors() const
+{
+    int factors = kNone;
+    for (int f : mFactors)
+    {
+        factors |= f;
+    }
+    return factors;
+}
@@ -0,0 +1,71 @@
+#include "CWignerOverlap.h"
+#include "CWignerCore.h"
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+//_________________________________________________________________________
+wignerOverlap::wignerOverlap(double step, const std::vector<double> &u, const std::vector<double> &w)
+    : mStep(step), mU(u), mW(w)
+{
+    if (step <= 0 || (!w.empty() && w.size() != u.size()))
+    {
+        std::cerr << "Error: invalid wavefunction grid of the overlap\n";
+        std::abort();
+    }
+}
+//_________________________________________________________________________
+double wignerOverlap::besselJ2(double x)
+{
+    if (x < 1E-3)
+    {
+        return x * x / 15;
+    }
+    double s = std::sin(x), c = std::cos(x);
+    return (3 / (x * x) - 1) * s / x - 3 * c / (x * x);
+}
+//_________________________________________________________________________
+double wignerOverlap::coal(double radius, double kStar) const
+{
+    const double hc = wignerCore::kHCut;
+    const double norm = std::pow(4 * wignerCore::kPi * radius * radius, -0.75);
+    // G(r) < 1e-16 of its maximum beyond 17 R
+    const double rCut = 17 * radius;
+
+    // trapezoidal rule; the integrands vanish at r = 0
+    double i0 = 0, i2 = 0;
+    for (size_t i = 1; i < mU.size(); ++i)
+    {
+        double r = i * mStep;
+        if (r > rCut)
+        {
+            break;
+        }
+        double weight = (i + 1 == mU.size() ? 0.5 : 1.) * r * norm * std::exp(-r * r / (8 * radius * radius));
+        double x = kStar * r / hc;
+        i0 += weight * mU[i] * (x > 0 ? std::sin(x) / x : 1.);
+        if (!mW.empty())
+        {
+            i2 += weight * mW[i] * besselJ2(x);
+        }
+    }
+    i0 *= mStep;
+    i2 *= mStep;
+    return 4 * wignerCore::kPi * (i0 * i0 + i2 * i2);
+}
+//_________________________________________________________________________
+double wignerOverlap::computeCoal(double k, double r0) const
+{
+    double radius = wignerCore::radius(k, r0);
+    return coal(radius, wignerCore::kStarEff(k, radius));
+}
+//_________________________________________________________________________
+double wignerOverlap::getDProbability() const
+{
+    double pd = 0;
+    for (double x : mW)
+    {
+        pd += x * x;
+    }
+    return pd * mStep;
+}
@@ -0,0 +1,157 @@
+#include "CWignerPotential.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+//_________________________________________________________________________
+std::vector<double> wignerPotential::onNodes(const std::vector<double> &r) const
+{
+    std::vector<double> v(r.size());
+    for (size_t i = 0; i < r.size(); ++i)
+    {
+        v[i] = value(r[i]);
+    }
+    return v;
+}
+//_________________________________________________________________________
+wignerPotential *wignerPotential::create(const std::string &spec)
+{
+    std::string name = spec.substr(0, spec.find(':'));
+    std::string args = name.size() < spec.size() ? spec.substr(name.size() + 1) : "";
+    if (name == "table")
+    {
+        if (args.empty())
+        {
+            std::cerr << "Error: tabulated potential needs a file name\n";
+            return nullptr;
+        }
+        return new tabulatedPotential(args);
+    }
+
+    std::vector<double> params;
+    std::stringstream ss(args);
+    std::string item;
+    while (std::getline(ss, item, ','))
+    {
+        params.push_back(std::stod(item));
+    }
+
+    if (name == "square" && params.size() == 2 && params[0] >= 0)
+    {
+        return new squareWellPotential(params[0], params[1]);
+    }
+    if (name == "yukawa" && params.size() == 2 && params[1] > 0)
+    {
+        return new yukawaPotential(params[0], params[1]);
+    }
+    if (name == "woodssaxon" && params.size() == 3 && params[1] >= 0 && params[2] > 0)
+    {
+        return new woodsSaxonPotential(params[0], params[1], params[2]);
+    }
+    std::cerr << "Error: unknown potential " << spec << "\n";
+    return nullptr;
+}
+//_________________________________________________________________________
+squareWellPotential::squareWellPotential(double width, double depth) : mWidth(width), mDepth(depth)
+{
+    if (width < 0)
+    {
+        std::cerr << "Error: potential well width is negative\n";
+        std::abort();
+    }
+}
+//_________________________________________________________________________
+yukawaPotential::yukawaPotential(double strength, double range) : mStrength(strength), mRange(range)
+{
+    if (range <= 0)
+    {
+        std::cerr << "Error: Yukawa range is not positive\n";
+        std::abort();
+    }
+}
+//_________________________________________________________________________
+double yukawaPotential::value(double r) const
+{
+    double x = r / mRange;
+    return mStrength * exp(-x) / x;
+}
+//_________________________________________________________________________
+woodsSaxonPotential::woodsSaxonPotential(double depth, double radius, double diffuseness)
+    : mDepth(depth), mRadius(radius), mDiffuseness(diffuseness)
+{
+    if (radius < 0 || diffuseness <= 0)
+    {
+        std::cerr << "Error: Woods-Saxon potential needs radius >= 0 and diffuseness > 0\n";
+        std::abort();
+    }
+}
+//_________________________________________________________________________
+double woodsSaxonPotential::value(double r) const
+{
+    return mDepth / (1. + exp((r - mRadius) / mDiffuseness));
+}
+//_________________________________________________________________________
+tabulatedPotential::tabulatedPotential(const std::string &filename) : mFileName(filename)
+{
+    std::ifstream infile(filename);
+    if (!infile.is_open())
+    {
+        std::cerr << "Could not open file: " << filename << "\n";
+        throw std::runtime_error("File open failed.");
+    }
+    std::string line;
+    while (std::getline(infile, line))
+    {
+        line = line.substr(0, line.find('#'));
+        std::istringstream iss(line);
+        double r, v;
+        if (!(iss >> r >> v))
+        {
+            continue;
+        }
+        if (!mR.empty() && r <= mR.back())
+        {
+            std::cerr << "Error: radii of the potential table " << filename << " are not increasing\n";
+            std::abort();
+        }
+        mR.push_back(r);
+        mV.push_back(v);
+    }
+    if (mR.size() < 2)
+    {
+        std::cerr << "Error: potential table " << filename << " has fewer than 2 points\n";
+        std::abort();
+    }
+}
+//_________________________________________________________________________
+double tabulatedPotential::value(double r) const
+{
+    if (r <= mR.front())
+    {
+        return mV.front();
+    }
+    if (r > mR.back())
+    {
+        return 0.;
+    }
+    size_t i = std::upper_bound(mR.begin(), mR.end(), r) - mR.begin();
+    if (i == mR.size())
+    {
+        return mV.back();
+    }
+    double t = (r - mR[i - 1]) / (mR[i] - mR[i - 1]);
+    return mV[i - 1] + t * (mV[i] - mV[i - 1]);
+}
+//_________________________________________________________________________
+std::vector<double> tabulatedPotential::getParameters() const
+{
+    std::vector<double> params;
+    params.reserve(2 * mR.size());
+    params.insert(params.end(), mR.begin(), mR.end());
+    params.insert(params.end(), mV.begin(), mV.end());
+    return params;
+}
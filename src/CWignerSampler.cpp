@@ -0,0 +1,234 @@
+#include "CWignerSampler.h"
+#include "CWignerCore.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+namespace
+{
+    std::atomic<uint64_t> gSeed(12345); ///< Seed of new streams.
+    std::atomic<uint64_t> gStreams(0);  ///< Number of streams created so far.
+}
+//_________________________________________________________________________
+wignerRandom::wignerRandom(uint64_t seed, uint64_t stream)
+{
+    // splitmix64 spreads the seed over the state, which must not be all zero
+    for (uint64_t &s : mS)
+    {
+        seed += 0x9E3779B97F4A7C15ULL;
+        uint64_t z = seed;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        s = z ^ (z >> 31);
+    }
+    for (uint64_t i = 0; i < stream; ++i)
+    {
+        jump();
+    }
+}
+//_________________________________________________________________________
+void wignerRandom::jump()
+{
+    static const uint64_t kJump[4] = {0x180EC6D33CFD0ABAULL, 0xD5A61266F0C9392CULL, 0xA9582618E03FC9AAULL, 0x39ABDC4529B1661CULL};
+    uint64_t s[4] = {0, 0, 0, 0};
+    for (uint64_t j : kJump)
+    {
+        for (int b = 0; b < 64; ++b)
+        {
+            if (j & (uint64_t(1) << b))
+            {
+                for (int i = 0; i < 4; ++i)
+                {
+                    s[i] ^= mS[i];
+                }
+            }
+            (*this)();
+        }
+    }
+    std::copy(s, s + 4, mS);
+}
+//_________________________________________________________________________
+wignerSampler::wignerSampler(double radius, double kStar)
+    : mRadius(radius), mKStar(kStar)
+{
+    if (radius <= 0 || kStar < 0)
+    {
+        std::cerr << "Error: invalid radius or k* of the sampler\n";
+        std::abort();
+    }
+    // exp(-r² / 4R²) and exp(-4R² (p - k)² / ħ²)
+    mSigmaR = std::sqrt(2.) * radius;
+    mSigmaP = wignerCore::kHCut / (std::sqrt(8.) * radius);
+}
+//_________________________________________________________________________
+void wignerSampler::setTable(const wignerTable &table, double minX, double maxX, double minP, double maxP, double dx, double dp)
+{
+    std::vector<double> rBreaks, pBreaks, r, p;
+    table.getBreaks(rBreaks, pBreaks);
+    wignerCore::gridNodes(minX, maxX, rBreaks, dx, r, mRWidth);
+    wignerCore::gridNodes(minP, maxP, pBreaks, dp, p, mPWidth);
+    mRLow.resize(r.size());
+    mPLow.resize(p.size());
+    for (size_t i = 0; i < r.size(); ++i)
+    {
+        mRLow[i] = r[i] - 0.5 * mRWidth[i];
+    }
+    for (size_t j = 0; j < p.size(); ++j)
+    {
+        mPLow[j] = p[j] - 0.5 * mPWidth[j];
+    }
+
+    // W·J = F(r) G(p); only the cells with a weight enter the alias table
+    std::vector<double> f(r.size()), g(p.size()), weights;
+    for (size_t i = 0; i < r.size(); ++i)
+    {
+        f[i] = std::exp(-r[i] * r[i] * 0.25 / (mRadius * mRadius)) * r[i] * r[i] * mRWidth[i];
+    }
+    for (size_t j = 0; j < p.size(); ++j)
+    {
+        g[j] = wignerCore::wigner(0, p[j], 1., mRadius, mKStar) * wignerCore::jacobian(1, p[j], mRadius, mKStar) * mPWidth[j];
+    }
+    mColumns.clear();
+    mWeight = mAbsWeight = 0;
+    for (size_t j = 0; j < p.size(); ++j)
+    {
+        if (g[j] == 0)
+        {
+            continue;
+        }
+        for (size_t i = 0; i < r.size(); ++i)
+        {
+            double w = table.interpolate(r[i], p[j]) * f[i] * g[j];
+            if (w != 0)
+            {
+                column c;
+                c.prob = 1;
+                c.r[0] = c.r[1] = i;
+                c.p[0] = c.p[1] = j;
+                c.sign[0] = c.sign[1] = w > 0 ? 1 : -1;
+                mColumns.push_back(c);
+                weights.push_back(std::fabs(w));
+                mWeight += w;
+                mAbsWeight += std::fabs(w);
+            }
+        }
+    }
+
+    // Vose's alias method: every column is filled to the mean by at most one other cell
+    const size_t n = weights.size();
+    std::vector<uint32_t> small, large;
+    for (size_t c = 0; c < n; ++c)
+    {
+        weights[c] *= n / mAbsWeight;
+        (weights[c] < 1 ? small : large).push_back(c);
+    }
+    while (!small.empty() && !large.empty())
+    {
+        uint32_t s = small.back(), l = large.back();
+        small.pop_back();
+        column &c = mColumns[s];
+        c.prob = weights[s];
+        c.r[1] = mColumns[l].r[0];
+        c.p[1] = mColumns[l].p[0];
+        c.sign[1] = mColumns[l].sign[0];
+        weights[l] -= 1 - weights[s];
+        if (weights[l] < 1)
+        {
+            large.pop_back();
+            small.push_back(l);
+        }
+    }
+}
+//_________________________________________________________________________
+void wignerSampler::sampleSource(size_t n, double *r, double *p, wignerRandom &rng) const
+{
+    for (size_t s = 0; s < n; ++s)
+    {
+        // normal pair by the polar method; χ² with 2 degrees of freedom is -2 ln u
+        double v1, v2, q;
+        do
+        {
+            v1 = 2 * rng.uniform() - 1;
+            v2 = 2 * rng.uniform() - 1;
+            q = v1 * v1 + v2 * v2;
+        } while (q >= 1 || q == 0);
+        double scale = std::sqrt(-2 * std::log(q) / q);
+        double z1 = v1 * scale, z2 = v2 * scale;
+        r[s] = mSigmaR * std::sqrt(z1 * z1 - 2 * std::log(rng.uniformPositive()));
+        double pz = mKStar + mSigmaP * z2;
+        p[s] = std::sqrt(pz * pz - 2 * mSigmaP * mSigmaP * std::log(rng.uniformPositive()));
+    }
+}
+//_________________________________________________________________________
+void wignerSampler::sampleSource(size_t n, double *r, double *p) const
+{
+    sampleSource(n, r, p, stream());
+}
+//_________________________________________________________________________
+void wignerSampler::sampleCoalescence(size_t n, double *r, double *p, double *sign, wignerRandom &rng) const
+{
+    if (mColumns.empty())
+    {
+        return;
+    }
+    const size_t columns = mColumns.size();
+    for (size_t s = 0; s < n; ++s)
+    {
+        // the integer part picks the column, the fraction the cell or its alias
+        double u = rng.uniform() * columns;
+        size_t c = std::min(size_t(u), columns - 1);
+        const column &col = mColumns[c];
+        int a = u - c < col.prob ? 0 : 1;
+        uint32_t i = col.r[a], j = col.p[a];
+        r[s] = mRLow[i] + rng.uniform() * mRWidth[i];
+        p[s] = mPLow[j] + rng.uniform() * mPWidth[j];
+        if (sign)
+        {
+            sign[s] = col.sign[a];
+        }
+    }
+}
+//_________________________________________________________________________
+void wignerSampler::sampleCoalescence(size_t n, double *r, double *p, double *sign) const
+{
+    sampleCoalescence(n, r, p, sign, stream());
+}
+//_________________________________________________________________________
+double wignerSampler::getCoal(double norm) const
+{
+    const double h = 2 * wignerCore::kPi * wignerCore::kHCut;
+    return h * h * h * norm * mWeight;
+}
+//_________________________________________________________________________
+double wignerSampler::getSignRatio() const
+{
+    return mWeight != 0 ? mAbsWeight / mWeight : 0.;
+}
+//_________________________________________________________________________
+size_t wignerSampler::getCells() const
+{
+    return mColumns.size();
+}
+//_________________________________________________________________________
+double wignerSampler::getRadius() const
+{
+    return mRadius;
+}
+//_________________________________________________________________________
+double wignerSampler::getKStar() const
+{
+    return mKStar;
+}
+//_________________________________________________________________________
+wignerRandom &wignerSampler::stream()
+{
+    thread_local wignerRandom rng(gSeed.load(), gStreams++);
+    return rng;
+}
+//_________________________________________________________________________
+void wignerSampler::setSeed(uint64_t seed)
+{
+    gSeed = seed;
+}
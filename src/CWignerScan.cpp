@@ -0,0 +1,475 @@
+#include "CWignerScan.h"
+#include "CWignerAnisotropicSource.h"
+#include "CWignerShapedSource.h"
+#include "CWignerSource.h"
+#include "CWignerThreeBody.h"
+#include "CWignerUtils.h"
+#include "TFile.h"
+#include "TH2.h"
+#include "TNamed.h"
+#include "TROOT.h"
+#include "TTree.h"
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+namespace
+{
+    std::mutex gPrintMutex; ///< Serializes the per-point log lines of the workers.
+}
+//_________________________________________________________________________
+wignerScan::wignerScan(const std::string &txtinput, int nThreads) : mConfig(txtinput)
+{
+    setThreads(nThreads);
+}
+//_________________________________________________________________________
+void wignerScan::setThreads(int nThreads)
+{
+    mThreads = nThreads < 1 ? 1 : nThreads;
+}
+//_________________________________________________________________________
+void wignerScan::setTestMode(bool testMode)
+{
+    mTestMode = testMode;
+}
+//_________________________________________________________________________
+void wignerScan::setVerbose(bool verbose)
+{
+    mVerbose = verbose;
+}
+//_________________________________________________________________________
+void wignerScan::setCache(wignerCache *cache)
+{
+    mCache = cache;
+}
+//_________________________________________________________________________
+void wignerScan::setAnisotropic(double rOut, double rSide, double rLong)
+{
+    mAnisotropic = true;
+    mR0s[0] = rOut;
+    mR0s[1] = rSide;
+    mR0s[2] = rLong;
+}
+//_________________________________________________________________________
+void wignerScan::setThreeBody(const wignerNucleusA3 *nucleus, double tolerance)
+{
+    mThreeBody = true;
+    mNucleus = nucleus;
+    mTolerance = tolerance;
+}
+//_________________________________________________________________________
+bool wignerScan::setShape(const std::string &spec)
+{
+    std::string name = spec.substr(0, spec.find(':'));
+    std::vector<double> params;
+    if (name.size() < spec.size())
+    {
+        std::stringstream ss(spec.substr(name.size() + 1));
+        std::string item;
+        while (std::getline(ss, item, ','))
+        {
+            params.push_back(std::stod(item));
+        }
+    }
+
+    size_t expected = name == "levy" ? 1 : (name == "corehalo" ? 2 : 0);
+    bool known = name == "gauss" || name == "exponential" || name == "cauchy" || name == "levy" || name == "corehalo";
+    if (known && params.size() == expected && name == "levy")
+        known = params[0] >= 1 && params[0] <= 2;
+    if (known && params.size() == expected && name == "corehalo")
+        known = params[0] >= 0 && params[0] <= 1 && params[1] > 0;
+    if (!known || params.size() != expected)
+    {
+        std::cerr << "Error: unknown source shape " << spec << "\n";
+        return false;
+    }
+    mShape = name;
+    mShapeParams = params;
+    return true;
+}
+//_________________________________________________________________________
+bool wignerScan::setPotential(const std::string &spec)
+{
+    std::unique_ptr<wignerPotential> potential(wignerPotential::create(spec));
+    if (!potential)
+    {
+        return false;
+    }
+    mPotential = spec;
+    return true;
+}
+//_________________________________________________________________________
+bool wignerScan::setDeuteronTables(const std::vector<std::string> &files)
+{
+    std::vector<wignerTable> tables;
+    for (const auto &name : files)
+    {
+        std::unique_ptr<TFile> file(TFile::Open(name.c_str(), "READ"));
+        TH2 *h = (file && !file->IsZombie()) ? dynamic_cast<TH2 *>(file->Get("h")) : nullptr;
+        if (!h)
+        {
+            std::cerr << "Could not read h from " << name << "\n";
+            return false;
+        }
+        tables.push_back(wignerUtils::toTable(h));
+    }
+    mTableFiles = files;
+    mTables = std::move(tables);
+    return true;
+}
+//_________________________________________________________________________
+const std::vector<std::string> &wignerScan::getDeuteronTables() const
+{
+    return mTableFiles;
+}
+//_________________________________________________________________________
+void wignerScan::setMixture(const wignerGaussianMixture *mixture)
+{
+    mMixture = mixture;
+}
+//_________________________________________________________________________
+void wignerScan::setObservables(const wignerObservables *observables)
+{
+    mObservables = observables;
+}
+//_________________________________________________________________________
+void wignerScan::setCorrelation(const wignerCorrelation *correlation)
+{
+    mCorrelation = correlation;
+}
+//_________________________________________________________________________
+void wignerScan::setCoalPrecision(double precision)
+{
+    mCoalPrecision = precision;
+}
+//_________________________________________________________________________
+void wignerScan::setContributionMaps(int nr, int np)
+{
+    mMapBins[0] = nr > 0 ? nr : 0;
+    mMapBins[1] = np;
+}
+//_________________________________________________________________________
+const std::vector<wignerContributionMap> &wignerScan::getContributionMaps() const
+{
+    return mMaps;
+}
+//_________________________________________________________________________
+bool wignerScan::writeContributionMaps(const TString &outfile) const
+{
+    TFile file(outfile, "UPDATE");
+    if (file.IsZombie())
+    {
+        std::cerr << "Error: could not open " << outfile << "\n";
+        return false;
+    }
+    TDirectory *dir = file.mkdir("maps");
+    for (size_t i = 0; i < mMaps.size(); ++i)
+    {
+        mMaps[i].write(dir, TString::Format("%zu", i));
+    }
+    file.Close();
+    return true;
+}
+//_________________________________________________________________________
+int wignerScan::getThreads() const
+{
+    return mThreads;
+}
+//_________________________________________________________________________
+const std::string &wignerScan::getConfig() const
+{
+    return mConfig;
+}
+//_________________________________________________________________________
+std::vector<double> wignerScan::kGrid(double start, double end, double step)
+{
+    std::vector<double> values;
+    if (start < 0 || end < 0 || start > end || step <= 0)
+    {
+        std::cerr << "invalid range of k\n";
+        return values;
+    }
+    for (long i = 0;; ++i)
+    {
+        double k = start + i * step;
+        if (k >= end)
+        {
+            break;
+        }
+        values.push_back(k);
+    }
+    return values;
+}
+//_________________________________________________________________________
+std::vector<wignerPoint> wignerScan::run(const std::vector<double> &kValues)
+{
+    std::vector<wignerPoint> points(kValues.size());
+    mMaps.clear();
+    if (mMapBins[0] > 0)
+    {
+        mMaps.assign(kValues.size(), wignerContributionMap(mMapBins[0], mMapBins[1], wignerUtils::getMinX(), wignerUtils::getMaxX(),
+                                                           wignerUtils::getMinP(), wignerUtils::getMaxP()));
+    }
+
+    if (mThreeBody)
+    {
+        // the Monte Carlo of each point is already parallel
+        wignerThreeBody tb(mNucleus);
+        tb.SetFromTxt(mConfig);
+        tb.setThreads(mThreads);
+        tb.setTolerance(mTolerance);
+        for (size_t i = 0; i < kValues.size(); ++i)
+        {
+            points[i] = tb.computePoint(kValues[i]);
+            print(points[i]);
+        }
+        return points;
+    }
+
+    int nWorkers = std::min<int>(mThreads, std::max<size_t>(kValues.size(), 1));
+
+    if (nWorkers == 1)
+    {
+        work(0, kValues, points);
+        return points;
+    }
+
+    ROOT::EnableThreadSafety();
+    std::vector<std::thread> workers;
+    for (int i = 0; i < nWorkers; ++i)
+    {
+        workers.emplace_back(&wignerScan::work, this, i, std::cref(kValues), std::ref(points));
+    }
+    for (auto &t : workers)
+    {
+        t.join();
+    }
+    return points;
+}
+//_________________________________________________________________________
+void wignerScan::work(int worker, const std::vector<double> &kValues, std::vector<wignerPoint> &points)
+{
+    // each worker owns its potential and the values cached on its grid
+    std::unique_ptr<wignerPotential> potential(mPotential.empty() ? nullptr : wignerPotential::create(mPotential));
+
+    // one instantiation per shape: the shape is fixed for the whole scan
+    if (mShape == "gauss")
+        return workShaped(worker, gaussianShape(), potential.get(), kValues, points);
+    if (mShape == "exponential")
+        return workShaped(worker, exponentialShape(), potential.get(), kValues, points);
+    if (mShape == "cauchy")
+        return workShaped(worker, cauchyShape(), potential.get(), kValues, points);
+    if (mShape == "levy")
+        return workShaped(worker, levyShape(mShapeParams[0]), potential.get(), kValues, points);
+    if (mShape == "corehalo")
+        return workShaped(worker, coreHaloShape(mShapeParams[0], mShapeParams[1]), potential.get(), kValues, points);
+
+    int nWorkers = std::min<int>(mThreads, std::max<size_t>(kValues.size(), 1));
+
+    wignerSource fw(TString::Format("_scan%d", worker));
+    wignerAnisotropicSource fwA;
+    if (mAnisotropic)
+    {
+        fwA.SetFromTxt(mConfig);
+        fwA.setR0(mR0s[0], mR0s[1], mR0s[2]);
+        fwA.setCache(mCache);
+    }
+    else
+    {
+        fw.initFunctions(mTestMode);
+        fw.SetFromTxt(mConfig);
+        fw.setCache(mCache);
+        fw.setPotential(potential.get());
+    }
+    std::vector<const wignerTable *> tables;
+    for (const auto &table : mTables)
+    {
+        tables.push_back(&table);
+    }
+    fw.setDeuteronTables(&tables);
+    fw.setMixture(mMixture);
+    fw.setCoalPrecision(mCoalPrecision);
+    fw.setObservables(mObservables);
+    fw.setCorrelation(mCorrelation);
+
+    for (size_t i = worker; i < kValues.size(); i += nWorkers)
+    {
+        wignerPoint &pt = points[i];
+        fw.setContributionMap(mMaps.empty() ? nullptr : &mMaps[i]);
+        pt = mAnisotropic ? fwA.computePoint(kValues[i]) : fw.computePoint(kValues[i]);
+        print(pt);
+    }
+}
+//_________________________________________________________________________
+template <class Shape>
+void wignerScan::workShaped(int worker, const Shape &shape, const wignerPotential *potential, const std::vector<double> &kValues,
+                            std::vector<wignerPoint> &points)
+{
+    int nWorkers = std::min<int>(mThreads, std::max<size_t>(kValues.size(), 1));
+
+    wignerShapedSource<Shape> fw(shape);
+    fw.SetFromTxt(mConfig);
+    fw.setCache(mCache);
+    fw.setPotential(potential);
+    for (size_t i = worker; i < kValues.size(); i += nWorkers)
+    {
+        points[i] = fw.computePoint(kValues[i]);
+        print(points[i]);
+    }
+}
+//_________________________________________________________________________
+void wignerScan::print(const wignerPoint &pt)
+{
+    if (!mVerbose)
+    {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(gPrintMutex);
+    std::cout << "i : " << pt.k
+              << " coal: " << pt.coal
+              << " r0:  " << pt.r0
+              << " k*: " << pt.k
+              << " Norm: " << pt.norm
+              << " Check: " << pt.WW
+              << " K: " << pt.wK
+              << " V: " << pt.wV
+              << " H: " << pt.wH << "\n";
+}
+//_________________________________________________________________________
+bool wignerScan::writeTree(const std::vector<wignerPoint> &points, const TString &outfile, bool withShardInfo,
+                           const std::vector<std::string> &tableNames, const std::vector<std::string> &observableNames,
+                           bool withCorrelation)
+{
+    TFile file(outfile, "RECREATE");
+    if (file.IsZombie())
+    {
+        std::cerr << "Error: could not create " << outfile << "\n";
+        return false;
+    }
+    std::cout << "Creating " << outfile << "\n";
+
+    TTree *tree = new TTree("tree", "W x W");
+
+    wignerPoint pt;
+    tree->Branch("r0", &pt.r0, "r0/D");
+    tree->Branch("WxW", &pt.WW, "WW/D");
+    tree->Branch("coal", &pt.coal, "coal/D");
+    tree->Branch("norm", &pt.norm, "norm/D");
+    tree->Branch("wH", &pt.wH, "wH/D");
+    tree->Branch("wK", &pt.wK, "wK/D");
+    tree->Branch("wV", &pt.wV, "wV/D");
+    tree->Branch("k", &pt.k, "k/D");
+    if (withShardInfo)
+    {
+        tree->Branch("idx", &pt.idx, "idx/L");
+        tree->Branch("shard", &pt.shard, "shard/I");
+    }
+    if (withCorrelation)
+    {
+        tree->Branch("cf", &pt.cf, "cf/D");
+    }
+    std::vector<double> coals(points.empty() ? 0 : points[0].coalTables.size());
+    for (size_t t = 0; t < coals.size(); ++t)
+    {
+        TString name = TString::Format("coal_%zu", t);
+        TBranch *branch = tree->Branch(name, &coals[t], name + "/D");
+        if (t < tableNames.size())
+        {
+            branch->SetTitle(tableNames[t].c_str());
+        }
+    }
+    std::vector<double> observables(observableNames.size());
+    for (size_t o = 0; o < observables.size(); ++o)
+    {
+        tree->Branch(observableNames[o].c_str(), &observables[o], (observableNames[o] + "/D").c_str());
+    }
+
+    for (const auto &p : points)
+    {
+        pt = p;
+        for (size_t t = 0; t < coals.size() && t < p.coalTables.size(); ++t)
+        {
+            coals[t] = p.coalTables[t];
+        }
+        for (size_t o = 0; o < observables.size() && o < p.observables.size(); ++o)
+        {
+            observables[o] = p.observables[o];
+        }
+        tree->Fill();
+    }
+
+    if (withShardInfo)
+    {
+        tree->BuildIndex("idx");
+    }
+    tree->Write();
+    file.Close();
+    return true;
+}
+//_________________________________________________________________________
+bool wignerScan::readTree(const TString &infile, std::vector<wignerPoint> &points)
+{
+    std::unique_ptr<TFile> file(TFile::Open(infile));
+    if (!file || file->IsZombie())
+    {
+        return false;
+    }
+    TTree *tree = (TTree *)file->Get("tree");
+    if (!tree)
+    {
+        return false;
+    }
+
+    wignerPoint pt;
+    tree->SetBranchAddress("r0", &pt.r0);
+    tree->SetBranchAddress("WxW", &pt.WW);
+    tree->SetBranchAddress("coal", &pt.coal);
+    tree->SetBranchAddress("norm", &pt.norm);
+    tree->SetBranchAddress("wH", &pt.wH);
+    tree->SetBranchAddress("wK", &pt.wK);
+    tree->SetBranchAddress("wV", &pt.wV);
+    tree->SetBranchAddress("k", &pt.k);
+    bool withShardInfo = tree->GetBranch("idx") && tree->GetBranch("shard");
+    if (withShardInfo)
+    {
+        tree->SetBranchAddress("idx", &pt.idx);
+        tree->SetBranchAddress("shard", &pt.shard);
+    }
+
+    long long n = tree->GetEntries();
+    points.reserve(points.size() + n);
+    for (long long i = 0; i < n; ++i)
+    {
+        tree->GetEntry(i);
+        points.push_back(pt);
+    }
+    return true;
+}
+//_________________________________________________________________________
+bool wignerScan::writeStamp(const TString &outfile, const std::string &stamp)
+{
+    TFile file(outfile, "UPDATE");
+    if (file.IsZombie())
+    {
+        std::cerr << "Error: could not open " << outfile << "\n";
+        return false;
+    }
+    TNamed named("stamp", stamp.c_str());
+    named.Write();
+    file.Close();
+    return true;
+}
+//_________________________________________________________________________
+std::string wignerScan::readStamp(const TString &infile)
+{
+    std::unique_ptr<TFile> file(TFile::Open(infile));
+    if (!file || file->IsZombie())
+    {
+        return "";
+    }
+    TNamed *named = dynamic_cast<TNamed *>(file->Get("stamp"));
+    return named ? named->GetTitle() : "";
+}
@@ -0,0 +1,167 @@
+#include "CWignerShapes.h"
+#include "CWignerCore.h"
+#include "CWignerUtils.h"
+#include "TMath.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+//_________________________________________________________________________
+double wignerShapeBase::radius(double k, double r0) const
+{
+    return wignerUtils::radius(k, r0);
+}
+//_________________________________________________________________________
+double wignerShapeBase::kStarEff(double k, double radius) const
+{
+    return wignerUtils::kStarEff(k, radius);
+}
+//_________________________________________________________________________
+double wignerShapeBase::momentum(double p, double kStar, double ra, double rb, bool squared)
+{
+    double hCut = wignerUtils::getHCut();
+    double beta = 4 * ra * ra / (hCut * hCut);
+    double norm = pow(beta / TMath::Pi(), 1.5);
+    if (squared)
+    {
+        double betaB = 4 * rb * rb / (hCut * hCut);
+        norm *= pow(betaB / TMath::Pi(), 1.5);
+        beta += betaB;
+    }
+    // average of exp(2 β p k* cosθ) over the direction of p
+    double alpha = 2 * beta * p * kStar;
+    double average = alpha < 1E-12 ? 1. : -std::expm1(-2 * alpha) / (2 * alpha);
+    return 4 * TMath::Pi() * p * p * norm * exp(-beta * (p - kStar) * (p - kStar)) * average;
+}
+//_________________________________________________________________________
+double gaussianShape::density(int, double r, double radius) const
+{
+    double norm = 4 * TMath::Pi() * radius * radius;
+    return exp(-0.25 * r * r / (radius * radius)) / (norm * sqrt(norm));
+}
+//_________________________________________________________________________
+double gaussianShape::cdf(int, double a, double radius) const
+{
+    return wignerCore::gaussianCdf(a, radius);
+}
+//_________________________________________________________________________
+double exponentialShape::density(int, double r, double radius) const
+{
+    return exp(-r / radius) / (8 * TMath::Pi() * radius * radius * radius);
+}
+//_________________________________________________________________________
+double exponentialShape::cdf(int, double a, double radius) const
+{
+    double x = a / radius;
+    return 1. - exp(-x) * (1. + x + 0.5 * x * x);
+}
+//_________________________________________________________________________
+double cauchyShape::density(int, double r, double radius) const
+{
+    double y = 1. + r * r / (radius * radius);
+    return 1. / (TMath::Pi() * TMath::Pi() * radius * radius * radius * y * y);
+}
+//_________________________________________________________________________
+double cauchyShape::cdf(int, double a, double radius) const
+{
+    double x = a / radius;
+    return 2. / TMath::Pi() * (atan(x) - x / (1. + x * x));
+}
+//_________________________________________________________________________
+levyShape::levyShape(double alpha) : mAlpha(alpha)
+{
+    if (alpha < 1 || alpha > 2)
+    {
+        std::cerr << "Error: Levy index must be in [1, 2]\n";
+        std::abort();
+    }
+    double xMax = 30.;
+    int n = int(xMax / mStep + 0.5) + 1;
+
+    // trapezoidal rule in q up to exp(-q^α) = 1e-13; q sin(qx) vanishes at q = 0
+    double dq = 0.01;
+    int nq = int(pow(-log(1E-13), 1. / alpha) / dq) + 1;
+    std::vector<double> g(nq);
+    for (int i = 0; i < nq; ++i)
+    {
+        double q = i * dq;
+        g[i] = q * exp(-pow(q, alpha)) * dq;
+    }
+
+    mS.assign(n, 0.);
+    mS[0] = std::tgamma(3. / alpha) / (2 * TMath::Pi() * TMath::Pi() * alpha);
+    for (int ix = 1; ix < n; ++ix)
+    {
+        double x = ix * mStep;
+        // sin(i dq x) by rotation
+        double c1 = cos(dq * x), s1 = sin(dq * x);
+        double cn = 1., sn = 0., sum = 0.;
+        for (int i = 1; i < nq; ++i)
+        {
+            double t = cn * c1 - sn * s1;
+            sn = sn * c1 + cn * s1;
+            cn = t;
+            sum += g[i] * sn;
+        }
+        mS[ix] = std::max(0., sum / (2 * TMath::Pi() * TMath::Pi() * x));
+    }
+
+    mCdf.assign(n, 0.);
+    for (int ix = 1; ix < n; ++ix)
+    {
+        double x0 = (ix - 1) * mStep, x1 = ix * mStep;
+        mCdf[ix] = mCdf[ix - 1] + 2 * TMath::Pi() * mStep * (x0 * x0 * mS[ix - 1] + x1 * x1 * mS[ix]);
+    }
+}
+//_________________________________________________________________________
+double levyShape::density(int, double r, double radius) const
+{
+    double x = r / radius;
+    double u = x / mStep;
+    size_t i = size_t(u);
+    double s;
+    if (i + 1 < mS.size())
+    {
+        s = mS[i] + (u - i) * (mS[i + 1] - mS[i]);
+    }
+    else
+    {
+        double xMax = (mS.size() - 1) * mStep;
+        s = mS.back() * pow(xMax / x, 3. + mAlpha);
+    }
+    return s / (radius * radius * radius);
+}
+//_________________________________________________________________________
+double levyShape::cdf(int, double a, double radius) const
+{
+    double x = a / radius;
+    double u = x / mStep;
+    size_t i = size_t(u);
+    if (i + 1 < mCdf.size())
+    {
+        return mCdf[i] + (u - i) * (mCdf[i + 1] - mCdf[i]);
+    }
+    // power-law tail of the density
+    double xMax = (mS.size() - 1) * mStep;
+    return mCdf.back() + 4 * TMath::Pi() * mS.back() * xMax * xMax * xMax / mAlpha * (1. - pow(xMax / x, mAlpha));
+}
+//_________________________________________________________________________
+coreHaloShape::coreHaloShape(double fraction, double ratio) : mFraction(fraction), mRatio(ratio)
+{
+    if (fraction < 0 || fraction > 1 || ratio <= 0)
+    {
+        std::cerr << "Error: core-halo shape needs 0 <= fraction <= 1 and ratio > 0\n";
+        std::abort();
+    }
+}
+//_________________________________________________________________________
+double coreHaloShape::density(int c, double r, double radius) const
+{
+    return mGauss.density(c, r, radius);
+}
+//_________________________________________________________________________
+double coreHaloShape::cdf(int c, double a, double radius) const
+{
+    return mGauss.cdf(c, a, radius);
+}
@@ -1,5 +1,7 @@
 #include "CWignerSource.h"
 #include "CWignerUtils.h"
+#include <algorithm>
+#include <cmath>
 #include <cstdlib>
 
 void wignerSource::initFunctions(bool testMode)
@@ -158,14 +160,30 @@ void wignerSource::setRWidth(double rWidth)
         std::abort();
     }
     mRWidth = rWidth;
+    mWell = squareWellPotential(mRWidth, mV0);
+    mPotentialDirty = true;
     reSetRWidth();
 }
+//_________________________________________________________________________
 void wignerSource::setV0(double v0)
 {
     mV0 = v0;
+    mWell = squareWellPotential(mRWidth, mV0);
+    mPotentialDirty = true;
     reSetV0();
 }
 //_________________________________________________________________________
+void wignerSource::setPotential(const wignerPotential *potential)
+{
+    mPotential = potential;
+    mPotentialDirty = true;
+}
+//_________________________________________________________________________
+const wignerPotential *wignerSource::getPotential() const
+{
+    return mPotential ? mPotential : &mWell;
+}
+//_________________________________________________________________________
 TF2 *wignerSource::getWignerFunction()
 {
     return mW;
@@ -244,17 +262,137 @@ double wignerSource::getNorm()
 //_________________________________________________________________________
 double wignerSource::getwK()
 {
+    if (!mMap && !wignerUtils::testMode)
+    {
+        return getP2Moment() / (2 * mMu);
+    }
+    if (!wignerUtils::testMode)
+    {
+        return wignerCore::integrateVisit([this](double x, double p)
+                                          { return mWK->Eval(x, p); },
+                                          [this](double x, double p, double w)
+                                          { mMap->fill(wignerContributionMap::kWK, x, p, w); },
+                                          wignerUtils::getMinX(), wignerUtils::getMaxX(), wignerUtils::getMinP(), wignerUtils::getMaxP(),
+                                          wignerUtils::getDx(), wignerUtils::getDp());
+    }
     return wignerUtils::integral(mWK);
 }
 //_________________________________________________________________________
 double wignerSource::getwV()
 {
-    return wignerUtils::integral(mWV);
+    if (!mPotential && !mMap && !wignerUtils::testMode)
+    {
+        return mV0 * getRadialCumulative(mRWidth);
+    }
+    if (wignerUtils::testMode)
+    {
+        // TF2 integrals only, split at the breaks of the potential
+        if (!mPotential)
+        {
+            return wignerUtils::integral(mWV, getPotential()->getBreaks(), {});
+        }
+        TF2 wxv("WxP" + mName, [this](double *x, double *)
+                { return mWxJ->Eval(x[0], x[1]) * mPotential->value(x[0]); },
+                mRMin, mRMax, mPMin, mPMax, 0);
+        return wignerUtils::integral(&wxv, mPotential->getBreaks(), {});
+    }
+    updateMarginal();
+    double res = 0;
+    for (size_t i = 0; i < mMarginal.size(); ++i)
+    {
+        res += mVNodes[i] * mMarginal[i];
+    }
+    return res;
 }
 //_________________________________________________________________________
 double wignerSource::getwH()
 {
-    return wignerUtils::integral(mWH);
+    if (!wignerUtils::testMode)
+    {
+        // getwK() without filling the maps a second time
+        return getP2Moment() / (2 * mMu) + getwV();
+    }
+    if (!mPotential)
+    {
+        return wignerUtils::integral(mWH, getPotential()->getBreaks(), {});
+    }
+    // same panels as getwV, so that wH = wK + wV in test mode
+    return wignerUtils::integral(mWK, getPotential()->getBreaks(), {}) + getwV();
+}
+//_________________________________________________________________________
+void wignerSource::updatePotential()
+{
+    double grid[6] = {wignerUtils::getMinX(), wignerUtils::getMaxX(), wignerUtils::getMinP(), wignerUtils::getMaxP(),
+                      wignerUtils::getDx(), wignerUtils::getDp()};
+    bool gridChanged = !std::equal(grid, grid + 6, mGrid);
+    if (!mPotentialDirty && !gridChanged)
+    {
+        return;
+    }
+    std::copy(grid, grid + 6, mGrid);
+    // the breaks of the potential (the edge of the square well) are cell edges
+    const wignerPotential *potential = getPotential();
+    std::vector<double> nodes = mRNodes;
+    wignerUtils::gridNodes(grid[0], grid[1], potential->getBreaks(), grid[4], mRNodes, mRWidths);
+    mVNodes = potential->onNodes(mRNodes);
+    mPotentialDirty = false;
+    // a new depth or strength keeps the nodes, and so the marginal
+    if (gridChanged || nodes != mRNodes)
+    {
+        mMarginalDirty = true;
+    }
+}
+//_________________________________________________________________________
+void wignerSource::updateMarginal()
+{
+    updatePotential();
+    if (!mMarginalDirty)
+    {
+        return;
+    }
+    std::vector<double> p, hp;
+    wignerUtils::gridNodes(mGrid[2], mGrid[3], {}, mGrid[5], p, hp);
+    mMarginal.assign(mRNodes.size(), 0.);
+    for (size_t i = 0; i < mRNodes.size(); ++i)
+    {
+        double sum = 0;
+        for (size_t j = 0; j < p.size(); ++j)
+        {
+            double w = mWxJ->Eval(mRNodes[i], p[j]) * hp[j];
+            sum += w;
+            if (mMap)
+            {
+                mMap->fill(wignerContributionMap::kWV, mRNodes[i], p[j], mVNodes[i] * w * mRWidths[i]);
+            }
+        }
+        mMarginal[i] = sum * mRWidths[i];
+    }
+    mMarginalDirty = false;
+}
+//_________________________________________________________________________
+void wignerSource::updateMoments()
+{
+    double grid[6] = {wignerUtils::getMinX(), wignerUtils::getMaxX(), wignerUtils::getMinP(), wignerUtils::getMaxP(),
+                      wignerUtils::getDx(), wignerUtils::getDp()};
+    if (!mMomentsDirty && std::equal(grid, grid + 6, mMomentGrid))
+    {
+        return;
+    }
+    std::copy(grid, grid + 6, mMomentGrid);
+    wignerCore::sourceMoments(mNorm, mRadius, mKStar, grid[0], grid[1], grid[2], grid[3], grid[4], grid[5], mEdges, mCumulative, mP2);
+    mMomentsDirty = false;
+}
+//_________________________________________________________________________
+double wignerSource::getRadialCumulative(double r)
+{
+    updateMoments();
+    return wignerCore::interpolateCumulative(mEdges, mCumulative, r);
+}
+//_________________________________________________________________________
+double wignerSource::getP2Moment()
+{
+    updateMoments();
+    return mP2;
 }
 //_________________________________________________________________________
 double wignerSource::checkWxW()
@@ -309,7 +447,220 @@ double wignerSource::getV0()
 //_________________________________________________________________________
 double wignerSource::getcoal()
 {
-    return wignerUtils::integral(mC) * (wignerUtils::getHCut() * 2 * TMath::Pi()) * (wignerUtils::getHCut() * 2 * TMath::Pi()) * (wignerUtils::getHCut() * 2 * TMath::Pi());
+    if (mMixture)
+    {
+        return mMixture->coal(mRadius, mKStar, mNorm);
+    }
+    if (const wignerLowRankTable *table = lowRankTable())
+    {
+        return getcoalLowRank(table);
+    }
+    std::vector<double> rBreaks, pBreaks;
+    wignerUtils::getDeuteronBreaks(rBreaks, pBreaks);
+    if (mMap && !wignerUtils::testMode)
+    {
+        const double h = wignerUtils::getHCut() * 2 * TMath::Pi();
+        return wignerCore::integrateVisit([this](double x, double p)
+                                          { return mC->Eval(x, p); },
+                                          [this, h](double x, double p, double w)
+                                          { mMap->fill(wignerContributionMap::kCoal, x, p, w * h * h * h); },
+                                          wignerUtils::getMinX(), wignerUtils::getMaxX(), wignerUtils::getMinP(), wignerUtils::getMaxP(),
+                                          wignerUtils::getDx(), wignerUtils::getDp(), rBreaks, pBreaks) *
+               h * h * h;
+    }
+    return wignerUtils::integral(mC, rBreaks, pBreaks) * (wignerUtils::getHCut() * 2 * TMath::Pi()) * (wignerUtils::getHCut() * 2 * TMath::Pi()) * (wignerUtils::getHCut() * 2 * TMath::Pi());
+}
+//_________________________________________________________________________
+const wignerLowRankTable *wignerSource::lowRankTable()
+{
+    if (mCoalPrecision <= 0 || mMap || wignerUtils::testMode)
+    {
+        return nullptr;
+    }
+    const wignerLowRankTable *table = wignerUtils::getLowRankTable();
+    return table->getError() <= mCoalPrecision ? table : nullptr;
+}
+//_________________________________________________________________________
+double wignerSource::getcoalLowRank(const wignerLowRankTable *table)
+{
+    double grid[6] = {wignerUtils::getMinX(), wignerUtils::getMaxX(), wignerUtils::getMinP(), wignerUtils::getMaxP(),
+                      wignerUtils::getDx(), wignerUtils::getDp()};
+    if (table != mLowRank || !std::equal(grid, grid + 6, mLowRankGrid))
+    {
+        // same nodes as the grid integration, with the measure folded into the factors
+        std::copy(grid, grid + 6, mLowRankGrid);
+        mLowRank = table;
+        table->projectGrid(grid[0], grid[1], grid[2], grid[3], grid[4], grid[5], mLowRankR, mLowRankP, mLowRankU, mLowRankV);
+    }
+
+    // W·J = F(r) G(p): the r part is the Gaussian, the r² of the Jacobian is in the factors
+    const size_t nr = mLowRankR.size(), np = mLowRankP.size();
+    std::vector<double> f(nr), g(np);
+    for (size_t i = 0; i < nr; ++i)
+    {
+        f[i] = std::exp(-mLowRankR[i] * mLowRankR[i] * 0.25 / (mRadius * mRadius));
+    }
+    for (size_t j = 0; j < np; ++j)
+    {
+        g[j] = wignerCore::wigner(0, mLowRankP[j], mNorm, mRadius, mKStar) * wignerCore::jacobian(1, mLowRankP[j], mRadius, mKStar);
+    }
+    const double h = wignerUtils::getHCut() * 2 * TMath::Pi();
+    return table->coal(mLowRankU, mLowRankV, f, g) * h * h * h;
+}
+//_________________________________________________________________________
+std::vector<double> wignerSource::getcoal(const std::vector<const wignerTable *> &tables)
+{
+    std::vector<double> rBreaks, pBreaks;
+    for (const wignerTable *table : tables)
+    {
+        std::vector<double> r, p;
+        table->getBreaks(r, p);
+        rBreaks.insert(rBreaks.end(), r.begin(), r.end());
+        pBreaks.insert(pBreaks.end(), p.begin(), p.end());
+    }
+
+    const double norm = mNorm, radius = mRadius, kStar = mKStar;
+    const size_t n = tables.size();
+    std::vector<double> res(n);
+    wignerCore::integrateMany([&](double r, double p, double *acc)
+                              {
+                                  double s = wignerCore::wigner(r, p, norm, radius, kStar) * wignerCore::jacobian(r, p, radius, kStar);
+                                  if (s == 0)
+                                  {
+                                      return;
+                                  }
+                                  for (size_t t = 0; t < n; ++t)
+                                  {
+                                      acc[t] += tables[t]->interpolate(r, p) * s;
+                                  } },
+                              n, res.data(), wignerUtils::getMinX(), wignerUtils::getMaxX(), wignerUtils::getMinP(), wignerUtils::getMaxP(),
+                              wignerUtils::getDx(), wignerUtils::getDp(), rBreaks, pBreaks);
+
+    const double h = wignerUtils::getHCut() * 2 * TMath::Pi();
+    for (double &c : res)
+    {
+        c *= h * h * h;
+    }
+    return res;
+}
+//_________________________________________________________________________
+void wignerSource::setDeuteronTables(const std::vector<const wignerTable *> *tables)
+{
+    mTables = (tables && !tables->empty()) ? tables : nullptr;
+    checkObservableTables();
+}
+//_________________________________________________________________________
+void wignerSource::setMixture(const wignerGaussianMixture *mixture)
+{
+    mMixture = mixture;
+}
+//_________________________________________________________________________
+void wignerSource::setCoalPrecision(double precision)
+{
+    if (precision < 0)
+    {
+        std::cerr << "Error: coal precision is negative\n";
+        std::abort();
+    }
+    mCoalPrecision = precision;
+}
+//_________________________________________________________________________
+double wignerSource::getCoalPrecision()
+{
+    return mCoalPrecision;
+}
+//_________________________________________________________________________
+wignerSampler wignerSource::getSampler(bool coalescence)
+{
+    wignerSampler sampler(mRadius, mKStar);
+    if (coalescence)
+    {
+        sampler.setTable(wignerUtils::getDeuteronTable(), wignerUtils::getMinX(), wignerUtils::getMaxX(), wignerUtils::getMinP(),
+                         wignerUtils::getMaxP(), wignerUtils::getDx(), wignerUtils::getDp());
+    }
+    return sampler;
+}
+//_________________________________________________________________________
+void wignerSource::setObservables(const wignerObservables *observables)
+{
+    mObservables = (observables && observables->size() > 0) ? observables : nullptr;
+    checkObservableTables();
+}
+//_________________________________________________________________________
+void wignerSource::checkObservableTables() const
+{
+    if (mObservables && mTables && mTables->size() > 1 && (mObservables->getFactors() & wignerObservables::kDeuteron))
+    {
+        std::cerr << "Error: observables with the deuteron factor need a single deuteron table\n";
+        std::abort();
+    }
+}
+//_________________________________________________________________________
+std::vector<double> wignerSource::getObservables(double *coal, const wignerTable *table)
+{
+    if (!mObservables)
+    {
+        if (coal)
+        {
+            *coal = getcoal();
+        }
+        return {};
+    }
+    const int factors = mObservables->getFactors() | (coal ? wignerObservables::kAll : 0);
+    std::vector<double> rBreaks, pBreaks;
+    if ((factors & wignerObservables::kDeuteron) && table)
+    {
+        table->getBreaks(rBreaks, pBreaks);
+    }
+    else if (factors & wignerObservables::kDeuteron)
+    {
+        wignerUtils::getDeuteronBreaks(rBreaks, pBreaks);
+    }
+
+    const double norm = mNorm, radius = mRadius, kStar = mKStar;
+    const double h = wignerUtils::getHCut() * 2 * TMath::Pi(), h3 = h * h * h;
+    const size_t n = mObservables->size();
+    const wignerObservables &observables = *mObservables;
+    std::vector<double> res(n + 1);
+    wignerCore::integrateMany([&](double r, double p, double *acc)
+                              {
+                                  double w = (factors & wignerObservables::kSource) ? wignerCore::wigner(r, p, norm, radius, kStar) : 1.;
+                                  double j = (factors & wignerObservables::kJacobian) ? wignerCore::jacobian(r, p, radius, kStar) : 1.;
+                                  double d = 0;
+                                  if ((factors & wignerObservables::kDeuteron) && table)
+                                  {
+                                      d = table->interpolate(r, p);
+                                  }
+                                  else if (factors & wignerObservables::kDeuteron)
+                                  {
+                                      double x[2] = {r, p};
+                                      d = wignerUtils::wignerDeuteron(x, nullptr);
+                                  }
+                                  observables.accumulate(r, p, w, j, d * h3, acc);
+                                  acc[n] += d * w * j; },
+                              n + 1, res.data(), wignerUtils::getMinX(), wignerUtils::getMaxX(), wignerUtils::getMinP(), wignerUtils::getMaxP(),
+                              wignerUtils::getDx(), wignerUtils::getDp(), rBreaks, pBreaks);
+    if (coal)
+    {
+        *coal = res[n] * h3;
+    }
+    res.pop_back();
+    return res;
+}
+//_________________________________________________________________________
+void wignerSource::setCorrelation(const wignerCorrelation *correlation)
+{
+    mCorrelation = correlation;
+}
+//_________________________________________________________________________
+double wignerSource::getCorrelation()
+{
+    if (!mCorrelation)
+    {
+        return 0;
+    }
+    updateMoments();
+    return mCorrelation->compute(mKin, mRadius, mEdges, mCumulative);
 }
 //_________________________________________________________________________
 double wignerSource::getDeuteronInt()
@@ -319,6 +670,8 @@ double wignerSource::getDeuteronInt()
 //_________________________________________________________________________
 void wignerSource::reSetNorm()
 {
+    mMarginalDirty = true;
+    mMomentsDirty = true;
     mW->SetParameter(0, mNorm);
     mWxJ->SetParameter(0, mNorm);
     mWxJforItself->SetParameter(0, mNorm);
@@ -334,6 +687,8 @@ void wignerSource::reSetNorm()
 //_________________________________________________________________________
 void wignerSource::reSetRadius()
 {
+    mMarginalDirty = true;
+    mMomentsDirty = true;
     mW->SetParameter(1, mRadius);
     mWxJ->SetParameter(1, mRadius);
     mWxJforItself->SetParameter(1, mRadius);
@@ -349,6 +704,8 @@ void wignerSource::reSetRadius()
 //_________________________________________________________________________
 void wignerSource::reSetKStar()
 {
+    mMarginalDirty = true;
+    mMomentsDirty = true;
     mW->SetParameter(2, mKStar);
     mWxJ->SetParameter(2, mKStar);
     mWxJforItself->SetParameter(2, mKStar);
@@ -392,6 +749,120 @@ void wignerSource::reSetV0()
     mWH->SetParameter(5, mV0);
 }
 //_________________________________________________________________________
+wignerPoint wignerSource::computePoint(double k)
+{
+    wignerPoint pt;
+    pt.k = k;
+
+    if (mCache && k >= 0 && !mTables && !mMap && !mObservables)
+    {
+        // only radius and k* are needed for the key: on a hit even the normalization is skipped
+        mKin = k;
+        mRadius = wignerUtils::radius(k, mR0);
+        mKStar = wignerUtils::kStarEff(k, mRadius);
+        if (mCache->fetch(getCacheKey(), pt))
+        {
+            mNorm = pt.norm;
+            reSetRadius();
+            reSetKStar();
+            reSetNorm();
+            if (mCorrelation)
+            {
+                pt.cf = getCorrelation();
+            }
+            return pt;
+        }
+    }
+
+    setRadiusK(k);
+    if (mMap)
+    {
+        mMap->reset();
+        mMap->setK(k);
+        // the maps of ⟨V⟩ are filled with the radial marginal
+        mMarginalDirty = true;
+    }
+    pt.r0 = getRadius();
+    pt.norm = getNorm();
+    pt.WW = checkWxW();
+    pt.wK = getwK();
+    pt.wV = getwV();
+    pt.wH = getwH();
+    if (mCorrelation)
+    {
+        // on the radial marginal already computed for ⟨K⟩ and ⟨V⟩
+        pt.cf = getCorrelation();
+    }
+    if (mTables)
+    {
+        pt.coalTables = getcoal(*mTables);
+        pt.coal = pt.coalTables[0];
+        if (mObservables)
+        {
+            // the deuteron factor is the table of coal (setObservables() rejects several tables)
+            pt.observables = getObservables(nullptr, (*mTables)[0]);
+        }
+        return pt;
+    }
+    if (mObservables)
+    {
+        // coal of the grid joins the pass of the observables
+        bool fused = !mMixture && !lowRankTable() && !mMap && !wignerUtils::testMode;
+        pt.observables = getObservables(fused ? &pt.coal : nullptr);
+        if (!fused)
+        {
+            pt.coal = getcoal();
+        }
+        return pt;
+    }
+    pt.coal = getcoal();
+
+    if (mCache)
+    {
+        mCache->store(getCacheKey(), pt);
+    }
+    return pt;
+}
+//_________________________________________________________________________
+void wignerSource::setCache(wignerCache *cache)
+{
+    mCache = cache;
+}
+//_________________________________________________________________________
+void wignerSource::setContributionMap(wignerContributionMap *map)
+{
+    mMap = map;
+}
+//_________________________________________________________________________
+wignerCacheKey wignerSource::getCacheKey()
+{
+    wignerCacheKey key;
+    key.params = {mR0, mKin, mRadius, mKStar, mMu, mRWidth, mV0,
+                  wignerUtils::getMinX(), wignerUtils::getMaxX(), wignerUtils::getMinP(), wignerUtils::getMaxP(),
+                  wignerUtils::getDx(), wignerUtils::getDp(), wignerUtils::testMode ? 1. : 0.,
+                  3.}; // revision of the integration scheme: panels split at the breaks, square well from the cumulative marginal
+    if (mPotential)
+    {
+        for (const char *c = mPotential->name(); *c; ++c)
+        {
+            key.params.push_back(*c);
+        }
+        std::vector<double> params = mPotential->getParameters();
+        key.params.insert(key.params.end(), params.begin(), params.end());
+    }
+    if (!mMixture)
+    {
+        if (const wignerLowRankTable *table = lowRankTable())
+        {
+            // coal of the truncated table
+            key.params.push_back(-1.);
+            key.params.push_back(table->getRank());
+        }
+    }
+    key.table = mMixture ? mMixture->checksum() : wignerUtils::getDeuteronChecksum();
+    return key;
+}
+//_________________________________________________________________________
 void wignerSource::SetFromTxt(const std::string& txtfile)
 {
     std::cout << "setting from file \n";
@@ -433,27 +904,5 @@ void wignerSource::SetFromTxt(const std::string& txtfile)
 std::vector<double> wignerSource::readParamsFromFile(const std::string& filename)
 {
     std::cout << "reading parameters\n";
-    std::ifstream infile(filename);
-    std::vector<double> values;
-    std::string line;
-
-    if (!infile.is_open())
-    {
-        std::cerr << "Could not open file: " << filename << "\n";
-        throw std::runtime_error("File open failed.");
-    }
-    std::cout << "setting parameters\n";
-    while (std::getline(infile, line))
-    {
-        std::istringstream iss(line);
-        double val;
-        if (!(iss >> val))
-        {
-            std::cerr << "Warning: skipping invalid or empty line: " << line << "\n";
-            continue;
-        }
-        values.push_back(val);
-    }
-
-    return values;
+    return wignerCore::readParams(filename);
 }
\ No newline at end of file
@@ -0,0 +1,146 @@
+#include "CWignerTable.h"
+#include "CWignerCore.h"
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+//_________________________________________________________________________
+wignerTable::wignerTable(int nx, double xmin, double xmax, int ny, double ymin, double ymax, const std::vector<double> &contents)
+    : mNx(nx), mXMin(xmin), mXMax(xmax), mNy(ny), mYMin(ymin), mYMax(ymax), mContents(contents)
+{
+    if (nx < 1 || ny < 1 || !(xmax > xmin) || !(ymax > ymin) || contents.size() != size_t(nx + 2) * (ny + 2))
+    {
+        std::cerr << "Error: inconsistent deuteron table binning\n";
+        std::abort();
+    }
+}
+//_________________________________________________________________________
+wignerTable wignerTable::read(const std::string &filename)
+{
+    std::ifstream in(filename, std::ios::binary);
+    if (!in.is_open())
+    {
+        std::cerr << "Could not open file: " << filename << "\n";
+        throw std::runtime_error("File open failed.");
+    }
+    uint32_t magic = 0, version = 0;
+    int32_t nx = 0, ny = 0;
+    double xmin = 0, xmax = 0, ymin = 0, ymax = 0;
+    in.read((char *)&magic, sizeof(magic));
+    in.read((char *)&version, sizeof(version));
+    in.read((char *)&nx, sizeof(nx));
+    in.read((char *)&xmin, sizeof(xmin));
+    in.read((char *)&xmax, sizeof(xmax));
+    in.read((char *)&ny, sizeof(ny));
+    in.read((char *)&ymin, sizeof(ymin));
+    in.read((char *)&ymax, sizeof(ymax));
+    if (!in.good() || magic != kMagic || version != kVersion || nx < 1 || ny < 1)
+    {
+        std::cerr << "Error: " << filename << " is not a deuteron table\n";
+        throw std::runtime_error("File open failed.");
+    }
+    std::vector<double> contents(size_t(nx + 2) * (ny + 2));
+    in.read((char *)contents.data(), contents.size() * sizeof(double));
+    if (!in.good())
+    {
+        std::cerr << "Error: " << filename << " is truncated\n";
+        throw std::runtime_error("File open failed.");
+    }
+    return wignerTable(nx, xmin, xmax, ny, ymin, ymax, contents);
+}
+//_________________________________________________________________________
+bool wignerTable::write(const std::string &filename) const
+{
+    std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+    if (!out.is_open())
+    {
+        std::cerr << "Could not open file: " << filename << "\n";
+        return false;
+    }
+    uint32_t magic = kMagic, version = kVersion;
+    int32_t nx = mNx, ny = mNy;
+    out.write((const char *)&magic, sizeof(magic));
+    out.write((const char *)&version, sizeof(version));
+    out.write((const char *)&nx, sizeof(nx));
+    out.write((const char *)&mXMin, sizeof(mXMin));
+    out.write((const char *)&mXMax, sizeof(mXMax));
+    out.write((const char *)&ny, sizeof(ny));
+    out.write((const char *)&mYMin, sizeof(mYMin));
+    out.write((const char *)&mYMax, sizeof(mYMax));
+    out.write((const char *)mContents.data(), mContents.size() * sizeof(double));
+    return out.good();
+}
+//_________________________________________________________________________
+double wignerTable::center(int i, int n, double lo, double hi)
+{
+    double width = (hi - lo) / double(n);
+    return lo + (i - 1) * width + 0.5 * width;
+}
+//_________________________________________________________________________
+int wignerTable::find(double x, int n, double lo, double hi)
+{
+    if (x < lo)
+    {
+        return 0;
+    }
+    if (!(x < hi))
+    {
+        return n + 1;
+    }
+    return 1 + int(n * (x - lo) / (hi - lo));
+}
+//_________________________________________________________________________
+double wignerTable::interpolate(double x, double y) const
+{
+    int binX = find(x, mNx, mXMin, mXMax);
+    int binY = find(y, mNy, mYMin, mYMax);
+    if (binX < 1 || binX > mNx || binY < 1 || binY > mNy)
+    {
+        return 0;
+    }
+
+    // the quadrant of the bin selects the four neighbouring centers
+    double wx = (mXMax - mXMin) / mNx;
+    double wy = (mYMax - mYMin) / mNy;
+    bool right = (mXMin + binX * wx) - x <= wx / 2;
+    bool upper = (mYMin + binY * wy) - y <= wy / 2;
+    int ix1 = right ? binX : binX - 1;
+    int iy1 = upper ? binY : binY - 1;
+    double x1 = center(ix1, mNx, mXMin, mXMax), x2 = center(ix1 + 1, mNx, mXMin, mXMax);
+    double y1 = center(iy1, mNy, mYMin, mYMax), y2 = center(iy1 + 1, mNy, mYMin, mYMax);
+
+    // outside the outer centers both neighbours are the edge bin
+    int bx1 = std::max(find(x1, mNx, mXMin, mXMax), 1);
+    int bx2 = std::min(find(x2, mNx, mXMin, mXMax), mNx);
+    int by1 = std::max(find(y1, mNy, mYMin, mYMax), 1);
+    int by2 = std::min(find(y2, mNy, mYMin, mYMax), mNy);
+
+    double q11 = getBinContent(bx1, by1);
+    double q21 = getBinContent(bx2, by1);
+    double q12 = getBinContent(bx1, by2);
+    double q22 = getBinContent(bx2, by2);
+    double d = 1.0 * (x2 - x1) * (y2 - y1);
+    return 1.0 * q11 / d * (x2 - x) * (y2 - y) + 1.0 * q21 / d * (x - x1) * (y2 - y) +
+           1.0 * q12 / d * (x2 - x) * (y - y1) + 1.0 * q22 / d * (x - x1) * (y - y1);
+}
+//_________________________________________________________________________
+void wignerTable::getBreaks(std::vector<double> &rBreaks, std::vector<double> &pBreaks) const
+{
+    rBreaks = {center(1, mNx, mXMin, mXMax), center(mNx, mNx, mXMin, mXMax), mXMax};
+    pBreaks = {center(1, mNy, mYMin, mYMax), center(mNy, mNy, mYMin, mYMax), mYMax};
+}
+//_________________________________________________________________________
+uint64_t wignerTable::checksum() const
+{
+    std::vector<double> data = {double(mNx), mXMin, mXMax, double(mNy), mYMin, mYMax};
+    for (int i = 0; i <= mNx + 1; ++i)
+    {
+        for (int j = 0; j <= mNy + 1; ++j)
+        {
+            data.push_back(getBinContent(i, j));
+        }
+    }
+    return wignerCore::hash(data.data(), data.size() * sizeof(double));
+}
@@ -0,0 +1,368 @@
+#include "CWignerThreeBody.h"
+#include "CWignerUtils.h"
+#include "TFile.h"
+#include "TH2.h"
+#include "TMath.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <random>
+#include <stdexcept>
+#include <thread>
+
+namespace
+{
+    /// Partial sums of one thread over one round.
+    struct threeBodySums
+    {
+        double coal = 0, coal2 = 0, kin = 0, pot = 0, ww = 0;
+        long n = 0;
+    };
+}
+//_________________________________________________________________________
+wignerGaussianA3::wignerGaussianA3(double b) : mB(b)
+{
+    if (b <= 0)
+    {
+        std::cerr << "Error: nucleus size parameter is not positive\n";
+        std::abort();
+    }
+}
+//_________________________________________________________________________
+double wignerGaussianA3::wigner(const double *x) const
+{
+    double hCut = wignerUtils::getHCut();
+    double r2 = 0, q2 = 0;
+    for (int i = 0; i < 6; ++i)
+    {
+        r2 += x[i] * x[i];
+        q2 += x[6 + i] * x[6 + i];
+    }
+    double norm = 1. / (TMath::Pi() * hCut);
+    norm = norm * norm * norm;
+    norm *= norm;
+    return norm * exp(-r2 / (mB * mB) - mB * mB * q2 / (hCut * hCut));
+}
+//_________________________________________________________________________
+double wignerGaussianA3::getSize() const
+{
+    return mB;
+}
+//_________________________________________________________________________
+wignerHyperTableA3::wignerHyperTableA3(const std::string &filename, const std::string &histname, double size) : mSize(size)
+{
+    TFile file(filename.c_str(), "READ");
+    TH2D *h = file.IsZombie() ? nullptr : (TH2D *)file.Get(histname.c_str());
+    if (!h)
+    {
+        std::cerr << "Could not read " << histname << " from " << filename << "\n";
+        throw std::runtime_error("A=3 Wigner table open failed.");
+    }
+    h->SetDirectory(nullptr);
+    mTable = h;
+}
+//_________________________________________________________________________
+wignerHyperTableA3::~wignerHyperTableA3()
+{
+    delete mTable;
+}
+//_________________________________________________________________________
+double wignerHyperTableA3::wigner(const double *x) const
+{
+    double r2 = 0, q2 = 0;
+    for (int i = 0; i < 6; ++i)
+    {
+        r2 += x[i] * x[i];
+        q2 += x[6 + i] * x[6 + i];
+    }
+    double rh = sqrt(r2), qh = sqrt(q2);
+    const TAxis *xa = mTable->GetXaxis();
+    const TAxis *ya = mTable->GetYaxis();
+    if (rh >= xa->GetXmax() || qh >= ya->GetXmax())
+    {
+        return 0;
+    }
+    // TH2::Interpolate is only defined between the outer bin centers
+    rh = std::max(rh, xa->GetBinCenter(1));
+    qh = std::max(qh, ya->GetBinCenter(1));
+    rh = std::min(rh, xa->GetBinCenter(xa->GetNbins()));
+    qh = std::min(qh, ya->GetBinCenter(ya->GetNbins()));
+    return mTable->Interpolate(rh, qh);
+}
+//_________________________________________________________________________
+double wignerHyperTableA3::getSize() const
+{
+    return mSize;
+}
+//_________________________________________________________________________
+wignerThreeBody::wignerThreeBody(const wignerNucleusA3 *nucleus) : mNucleus(nucleus)
+{
+}
+//_________________________________________________________________________
+void wignerThreeBody::setNucleus(const wignerNucleusA3 *nucleus)
+{
+    mNucleus = nucleus;
+}
+//_________________________________________________________________________
+void wignerThreeBody::setR0(double r0)
+{
+    if (r0 < 0)
+    {
+        std::cerr << "Error: r0 is negative\n";
+        std::abort();
+    }
+    mR0 = r0;
+}
+//_________________________________________________________________________
+void wignerThreeBody::setRadius(double radius)
+{
+    if (radius <= 0)
+    {
+        std::cerr << "Error: source radius is not positive\n";
+        std::abort();
+    }
+    mRadius = radius;
+}
+//_________________________________________________________________________
+void wignerThreeBody::setRadiusK(double k)
+{
+    if (k < 0)
+    {
+        std::cerr << "Error: k is negative\n";
+        std::abort();
+    }
+    mKin = k;
+    mRadius = wignerUtils::radius(k, mR0);
+    mKStar = wignerUtils::kStarEff(k, mRadius);
+}
+//_________________________________________________________________________
+void wignerThreeBody::setMu(double mu)
+{
+    mMu = mu;
+}
+//_________________________________________________________________________
+void wignerThreeBody::setRWidth(double rWidth)
+{
+    mRWidth = rWidth;
+}
+//_________________________________________________________________________
+void wignerThreeBody::setV0(double v0)
+{
+    mV0 = v0;
+}
+//_________________________________________________________________________
+void wignerThreeBody::setThreads(int nThreads)
+{
+    mThreads = nThreads < 1 ? 1 : nThreads;
+}
+//_________________________________________________________________________
+void wignerThreeBody::setTolerance(double relTol)
+{
+    mTolerance = relTol;
+}
+//_________________________________________________________________________
+void wignerThreeBody::setMaxSamples(long maxSamples)
+{
+    mMaxSamples = maxSamples;
+}
+//_________________________________________________________________________
+void wignerThreeBody::setSeed(unsigned long seed)
+{
+    mSeed = seed;
+}
+//_________________________________________________________________________
+void wignerThreeBody::SetFromTxt(const std::string &txtfile)
+{
+    std::vector<double> params = wignerSource::readParamsFromFile(txtfile);
+    if (params.size() < 8)
+    {
+        std::cerr << "Error: expected 8 parameters, got " << params.size() << "\n";
+        return;
+    }
+    setR0(params[0]);
+    setMu(params[1]);
+    setRWidth(params[2]);
+    setV0(params[3]);
+}
+//_________________________________________________________________________
+double wignerThreeBody::getRadius()
+{
+    return mRadius;
+}
+//_________________________________________________________________________
+double wignerThreeBody::getKStar()
+{
+    return mKStar;
+}
+//_________________________________________________________________________
+double wignerThreeBody::getcoal()
+{
+    const wignerNucleusA3 *nucleus = mNucleus ? mNucleus : &mDefaultNucleus;
+    double hCut = wignerUtils::getHCut();
+    double h = 2 * TMath::Pi() * hCut;
+    double h6 = h * h * h;
+    h6 *= h6;
+
+    // source: exp(-x² / (4 R²)) and exp(-4 R² (q - k)² / ħ²)
+    double sigmaR = sqrt(2.) * mRadius;
+    double sigmaQ = hCut / (sqrt(8.) * mRadius);
+    // nucleus envelope exp(-x² / b² - b² q² / ħ²); the proposal is the normalized product
+    double b = nucleus->getSize();
+    double envR = b / sqrt(2.), envQ = hCut / (sqrt(2.) * b);
+    double propR = 1. / sqrt(1. / (sigmaR * sigmaR) + 1. / (envR * envR));
+    double propQ = 1. / sqrt(1. / (sigmaQ * sigmaQ) + 1. / (envQ * envQ));
+    double shiftQ = mKStar * (propQ * propQ) / (sigmaQ * sigmaQ);
+    // log of (2πħ)⁶ W_source at a source sample, up to the Gaussian exponent
+    double logNormWW = 6 * log(h / (2 * TMath::Pi() * sigmaR * sigmaQ));
+    double logRatio = 6 * log(propR / sigmaR) + 6 * log(propQ / sigmaQ);
+    double mass = 2 * mMu;
+    double r2Well = mRWidth * mRWidth;
+
+    auto worker = [&](int thread, int round, long n, threeBodySums &sums)
+    {
+        std::seed_seq seq{(unsigned long)mSeed, (unsigned long)thread, (unsigned long)round};
+        std::mt19937_64 rng(seq);
+        std::normal_distribution<double> gaus(0., 1.);
+        double g[12], xs[12], xq[12];
+        for (long s = 0; s < n; ++s)
+        {
+            double chi2 = 0;
+            for (int i = 0; i < 12; ++i)
+            {
+                g[i] = gaus(rng);
+                chi2 += g[i] * g[i];
+            }
+
+            // proposal sample and its weight W_source / proposal
+            double logW = logRatio + 0.5 * chi2;
+            for (int i = 0; i < 12; ++i)
+            {
+                bool mom = i >= 6;
+                bool shifted = (i == 8 || i == 11); // z components of q_rho and q_lambda
+                xq[i] = (mom ? propQ : propR) * g[i] + (shifted ? shiftQ : 0.);
+                double d = (xq[i] - (shifted ? mKStar : 0.)) / (mom ? sigmaQ : sigmaR);
+                logW -= 0.5 * d * d;
+            }
+            double w = h6 * nucleus->wigner(xq) * exp(logW);
+            sums.coal += w;
+            sums.coal2 += w * w;
+
+            // source sample from the same deviates for the energy moments
+            double q2 = 0;
+            for (int i = 0; i < 12; ++i)
+            {
+                xs[i] = (i < 6 ? sigmaR : sigmaQ) * g[i] + ((i == 8 || i == 11) ? mKStar : 0.);
+                if (i >= 6)
+                {
+                    q2 += xs[i] * xs[i];
+                }
+            }
+            sums.kin += q2 / (2 * mass);
+
+            // pair distances: r1 - r2 = √2 ρ, r1 - r3 = (√2 ρ + √6 λ) / 2, r2 - r3 = (√6 λ - √2 ρ) / 2
+            double d12 = 0, d13 = 0, d23 = 0;
+            for (int i = 0; i < 3; ++i)
+            {
+                double a = sqrt(2.) * xs[i], c = sqrt(6.) * xs[3 + i];
+                d12 += a * a;
+                d13 += 0.25 * (a + c) * (a + c);
+                d23 += 0.25 * (c - a) * (c - a);
+            }
+            sums.pot += mV0 * ((d12 < r2Well) + (d13 < r2Well) + (d23 < r2Well));
+            sums.ww += exp(logNormWW - 0.5 * chi2);
+        }
+        sums.n = n;
+    };
+
+    threeBodySums total;
+    long perRound = 1L << 17;
+    for (int round = 0; total.n < mMaxSamples; ++round)
+    {
+        long n = std::min(perRound, mMaxSamples - total.n);
+        std::vector<threeBodySums> sums(mThreads);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < mThreads; ++t)
+        {
+            long nt = n / mThreads + (t < n % mThreads ? 1 : 0);
+            threads.emplace_back(worker, t, round, nt, std::ref(sums[t]));
+        }
+        for (auto &t : threads)
+        {
+            t.join();
+        }
+        for (const auto &s : sums)
+        {
+            total.coal += s.coal;
+            total.coal2 += s.coal2;
+            total.kin += s.kin;
+            total.pot += s.pot;
+            total.ww += s.ww;
+            total.n += s.n;
+        }
+
+        double mean = total.coal / total.n;
+        double var = std::max(0., total.coal2 / total.n - mean * mean);
+        mCoal = mean;
+        mCoalErr = sqrt(var / total.n);
+        if (mCoalErr <= mTolerance * fabs(mCoal))
+        {
+            break;
+        }
+        perRound = total.n; // double the statistics every round
+    }
+
+    mSamples = total.n;
+    mK = total.kin / total.n;
+    mV = total.pot / total.n;
+    mWW = total.ww / total.n;
+    return mCoal;
+}
+//_________________________________________________________________________
+double wignerThreeBody::getcoalError()
+{
+    return mCoalErr;
+}
+//_________________________________________________________________________
+long wignerThreeBody::getSamples()
+{
+    return mSamples;
+}
+//_________________________________________________________________________
+double wignerThreeBody::getwK()
+{
+    return mK;
+}
+//_________________________________________________________________________
+double wignerThreeBody::getwV()
+{
+    return mV;
+}
+//_________________________________________________________________________
+double wignerThreeBody::checkWxW()
+{
+    return mWW;
+}
+//_________________________________________________________________________
+double wignerThreeBody::getAnalyticGaussianCoal(double b)
+{
+    // product of 1D Gaussian averages: 6 position and 6 momentum components
+    double hCut = wignerUtils::getHCut();
+    double sx = 1 + 4 * mRadius * mRadius / (b * b);
+    double sq = 1 + b * b / (4 * mRadius * mRadius);
+    return 64. / (sx * sx * sx * sq * sq * sq) * exp(-2 * b * b * mKStar * mKStar / (hCut * hCut * sq));
+}
+//_________________________________________________________________________
+wignerPoint wignerThreeBody::computePoint(double k)
+{
+    wignerPoint pt;
+    pt.k = k;
+    setRadiusK(k);
+    pt.r0 = mRadius;
+    pt.norm = 1.;
+    pt.coal = getcoal();
+    pt.WW = checkWxW();
+    pt.wK = getwK();
+    pt.wV = getwV();
+    pt.wH = pt.wK + pt.wV;
+    return pt;
+}
@@ -1,8 +1,15 @@
 #include "CWignerUtils.h"
+#include "CWignerCore.h"
 #include "TMath.h"
 #include "TF2.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <vector>
 
-double wignerUtils::mHCut = 0.1973; // GeV fm
+double wignerUtils::mHCut = wignerCore::kHCut; // GeV fm
 double wignerUtils::mMinX = 0.;
 double wignerUtils::mMaxX = 20.;
 double wignerUtils::mMinP = 0.;
@@ -13,18 +20,15 @@ double wignerUtils::mFactor = sqrt(3. / 8) * mHCut;
 
 TFile *wignerUtils::mFileDeuteron = new TFile("deuteronFunction/wigner2.root", "READ");
 TH2D *wignerUtils::mH = (TH2D *)mFileDeuteron->Get("h");
+unsigned long long wignerUtils::mDeuteronChecksum = 0;
+wignerLowRankTable *wignerUtils::mLowRank = nullptr;
+double wignerUtils::mLowRankTolerance = 1E-4;
 
 bool wignerUtils::testMode = false;
 //_________________________________________________________________________
 double wignerUtils::wignerSource(double *x, double *pm)
 {
-    double r = x[0];
-    double p = x[1];
-
-    double norm = 1. / (TMath::Pi() * mHCut);
-    norm *= norm * norm;
-
-    return pm[0] * norm * TMath::Exp(-r * r * 0.25 / (pm[1] * pm[1]) - 4 * (p * p + pm[2] * pm[2] - 2 * p * pm[2]) * (pm[1] * pm[1]) / (mHCut * mHCut));
+    return wignerCore::wigner(x[0], x[1], pm[0], pm[1], pm[2]);
 }
 //_________________________________________________________________________
 double wignerUtils::wignerSource2(double *x, double *pm)
@@ -34,38 +38,12 @@ double wignerUtils::wignerSource2(double *x, double *pm)
 //_________________________________________________________________________
 double wignerUtils::jacobianFun(double *x, double *pm)
 {
-    double r = x[0];
-    double p = x[1];
-
-    double jacobian = (r * p) * (r * p) * 16 * TMath::Pi() * TMath::Pi();
-
-    float kstarP = pm[2] * p;
-    if (kstarP < 1E-16)
-    {
-        kstarP = 1E-16;
-    }
-    double alpha = 8 * kstarP * pm[1] * pm[1] / (mHCut * mHCut);
-
-    jacobian *= 0.5 * (1 - TMath::Exp(-2 * alpha)) / alpha;
-
-    return wignerSource(x, pm) * jacobian;
+    return wignerSource(x, pm) * wignerCore::jacobian(x[0], x[1], pm[1], pm[2]);
 }
 //_________________________________________________________________________
 double wignerUtils::jacobianW2(double *x, double *pm)
 {
-    double r = x[0];
-    double p = x[1];
-
-    double jacobian = (r * p) * (r * p) * 16 * TMath::Pi() * TMath::Pi();
-
-    float kstarP = pm[2] * p;
-    if (kstarP < 1E-16)
-    {
-        kstarP = 1E-16;
-    }
-    double alpha = 16 * kstarP * pm[1] * pm[1] / (mHCut * mHCut);
-    jacobian *= 0.5 * (1 - TMath::Exp(-2 * alpha)) / alpha;
-    return jacobian * wignerSource(x, pm);
+    return wignerCore::jacobian(x[0], x[1], pm[1], pm[2], true) * wignerSource(x, pm);
 }
 //_________________________________________________________________________
 double wignerUtils::kineticEnergy(double *x, double *pm)
@@ -140,33 +118,62 @@ double wignerUtils::wignerDeuteronIntegral(double *x, double *pm)
 //_________________________________________________________________________
 double wignerUtils::coalescenceProbability(double *x, double *pm)
 {
-    double r = x[0];
-    double p = x[1];
-
-    double jacobian = (r * p) * (r * p) * 16 * TMath::Pi() * TMath::Pi();
-
-    float kstarP = pm[2] * p;
-    if (kstarP < 1E-16)
-    {
-        kstarP = 1E-16;
-    }
-    double alpha = 8 * kstarP * pm[1] * pm[1] / (mHCut * mHCut);
-
-    jacobian *= 0.5 * (1 - TMath::Exp(-2 * alpha)) / alpha;
-
-    return wignerDeuteron(x, pm) * wignerSource(x, pm) * jacobian;
+    return wignerDeuteron(x, pm) * wignerSource(x, pm) * wignerCore::jacobian(x[0], x[1], pm[1], pm[2]);
 }
 //_________________________________________________________________________
 double wignerUtils::radius(double k, double r0)
 {
-    double radiusWave = mFactor / k;
-    return sqrt(radiusWave * radiusWave + r0 * r0);
+    return wignerCore::radius(k, r0);
 }
 //_________________________________________________________________________
 double wignerUtils::kStarEff(double k, double radius)
 {
-    double kstarWave = mFactor / radius;
-    return radius = sqrt(k * k - kstarWave * kstarWave);
+    return wignerCore::kStarEff(k, radius);
+}
+//_________________________________________________________________________
+void wignerUtils::gaussLegendre(int n, std::vector<double> &x, std::vector<double> &w)
+{
+    x.assign(n, 0.);
+    w.assign(n, 0.);
+    for (int i = 0; i < (n + 1) / 2; ++i)
+    {
+        // Newton iteration on P_n starting from the Chebyshev approximation of the root
+        double z = cos(TMath::Pi() * (i + 0.75) / (n + 0.5));
+        double dp = 1;
+        for (int it = 0; it < 100; ++it)
+        {
+            double p0 = 1, p1 = 0;
+            for (int j = 1; j <= n; ++j)
+            {
+                double p2 = p1;
+                p1 = p0;
+                p0 = ((2. * j - 1.) * z * p1 - (j - 1.) * p2) / j;
+            }
+            dp = n * (z * p0 - p1) / (z * z - 1.);
+            double dz = p0 / dp;
+            z -= dz;
+            if (fabs(dz) < 1E-15)
+            {
+                break;
+            }
+        }
+        x[i] = -z;
+        x[n - 1 - i] = z;
+        w[i] = w[n - 1 - i] = 2. / ((1. - z * z) * dp * dp);
+    }
+}
+//_________________________________________________________________________
+double wignerUtils::besselI0Scaled(double x)
+{
+    // Abramowitz & Stegun 9.8.1 / 9.8.2, the same expansion used by TMath::BesselI0
+    double ax = fabs(x);
+    if (ax < 3.75)
+    {
+        double y = (x / 3.75) * (x / 3.75);
+        return exp(-ax) * (1.0 + y * (3.5156229 + y * (3.0899424 + y * (1.2067492 + y * (0.2659732 + y * (0.360768e-1 + y * 0.45813e-2))))));
+    }
+    double y = 3.75 / ax;
+    return (1 / sqrt(ax)) * (0.39894228 + y * (0.1328592e-1 + y * (0.225319e-2 + y * (-0.157565e-2 + y * (0.916281e-2 + y * (-0.2057706e-1 + y * (0.2635537e-1 + y * (-0.1647633e-1 + y * 0.392377e-2))))))));
 }
 //_________________________________________________________________________
 double wignerUtils::getMinX()
@@ -189,6 +196,83 @@ double wignerUtils::getHCut()
     return mHCut;
 }
 //_________________________________________________________________________
+double wignerUtils::getDx()
+{
+    return mDx;
+}
+//_________________________________________________________________________
+double wignerUtils::getDp()
+{
+    return mDp;
+}
+//_________________________________________________________________________
+unsigned long long wignerUtils::getDeuteronChecksum()
+{
+    // called concurrently by the scan workers
+    static std::mutex mutex;
+    std::lock_guard<std::mutex> lock(mutex);
+    if (mDeuteronChecksum == 0)
+    {
+        mDeuteronChecksum = toTable(mH).checksum();
+    }
+    return mDeuteronChecksum;
+}
+//_________________________________________________________________________
+bool wignerUtils::setDeuteronTable(const TString &filename, const TString &histname)
+{
+    TFile *file = TFile::Open(filename, "READ");
+    TH2 *h = (file && !file->IsZombie()) ? dynamic_cast<TH2 *>(file->Get(histname)) : nullptr;
+    if (!h)
+    {
+        std::cerr << "Could not read " << histname << " from " << filename << "\n";
+        delete file;
+        return false;
+    }
+    // the previous table stays alive: TF2 objects of existing sources may still point to it
+    mFileDeuteron = file;
+    mH = (TH2D *)h;
+    mDeuteronChecksum = 0;
+    mLowRank = nullptr;
+    return true;
+}
+//_________________________________________________________________________
+wignerTable wignerUtils::getDeuteronTable()
+{
+    return toTable(mH);
+}
+//_________________________________________________________________________
+const wignerLowRankTable *wignerUtils::getLowRankTable()
+{
+    // called concurrently by the scan workers
+    static std::mutex mutex;
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!mLowRank)
+    {
+        // a previous factorization stays alive: sources may still hold projections of it
+        mLowRank = new wignerLowRankTable(getDeuteronTable(), mLowRankTolerance);
+    }
+    return mLowRank;
+}
+//_________________________________________________________________________
+void wignerUtils::setLowRankTolerance(double tolerance)
+{
+    if (tolerance < 0)
+    {
+        std::cerr << "Error: low-rank tolerance is negative\n";
+        std::abort();
+    }
+    mLowRankTolerance = tolerance;
+    mLowRank = nullptr;
+}
+//_________________________________________________________________________
+void wignerUtils::getDeuteronBreaks(std::vector<double> &rBreaks, std::vector<double> &pBreaks)
+{
+    const TAxis *xaxis = mH->GetXaxis();
+    const TAxis *yaxis = mH->GetYaxis();
+    rBreaks = {xaxis->GetBinCenter(1), xaxis->GetBinCenter(xaxis->GetNbins()), xaxis->GetXmax()};
+    pBreaks = {yaxis->GetBinCenter(1), yaxis->GetBinCenter(yaxis->GetNbins()), yaxis->GetXmax()};
+}
+//_________________________________________________________________________
 double wignerUtils::getMaxP()
 {
     return mMaxP;
@@ -214,6 +298,17 @@ void wignerUtils::setMaxP(double maxP)
     mMaxP = maxP;
 }
 //_________________________________________________________________________
+void wignerUtils::setSteps(double dx, double dp)
+{
+    if (dx <= 0 || dp <= 0)
+    {
+        std::cerr << "Error: integration steps must be positive\n";
+        std::abort();
+    }
+    mDx = dx;
+    mDp = dp;
+}
+//_________________________________________________________________________
 void wignerUtils::setIntegrationRanges(double minX, double maxX, double minP, double maxP)
 {
     setMinX(minX);
@@ -224,21 +319,50 @@ void wignerUtils::setIntegrationRanges(double minX, double maxX, double minP, do
 //_________________________________________________________________________
 double wignerUtils::integral(TF2 *function, double minX, double maxX, double minP, double maxP)
 {
+    return integral(function, {}, {}, minX, maxX, minP, maxP);
+}
+//_________________________________________________________________________
+double wignerUtils::integral(TF2 *function, const std::vector<double> &xBreaks, const std::vector<double> &pBreaks,
+                             double minX, double maxX, double minP, double maxP)
+{
+    if (!testMode)
+    {
+        return wignerCore::integrate([function](double x, double p)
+                                     { return function->Eval(x, p); },
+                                     minX, maxX, minP, maxP, mDx, mDp, xBreaks, pBreaks);
+    }
+    std::vector<double> xEdges = wignerCore::panels(minX, maxX, xBreaks);
+    std::vector<double> pEdges = wignerCore::panels(minP, maxP, pBreaks);
+
     double res = 0;
-    if (testMode == false)
+    for (size_t i = 0; i + 1 < xEdges.size(); ++i)
     {
-        for (float x = mDx / 2 + minX; x < maxX; x += mDx)
+        for (size_t j = 0; j + 1 < pEdges.size(); ++j)
         {
-            for (float p = mDp / 2 + minP; p < maxP; p += mDp)
-            {
-                res += function->Eval(x, p);
-            }
+            res += function->Integral(xEdges[i], xEdges[i + 1], pEdges[j], pEdges[j + 1]);
         }
-        res *= mDx * mDp;
     }
-    else
+    return res;
+}
+//_________________________________________________________________________
+void wignerUtils::gridNodes(double lo, double hi, const std::vector<double> &breaks, double step,
+                            std::vector<double> &nodes, std::vector<double> &widths)
+{
+    wignerCore::gridNodes(lo, hi, breaks, step, nodes, widths);
+}
+//_________________________________________________________________________
+wignerTable wignerUtils::toTable(const TH2 *hist)
+{
+    const TAxis *xaxis = hist->GetXaxis();
+    const TAxis *yaxis = hist->GetYaxis();
+    int nx = xaxis->GetNbins(), ny = yaxis->GetNbins();
+    std::vector<double> contents(size_t(nx + 2) * (ny + 2));
+    for (int j = 0; j <= ny + 1; ++j)
     {
-        res = function->Integral(minX, maxX, minP, maxP);
+        for (int i = 0; i <= nx + 1; ++i)
+        {
+            contents[i + (nx + 2) * j] = hist->GetBinContent(i, j);
+        }
     }
-    return res;
-}
\ No newline at end of file
+    return wignerTable(nx, xaxis->GetXmin(), xaxis->GetXmax(), ny, yaxis->GetXmin(), yaxis->GetXmax(), contents);
+}
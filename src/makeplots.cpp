@@ -0,0 +1,244 @@
+/**
+ * @defgroup MakePlotsApp Compiled Plotting Step
+ * @brief Standalone executable replacing the interpreted macros/makeplots.cpp.
+ * @{
+ */
+
+#include "TCanvas.h"
+#include "TFile.h"
+#include "TGraph.h"
+#include "TROOT.h"
+#include "TTree.h"
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @file makeplots.cpp
+ * @brief Compiled, single-pass version of macros/makeplots.cpp, run in batch mode.
+ *
+ * The macro runs one TTree::Draw per plot, so the tree is read seven times. Here only the
+ * six needed branches are enabled and read once (with implicit multi-threading, the baskets
+ * of the different branches are decompressed in parallel); all graphs are filled from that
+ * single pass and written into one ROOT file, next to one PDF per plot.
+ *
+ * Example usage:
+ * @code
+ *   makeplots --folder simres --input res_merged.root --threads 4
+ * @endcode
+ */
+
+/**
+ * @brief Print the command-line help.
+ * @param prog Program name.
+ */
+static void usage(const char *prog)
+{
+    std::cout << "Usage: " << prog << " --folder <dir> --input <file> [options]\n"
+              << "Options:\n"
+              << "  -f, --folder <dir>   folder holding the input file, plots are written here\n"
+              << "  -i, --input <file>   ROOT file with the merged TTree \"tree\", relative to the folder\n"
+              << "  -o, --output <file>  ROOT file with all graphs, relative to the folder (default: plots.root)\n"
+              << "  -j, --threads <n>    implicit multi-threading threads, 0 = all cores (default: 0)\n"
+              << "  -h, --help           print this message\n";
+}
+
+namespace
+{
+    /// Columns read from the scan tree.
+    enum column
+    {
+        kCoal,
+        kK,
+        kR0,
+        kWH,
+        kWK,
+        kWV,
+        kNColumns
+    };
+
+    /// Branch names of the columns.
+    const char *gColumnNames[kNColumns] = {"coal", "k", "r0", "wH", "wK", "wV"};
+
+    /// Description of one plot.
+    struct plotSpec
+    {
+        column y;             ///< Column on the y axis.
+        column x;             ///< Column on the x axis.
+        const char *title;    ///< Graph title.
+        const char *xaxis;    ///< x-axis title.
+        const char *yaxis;    ///< y-axis title.
+        const char *name;     ///< Base name of the PDF and of the graph in the output file.
+        bool r0Cut;           ///< Only keep 0 <= r0 <= 10 fm.
+    };
+
+    const plotSpec gPlots[] = {
+        {kCoal, kK, "Coalescence Probability vs. k*", "k* (GeV/c)", "P_{coal}", "coal_vs_k", false},
+        {kWH, kK, "Hamiltonian vs. k*", "k* (GeV/c)", "H (GeV)", "hamiltonian_vs_k", false},
+        {kWK, kK, "Kinetic Energy vs. k*", "k* (GeV/c)", "Kinetic Energy (GeV)", "kinetic_vs_k", false},
+        {kWV, kK, "Potential Energy vs. k*", "k* (GeV/c)", "Potential Energy (GeV)", "potential_vs_k", false},
+        {kWH, kR0, "Hamiltonian vs. r_{0}", "r_{0} (fm)", "H (GeV)", "hamiltonian_vs_r0", true},
+        {kWK, kR0, "Kinetic Energy vs. r_{0}", "r_{0} (fm)", "Kinetic Energy (GeV)", "kinetic_vs_r0", true},
+        {kWV, kR0, "Potential Energy vs. r_{0}", "r_{0} (fm)", "Potential Energy (GeV)", "potential_vs_r0", true},
+    };
+}
+
+/**
+ * @brief Generate and save plots from Wigner simulation output stored in a ROOT file.
+ *
+ * Same plots as macros/makeplots.cpp (coal, wH, wK, wV vs. k* and wH, wK, wV vs. r0, the
+ * latter with 0 <= r0 <= 10 fm), saved as one `.pdf` per plot and as graphs named after
+ * the plots in a single ROOT file.
+ *
+ * @param folder    Path to the output folder where plots will be saved.
+ * @param filename  Name of the input ROOT file inside the folder.
+ * @param output    Name of the output ROOT file inside the folder.
+ * @return True on success.
+ */
+static bool makeplots(const char *folder, const char *filename, const char *output)
+{
+    TString filepath = TString::Format("%s/%s", folder, filename);
+
+    std::unique_ptr<TFile> file(TFile::Open(filepath));
+    if (!file || file->IsZombie())
+    {
+        std::cerr << "Error: could not open file " << filepath << std::endl;
+        return false;
+    }
+
+    TTree *tree = (TTree *)file->Get("tree");
+    if (!tree)
+    {
+        std::cerr << "Error: TTree 'tree' not found in file " << filepath << std::endl;
+        return false;
+    }
+
+    // read only the needed columns, in one pass
+    double values[kNColumns];
+    tree->SetBranchStatus("*", false);
+    for (int c = 0; c < kNColumns; ++c)
+    {
+        if (!tree->GetBranch(gColumnNames[c]))
+        {
+            std::cerr << "Error: '" << gColumnNames[c] << "' branch not found in the tree." << std::endl;
+            return false;
+        }
+        tree->SetBranchStatus(gColumnNames[c], true);
+        tree->SetBranchAddress(gColumnNames[c], &values[c]);
+    }
+
+    long long n = tree->GetEntries();
+    std::vector<double> columns[kNColumns];
+    for (auto &col : columns)
+    {
+        col.reserve(n);
+    }
+    for (long long i = 0; i < n; ++i)
+    {
+        tree->GetEntry(i);
+        for (int c = 0; c < kNColumns; ++c)
+        {
+            columns[c].push_back(values[c]);
+        }
+    }
+    file->Close();
+
+    TString root_path = TString::Format("%s/%s", folder, output);
+    TFile outfile(root_path, "RECREATE");
+    if (outfile.IsZombie())
+    {
+        std::cerr << "Error: could not create " << root_path << std::endl;
+        return false;
+    }
+
+    for (const auto &plot : gPlots)
+    {
+        TGraph *gr = new TGraph();
+        for (long long i = 0; i < n; ++i)
+        {
+            double r0 = columns[kR0][i];
+            if (plot.r0Cut && (r0 < 0 || r0 > 10))
+            {
+                continue;
+            }
+            gr->SetPoint(gr->GetN(), columns[plot.x][i], columns[plot.y][i]);
+        }
+        if (gr->GetN() == 0)
+        {
+            std::cerr << "Warning: no points for " << gColumnNames[plot.y] << " vs " << gColumnNames[plot.x] << std::endl;
+            delete gr;
+            continue;
+        }
+        gr->SetName(plot.name);
+        gr->SetTitle(Form("%s;%s;%s", plot.title, plot.xaxis, plot.yaxis));
+        gr->SetMarkerStyle(20);
+        gr->SetMarkerSize(1.2);
+
+        TCanvas *c = new TCanvas(Form("c_%s_vs_%s", gColumnNames[plot.y], gColumnNames[plot.x]), plot.title, 800, 600);
+        c->SetGrid();
+        gr->Draw("AP");
+        c->SaveAs(TString::Format("%s/%s.pdf", folder, plot.name));
+
+        outfile.cd();
+        gr->Write(plot.name);
+        delete c;
+        delete gr;
+    }
+
+    outfile.Close();
+    std::cout << "Wrote " << root_path << std::endl;
+    return true;
+}
+
+/**
+ * @brief Entry point of the compiled plotting step.
+ * @param argc Argument count.
+ * @param argv Argument vector.
+ * @return Exit code.
+ */
+int main(int argc, char **argv)
+{
+    std::string folder, input;
+    std::string output = "plots.root";
+    int threads = 0;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if ((arg == "-f" || arg == "--folder") && i + 1 < argc)
+            folder = argv[++i];
+        else if ((arg == "-i" || arg == "--input") && i + 1 < argc)
+            input = argv[++i];
+        else if ((arg == "-o" || arg == "--output") && i + 1 < argc)
+            output = argv[++i];
+        else if ((arg == "-j" || arg == "--threads") && i + 1 < argc)
+            threads = std::stoi(argv[++i]);
+        else if (arg == "-h" || arg == "--help")
+        {
+            usage(argv[0]);
+            return 0;
+        }
+        else
+        {
+            std::cerr << "Error: invalid option " << arg << "\n";
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (folder.empty() || input.empty())
+    {
+        usage(argv[0]);
+        return 1;
+    }
+
+    gROOT->SetBatch(true);
+    if (threads != 1)
+    {
+        ROOT::EnableImplicitMT(threads > 0 ? threads : std::thread::hardware_concurrency());
+    }
+    return makeplots(folder.c_str(), input.c_str(), output.c_str()) ? 0 : 1;
+}
+/// @}
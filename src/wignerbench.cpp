@@ -0,0 +1,448 @@
+/**
+ * @defgroup WignerBenchApp Accuracy-versus-Cost Harness
+ * @brief Compares the integration modes against high-precision golden data.
+ * @{
+ */
+
+#include "CWignerAnisotropicSource.h"
+#include "CWignerSource.h"
+#include "CWignerUtils.h"
+#include "TROOT.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @file wignerbench.cpp
+ * @brief Accuracy-versus-CPU-time table of the integration modes.
+ *
+ * The reference values of a fixed set of (k*, r0, V0) points are computed once with the
+ * panel integrator on a fine grid and one Richardson step (grid step halved), and stored as
+ * golden data. Every mode (midpoint grid at several steps, TF2::Integral, anisotropic source
+ * with equal radii) is then run on the same points; for each one the largest relative error
+ * of every observable and the CPU time are reported, and the Pareto-optimal settings are marked.
+ *
+ * The reference shares the midpoint integrator of the grid and aniso rows, whose errors
+ * therefore measure self-convergence only; the tf2 row is the comparison with an independent
+ * integration.
+ *
+ * Example usage:
+ * @code
+ *   wignerbench --make-golden --golden config/golden.txt --threads 8
+ *   wignerbench --golden config/golden.txt --target 1e-3 --threads 8
+ * @endcode
+ */
+
+namespace
+{
+    /// Observables compared against the golden data.
+    const char *gObservables[] = {"norm", "WW", "wK", "wV", "wH", "coal"};
+    const int kNObservables = 6;
+
+    /// One benchmark point and its observables.
+    struct benchPoint
+    {
+        double k = 0, r0 = 1, v0 = 0;
+        double obs[kNObservables] = {0, 0, 0, 0, 0, 0};
+    };
+
+    /// One integration setting.
+    struct benchMode
+    {
+        std::string name;  ///< "grid", "tf2" or "aniso".
+        double dx = 0.01;  ///< Grid step in r.
+        double dp = 0.001; ///< Grid step in p.
+    };
+
+    /// Physics parameters shared by all points.
+    struct benchConfig
+    {
+        double mu = 0.469, rWidth = 3.2;
+        double minX = 0, maxX = 20, minP = 0, maxP = 0.6;
+    };
+}
+
+/**
+ * @brief Print the command-line help.
+ * @param prog Program name.
+ */
+static void usage(const char *prog)
+{
+    std::cout << "Usage: " << prog << " [--make-golden] [options]\n"
+              << "Options:\n"
+              << "      --make-golden      compute the reference values and write the golden file\n"
+              << "  -g, --golden <file>    golden data file (default: config/golden.txt)\n"
+              << "  -c, --config <file>    parameter file for mu and rWidth (default: config/default.txt)\n"
+              << "      --ref-steps <dx,dp> grid steps of the reference (default: 0.0025,0.00025)\n"
+              << "      --target <e>       accuracy target for the recommendation (default: 1e-3)\n"
+              << "  -j, --threads <n>      threads, points are computed in parallel (default: 1)\n"
+              << "  -h, --help             print this message\n";
+}
+
+/**
+ * @brief Compute the observables of all points with the current wignerUtils settings.
+ * @param mode    Integration mode.
+ * @param config  Physics parameters.
+ * @param points  Points, observables are overwritten.
+ * @param threads Number of threads.
+ */
+static void computeAll(const benchMode &mode, const benchConfig &config, std::vector<benchPoint> &points, int threads)
+{
+    // unique TF2 names across calls
+    static int call = 0;
+    ++call;
+    wignerUtils::setSteps(mode.dx, mode.dp);
+    auto work = [&](int worker)
+    {
+        wignerSource fw(TString::Format("_bench%d_%d", call, worker));
+        wignerAnisotropicSource fwA;
+        if (mode.name == "aniso")
+        {
+            fwA.setMu(config.mu);
+            fwA.setRWidth(config.rWidth);
+        }
+        else
+        {
+            fw.initFunctions(mode.name == "tf2");
+            fw.setMu(config.mu);
+            fw.setRWidth(config.rWidth);
+        }
+
+        for (size_t i = worker; i < points.size(); i += threads)
+        {
+            benchPoint &pt = points[i];
+            wignerPoint res;
+            if (mode.name == "aniso")
+            {
+                fwA.setR0(pt.r0, pt.r0, pt.r0);
+                fwA.setV0(pt.v0);
+                res = fwA.computePoint(pt.k);
+            }
+            else
+            {
+                fw.setR0(pt.r0);
+                fw.setV0(pt.v0);
+                res = fw.computePoint(pt.k);
+            }
+            double values[kNObservables] = {res.norm, res.WW, res.wK, res.wV, res.wH, res.coal};
+            std::copy(values, values + kNObservables, pt.obs);
+        }
+    };
+
+    if (threads == 1)
+    {
+        work(0);
+        return;
+    }
+    ROOT::EnableThreadSafety();
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t)
+    {
+        workers.emplace_back(work, t);
+    }
+    for (auto &t : workers)
+    {
+        t.join();
+    }
+}
+
+/**
+ * @brief Compute the golden data: grid at (dx, dp) and (dx/2, dp/2), extrapolated for a
+ * second-order scheme.
+ * @param config  Physics parameters.
+ * @param dx      Reference step in r.
+ * @param dp      Reference step in p.
+ * @param threads Number of threads.
+ * @return Points with the reference observables.
+ */
+static std::vector<benchPoint> makeGolden(const benchConfig &config, double dx, double dp, int threads)
+{
+    std::vector<benchPoint> coarse;
+    for (double k : {0.02, 0.15, 0.5})
+    {
+        for (double r0 : {1., 3.})
+        {
+            for (double v0 : {-17.4E-3, -35E-3})
+            {
+                benchPoint pt;
+                pt.k = k;
+                pt.r0 = r0;
+                pt.v0 = v0;
+                coarse.push_back(pt);
+            }
+        }
+    }
+    std::vector<benchPoint> fine = coarse;
+    computeAll({"grid", dx, dp}, config, coarse, threads);
+    computeAll({"grid", dx / 2, dp / 2}, config, fine, threads);
+    for (size_t i = 0; i < fine.size(); ++i)
+    {
+        for (int o = 0; o < kNObservables; ++o)
+        {
+            fine[i].obs[o] = (4 * fine[i].obs[o] - coarse[i].obs[o]) / 3;
+        }
+    }
+    return fine;
+}
+
+/**
+ * @brief Write the golden data, with the reference settings in the header.
+ * @param filename Output file.
+ * @param points   Reference points.
+ * @param config   Physics parameters.
+ * @param dx       Reference step in r.
+ * @param dp       Reference step in p.
+ * @return True on success.
+ */
+static bool writeGolden(const std::string &filename, const std::vector<benchPoint> &points, const benchConfig &config,
+                        double dx, double dp)
+{
+    std::ofstream out(filename);
+    if (!out.is_open())
+    {
+        std::cerr << "Error: could not create " << filename << "\n";
+        return false;
+    }
+    out << "# wignerbench golden data, mu = " << config.mu << ", rWidth = " << config.rWidth << "\n"
+        << "# ranges r [" << config.minX << ", " << config.maxX << "] fm, p [" << config.minP << ", " << config.maxP << "] GeV/c\n"
+        << "# deuteron table checksum " << std::hex << wignerUtils::getDeuteronChecksum() << std::dec << "\n"
+        << "# reference: midpoint grid at dx = " << dx << ", dp = " << dp << " and at dx/2, dp/2, extrapolated as (4 f(h/2) - f(h)) / 3\n"
+        << "# it shares the integrator of the grid and aniso rows, whose errors only measure self-convergence;\n"
+        << "# the tf2 row is the comparison with an independent integration\n"
+        << "# k r0 V0 norm WW wK wV wH coal\n";
+    out.precision(17);
+    for (const auto &pt : points)
+    {
+        out << pt.k << " " << pt.r0 << " " << pt.v0;
+        for (double v : pt.obs)
+        {
+            out << " " << v;
+        }
+        out << "\n";
+    }
+    return true;
+}
+
+/**
+ * @brief Read the golden data.
+ * @param filename Input file.
+ * @param points   Filled with the reference points.
+ * @return True on success.
+ */
+static bool readGolden(const std::string &filename, std::vector<benchPoint> &points)
+{
+    std::ifstream in(filename);
+    if (!in.is_open())
+    {
+        std::cerr << "Error: could not open " << filename << " (create it with --make-golden)\n";
+        return false;
+    }
+    std::string line;
+    while (std::getline(in, line))
+    {
+        if (line.empty() || line[0] == '#')
+        {
+            continue;
+        }
+        std::istringstream iss(line);
+        benchPoint pt;
+        iss >> pt.k >> pt.r0 >> pt.v0;
+        for (double &v : pt.obs)
+        {
+            iss >> v;
+        }
+        if (iss.fail())
+        {
+            std::cerr << "Error: malformed line in " << filename << ": " << line << "\n";
+            return false;
+        }
+        points.push_back(pt);
+    }
+    return !points.empty();
+}
+
+/**
+ * @brief Entry point of the harness.
+ * @param argc Argument count.
+ * @param argv Argument vector.
+ * @return Exit code.
+ */
+int main(int argc, char **argv)
+{
+    bool makeGoldenData = false;
+    std::string golden = "config/golden.txt";
+    std::string configFile = "config/default.txt";
+    double refDx = 0.0025, refDp = 0.00025;
+    double target = 1E-3;
+    int threads = 1;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        auto value = [&]() -> std::string
+        {
+            if (i + 1 >= argc)
+            {
+                std::cerr << "Error: missing value for " << arg << "\n";
+                std::exit(1);
+            }
+            return argv[++i];
+        };
+
+        if (arg == "--make-golden")
+            makeGoldenData = true;
+        else if (arg == "-g" || arg == "--golden")
+            golden = value();
+        else if (arg == "-c" || arg == "--config")
+            configFile = value();
+        else if (arg == "--ref-steps")
+        {
+            if (std::sscanf(value().c_str(), "%lf,%lf", &refDx, &refDp) != 2)
+            {
+                std::cerr << "Error: --ref-steps expects dx,dp\n";
+                return 1;
+            }
+        }
+        else if (arg == "--target")
+            target = std::stod(value());
+        else if (arg == "-j" || arg == "--threads")
+            threads = std::max(1, std::stoi(value()));
+        else if (arg == "-h" || arg == "--help")
+        {
+            usage(argv[0]);
+            return 0;
+        }
+        else
+        {
+            std::cerr << "Error: unknown option " << arg << "\n";
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    std::vector<double> params = wignerSource::readParamsFromFile(configFile);
+    if (params.size() < 8)
+    {
+        std::cerr << "Error: expected 8 parameters in " << configFile << "\n";
+        return 1;
+    }
+    benchConfig config;
+    config.mu = params[1];
+    config.rWidth = params[2];
+    config.minX = params[4];
+    config.minP = params[5];
+    config.maxX = params[6];
+    config.maxP = params[7];
+    wignerUtils::setIntegrationRanges(config.minX, config.maxX, config.minP, config.maxP);
+
+    if (makeGoldenData)
+    {
+        std::vector<benchPoint> points = makeGolden(config, refDx, refDp, threads);
+        if (!writeGolden(golden, points, config, refDx, refDp))
+        {
+            return 1;
+        }
+        std::cout << "Wrote " << points.size() << " reference points to " << golden << "\n";
+        return 0;
+    }
+
+    std::vector<benchPoint> reference;
+    if (!readGolden(golden, reference))
+    {
+        return 1;
+    }
+
+    std::vector<benchMode> modes;
+    for (double dx : {0.04, 0.02, 0.01, 0.005})
+    {
+        modes.push_back({"grid", dx, dx / 10});
+        modes.push_back({"aniso", dx, dx / 10});
+    }
+    modes.push_back({"tf2", 0.01, 0.001});
+
+    struct benchRow
+    {
+        benchMode mode;
+        double cpu = 0;
+        double err[kNObservables] = {0, 0, 0, 0, 0, 0};
+        double maxErr = 0;
+        bool pareto = true;
+    };
+    std::vector<benchRow> rows;
+    for (const auto &mode : modes)
+    {
+        std::vector<benchPoint> points = reference;
+        std::clock_t start = std::clock();
+        computeAll(mode, config, points, threads);
+        benchRow row;
+        row.mode = mode;
+        row.cpu = double(std::clock() - start) / CLOCKS_PER_SEC;
+        for (size_t i = 0; i < points.size(); ++i)
+        {
+            for (int o = 0; o < kNObservables; ++o)
+            {
+                double ref = reference[i].obs[o];
+                double err = fabs(points[i].obs[o] - ref) / std::max(fabs(ref), 1E-300);
+                row.err[o] = std::max(row.err[o], err);
+            }
+        }
+        row.maxErr = *std::max_element(row.err, row.err + kNObservables);
+        rows.push_back(row);
+    }
+
+    // Pareto front: no other setting is both cheaper and more accurate
+    for (auto &a : rows)
+    {
+        for (const auto &b : rows)
+        {
+            if (b.cpu < a.cpu && b.maxErr < a.maxErr)
+            {
+                a.pareto = false;
+                break;
+            }
+        }
+    }
+    std::sort(rows.begin(), rows.end(), [](const benchRow &a, const benchRow &b)
+              { return a.cpu < b.cpu; });
+
+    std::printf("%-6s %8s %8s %9s", "mode", "dx", "dp", "cpu[s]");
+    for (const char *name : gObservables)
+    {
+        std::printf(" %9s", name);
+    }
+    std::printf(" %9s  pareto\n", "max");
+    const benchRow *best = nullptr;
+    for (const auto &row : rows)
+    {
+        std::printf("%-6s %8.4g %8.4g %9.3f", row.mode.name.c_str(), row.mode.dx, row.mode.dp, row.cpu);
+        for (double e : row.err)
+        {
+            std::printf(" %9.2e", e);
+        }
+        std::printf(" %9.2e  %s\n", row.maxErr, row.pareto ? "*" : "");
+        if (!best && row.maxErr <= target)
+        {
+            best = &row;
+        }
+    }
+    // the WW column is the deviation of checkWxW() from its reference (1 up to the grid error)
+    if (best)
+    {
+        std::printf("Cheapest setting with all relative errors <= %g: %s dx = %g dp = %g (%.3f s)\n",
+                    target, best->mode.name.c_str(), best->mode.dx, best->mode.dp, best->cpu);
+    }
+    else
+    {
+        std::printf("No setting reaches a relative error of %g\n", target);
+    }
+    return 0;
+}
+/// @}
@@ -0,0 +1,165 @@
+/**
+ * @defgroup WignerCoreTestApp Core Library Test
+ * @brief Self-checking executable for the ROOT-free WignerCore library, run by ctest.
+ * @{
+ */
+
+#include "CWignerCoreSource.h"
+#include "CWignerGaussianMixture.h"
+#include "CWignerOverlap.h"
+#include "CWignerTable.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/**
+ * @file wignercoretest.cpp
+ * @brief Checks the binary table format and the core numerics against closed forms.
+ *
+ * The deuteron state is a Gaussian, ψ(r) ∝ exp(-r² / 4σ²), whose Wigner function is known:
+ * W_d(r, p) = (πħ)⁻³ exp(-r² / 2σ² - 2σ² p² / ħ²). The test tabulates it, and checks that
+ *  - the table and a Gaussian mixture survive a write/read round trip with the same checksum,
+ *    and that a truncated table file is rejected;
+ *  - coal of wignerCoreSource on the table agrees with wignerOverlap on u(r) = √(4π) r ψ(r) and
+ *    with the one-component wignerGaussianMixture, both exact for this state, and with the
+ *    mixture fitted to the table.
+ *
+ * The closed forms normalize the source on the whole phase space and wignerCoreSource on the
+ * integration range, so they are compared at the normalization of the grid. The remaining
+ * difference is the bilinear interpolation of the table and the grid steps.
+ *
+ * Usage (from ctest, in the build directory):
+ * @code
+ *   wignercoretest
+ * @endcode
+ * The exit code is the number of failed checks.
+ */
+
+namespace
+{
+    int gFailures = 0; ///< Number of failed checks.
+
+    /**
+     * @brief Record a check.
+     * @param ok   Result.
+     * @param what Description printed with the result.
+     */
+    void check(bool ok, const std::string &what)
+    {
+        std::printf("%s %s\n", ok ? "[ ok ]" : "[FAIL]", what.c_str());
+        if (!ok)
+        {
+            ++gFailures;
+        }
+    }
+
+    /// @brief Relative difference of a and b.
+    double relative(double a, double b)
+    {
+        return std::fabs(a - b) / std::max(std::fabs(a), std::fabs(b));
+    }
+}
+
+int main()
+{
+    const double hCut = wignerCore::kHCut, pi = wignerCore::kPi, sigma = 1.5;
+    const double a = 0.5 / (sigma * sigma), b = 2 * sigma * sigma / (hCut * hCut), c = 1. / std::pow(pi * hCut, 3);
+
+    // Gaussian deuteron table on the ranges of the default grid
+    const int nx = 200, ny = 150;
+    const double xMax = 20., yMax = 0.6;
+    std::vector<double> contents((nx + 2) * (ny + 2), 0.);
+    for (int i = 1; i <= nx; ++i)
+    {
+        for (int j = 1; j <= ny; ++j)
+        {
+            double r = (i - 0.5) * xMax / nx, p = (j - 0.5) * yMax / ny;
+            contents[i + (nx + 2) * j] = c * std::exp(-a * r * r - b * p * p);
+        }
+    }
+    wignerTable table(nx, 0., xMax, ny, 0., yMax, contents);
+
+    // binary round trips
+    const std::string tableFile = "wignercoretest_table.bin", mixtureFile = "wignercoretest_table.mix";
+    check(table.write(tableFile), "write " + tableFile);
+    wignerTable copy = wignerTable::read(tableFile);
+    bool same = copy.getNx() == nx && copy.getNy() == ny && copy.getXMax() == xMax && copy.getYMax() == yMax;
+    for (int i = 0; i < nx + 2 && same; ++i)
+    {
+        for (int j = 0; j < ny + 2 && same; ++j)
+        {
+            same = copy.getBinContent(i, j) == table.getBinContent(i, j);
+        }
+    }
+    check(same, "table contents after write/read");
+    check(copy.checksum() == table.checksum(), "table checksum after write/read");
+    check(copy.interpolate(1.234, 0.0567) == table.interpolate(1.234, 0.0567), "table interpolation after write/read");
+
+    // a file cut after the header must be rejected
+    std::vector<char> head(64);
+    std::FILE *f = std::fopen(tableFile.c_str(), "rb");
+    bool truncated = f && std::fread(head.data(), 1, head.size(), f) == head.size();
+    if (f)
+    {
+        std::fclose(f);
+    }
+    f = std::fopen(tableFile.c_str(), "wb");
+    if (f)
+    {
+        truncated = truncated && std::fwrite(head.data(), 1, head.size(), f) == head.size();
+        std::fclose(f);
+    }
+    bool rejected = false;
+    try
+    {
+        wignerTable::read(tableFile);
+    }
+    catch (const std::runtime_error &)
+    {
+        rejected = true;
+    }
+    check(truncated && rejected, "truncated table file rejected");
+    std::remove(tableFile.c_str());
+
+    wignerGaussianMixture exact({a}, {b}, {c});
+    check(exact.write(mixtureFile), "write " + mixtureFile);
+    wignerGaussianMixture exactCopy = wignerGaussianMixture::read(mixtureFile);
+    check(exactCopy.checksum() == exact.checksum() && exactCopy.evaluate(1.5, 0.1) == exact.evaluate(1.5, 0.1),
+          "mixture checksum and values after write/read");
+    std::remove(mixtureFile.c_str());
+
+    // coal of the grid against the closed forms
+    double step = 0.005;
+    std::vector<double> u(4001);
+    for (size_t i = 0; i < u.size(); ++i)
+    {
+        double r = i * step;
+        u[i] = std::sqrt(4 * pi) * r * std::pow(2 * pi * sigma * sigma, -0.75) * std::exp(-0.25 * r * r / (sigma * sigma));
+    }
+    wignerOverlap overlap(step, u);
+    wignerGaussianMixture fitted = wignerGaussianMixture::fit(table, 1E-3);
+    wignerCoreSource source(&table);
+    for (double r0 : {1., 3.})
+    {
+        for (double k : {0.02, 0.15})
+        {
+            source.setR0(r0);
+            wignerPoint pt = source.computePoint(k);
+            double coalOverlap = overlap.coal(pt.r0, source.getKStar()) * pt.norm;
+            double coalExact = exact.coal(pt.r0, source.getKStar(), pt.norm);
+            double coalFitted = fitted.coal(pt.r0, source.getKStar(), pt.norm);
+            char what[256];
+            std::snprintf(what, sizeof(what), "r0 = %g fm, k* = %g GeV/c: grid %.6g, overlap %.6g, mixture %.6g, fit %.6g",
+                          r0, k, pt.coal, coalOverlap, coalExact, coalFitted);
+            check(relative(pt.coal, coalOverlap) < 5E-3 && relative(pt.coal, coalExact) < 5E-3 && relative(pt.coal, coalFitted) < 1E-2,
+                  what);
+        }
+    }
+
+    std::printf("%d failed check(s)\n", gFailures);
+    return gFailures;
+}
+/// @}
@@ -0,0 +1,232 @@
+/**
+ * @defgroup WignerDaemonApp Query Daemon
+ * @brief Standalone executable serving coalescence queries over a Unix domain socket.
+ * @{
+ */
+
+#include "CWignerCache.h"
+#include "CWignerDaemon.h"
+#include "CWignerProtocol.h"
+#include "CWignerUtils.h"
+#include <csignal>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @file wignerd.cpp
+ * @brief Long-running daemon answering batched (k*, r0) queries, see CWignerProtocol.h.
+ *
+ * The daemon loads the configuration, the deuteron table and the cache once; clients such as
+ * a transport code include the ROOT-free CWignerProtocol.h and keep a connection open, so a
+ * query costs neither a process startup nor a table load. SIGINT and SIGTERM stop it cleanly
+ * and print the statistics.
+ *
+ * Example usage:
+ * @code
+ *   wignerd --socket /tmp/wignerd.sock --threads 8 --cache /tmp/wcache --report 60 &
+ *   wignerd --socket /tmp/wignerd.sock --query 0.05,1.2 --query 0.1,1.2
+ *   wignerd --socket /tmp/wignerd.sock --stats
+ * @endcode
+ */
+
+namespace
+{
+    wignerDaemon *gDaemon = nullptr; ///< Daemon stopped by the signal handler.
+
+    /// Stop the daemon on SIGINT / SIGTERM.
+    void onSignal(int)
+    {
+        if (gDaemon)
+        {
+            gDaemon->stop();
+        }
+    }
+}
+
+/**
+ * @brief Print the command-line help.
+ * @param prog Program name.
+ */
+static void usage(const char *prog)
+{
+    std::cout << "Usage: " << prog << " [--socket <path>] [options]\n"
+              << "       " << prog << " [--socket <path>] --query <k>,<r0> [--query ...] | --stats\n"
+              << "Options:\n"
+              << "  -s, --socket <path>    Unix domain socket (default: /tmp/wignerd.sock)\n"
+              << "  -c, --config <file>    parameter file (default: config/default.txt)\n"
+              << "  -j, --threads <n>      worker threads, 0 = all cores (default: 1)\n"
+              << "      --deuteron <file>  deuteron Wigner table (TH2D \"h\", e.g. from wignertable)\n"
+              << "      --cache <dir>      persistent result cache, shared with wignersim\n"
+              << "      --cache-size <n>   maximum number of cached points (default: 100000)\n"
+              << "      --memo-size <n>    points kept in memory, 0 to disable (default: 1000000)\n"
+              << "      --report <s>       print the statistics every s seconds (default: at exit only)\n"
+              << "  -v, --verbose          print one line per request\n"
+              << "      --query <k>,<r0>   client: ask a running daemon for one point (repeatable, one batch)\n"
+              << "      --stats            client: print the statistics of a running daemon\n"
+              << "  -h, --help             print this message\n";
+}
+
+/**
+ * @brief Entry point of the daemon.
+ * @param argc Argument count.
+ * @param argv Argument vector.
+ * @return Exit code.
+ */
+int main(int argc, char **argv)
+{
+    std::string socketPath = "/tmp/wignerd.sock";
+    std::string config = "config/default.txt";
+    int threads = 1;
+    std::string deuteron;
+    std::string cacheDir;
+    size_t cacheSize = 100000;
+    size_t memoSize = 1000000;
+    double report = 0;
+    bool verbose = false;
+    std::vector<wignerQueryPoint> queries;
+    bool stats = false;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        auto value = [&]() -> std::string
+        {
+            if (i + 1 >= argc)
+            {
+                std::cerr << "Error: missing value for " << arg << "\n";
+                std::exit(1);
+            }
+            return argv[++i];
+        };
+
+        if (arg == "-s" || arg == "--socket")
+            socketPath = value();
+        else if (arg == "-c" || arg == "--config")
+            config = value();
+        else if (arg == "-j" || arg == "--threads")
+            threads = std::stoi(value());
+        else if (arg == "--deuteron")
+            deuteron = value();
+        else if (arg == "--cache")
+            cacheDir = value();
+        else if (arg == "--cache-size")
+            cacheSize = std::stoul(value());
+        else if (arg == "--memo-size")
+            memoSize = std::stoul(value());
+        else if (arg == "--report")
+            report = std::stod(value());
+        else if (arg == "-v" || arg == "--verbose")
+            verbose = true;
+        else if (arg == "--query")
+        {
+            std::stringstream ss(value());
+            std::string item;
+            std::vector<double> values;
+            while (std::getline(ss, item, ','))
+                values.push_back(std::stod(item));
+            if (values.size() != 2)
+            {
+                std::cerr << "Error: --query expects <k>,<r0>\n";
+                return 1;
+            }
+            wignerQueryPoint q;
+            q.k = values[0];
+            q.r0 = values[1];
+            queries.push_back(q);
+        }
+        else if (arg == "--stats")
+            stats = true;
+        else if (arg == "-h" || arg == "--help")
+        {
+            usage(argv[0]);
+            return 0;
+        }
+        else
+        {
+            std::cerr << "Error: unknown option " << arg << "\n";
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    // client modes
+    if (stats || !queries.empty())
+    {
+        wignerClient client;
+        if (!client.open(socketPath))
+        {
+            std::cerr << "Error: no daemon listening on " << socketPath << "\n";
+            return 1;
+        }
+        if (!queries.empty())
+        {
+            std::vector<wignerReplyPoint> replies;
+            uint32_t status = client.query(queries, replies);
+            if (status != wignerProtocol::kOk)
+            {
+                std::cerr << "Error: query failed with status " << status << "\n";
+                return 1;
+            }
+            for (size_t i = 0; i < replies.size(); ++i)
+            {
+                const wignerReplyPoint &r = replies[i];
+                std::cout << "k: " << queries[i].k << " r0: " << queries[i].r0 << " R: " << r.radius
+                          << " coal: " << r.coal << " K: " << r.wK << " V: " << r.wV << " H: " << r.wH << "\n";
+            }
+        }
+        if (stats)
+        {
+            wignerDaemonStats s;
+            if (!client.stats(s))
+            {
+                std::cerr << "Error: could not read the statistics\n";
+                return 1;
+            }
+            wignerDaemon::printStats(s, std::cout);
+        }
+        return 0;
+    }
+
+    if (threads == 0)
+    {
+        threads = std::thread::hardware_concurrency();
+    }
+    if (!deuteron.empty() && !wignerUtils::setDeuteronTable(deuteron))
+    {
+        return 1;
+    }
+    // computed once here rather than by the first query
+    wignerUtils::getDeuteronChecksum();
+
+    std::unique_ptr<wignerCache> cache;
+    if (!cacheDir.empty())
+    {
+        cache = std::make_unique<wignerCache>(cacheDir, cacheSize);
+    }
+
+    wignerDaemon daemon(config, threads);
+    daemon.setVerbose(verbose);
+    daemon.setCache(cache.get());
+    daemon.setMemoSize(memoSize);
+    daemon.setReportInterval(report);
+
+    gDaemon = &daemon;
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+    std::signal(SIGPIPE, SIG_IGN);
+
+    bool ok = daemon.serve(socketPath);
+    gDaemon = nullptr;
+    if (cache)
+    {
+        std::cout << "Cache " << cache->getDir() << ": " << cache->getHits() << " hits, "
+                  << cache->getMisses() << " misses\n";
+    }
+    return ok ? 0 : 1;
+}
+/// @}
@@ -0,0 +1,229 @@
+/**
+ * @defgroup WignerMergeApp Shard Merge Tool
+ * @brief Validates and merges the outputs of a sharded k* scan.
+ * @{
+ */
+
+#include "CWignerManifest.h"
+#include "CWignerScan.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <sys/stat.h>
+#include <vector>
+
+/**
+ * @file wignermerge.cpp
+ * @brief Replacement for `hadd` on the outputs of `wignersim --shard`.
+ *
+ * The merge reads the shard manifest and checks that every shard file exists, carries the
+ * stamp of the manifest (its configuration hash and physics settings, see wignerManifest::stamp())
+ * and that every global point index of the scan is present. Points produced twice (e.g. a shard
+ * rerun on a second node) are deduplicated, the points are sorted by k* and written into
+ * a single TTree indexed on "idx". Only the eight observables and the two index columns
+ * are read, so the merge is a single pass over the shard files.
+ *
+ * With `--compare`, the merged points are checked against the output of an unsharded run
+ * of the same scan (see shardtest.sh).
+ *
+ * Example usage:
+ * @code
+ *   wignermerge --manifest simres/res.manifest --output simres/res_merged.root
+ *   wignermerge --manifest simres/res.manifest --output simres/res_merged.root --compare simres/res_single.root
+ * @endcode
+ */
+
+/**
+ * @brief Print the command-line help.
+ * @param prog Program name.
+ */
+static void usage(const char *prog)
+{
+    std::cout << "Usage: " << prog << " --manifest <file> --output <file> [--allow-missing] [--compare <file>]\n"
+              << "Options:\n"
+              << "  -m, --manifest <file>  shard manifest written by wignersim --shards\n"
+              << "  -o, --output <file>    merged ROOT file\n"
+              << "      --allow-missing    write the merged file even if points are missing\n"
+              << "      --compare <file>   check the merged points against an unsharded wignersim output\n"
+              << "      --tolerance <e>    relative tolerance of --compare (default: 1e-12)\n"
+              << "  -h, --help             print this message\n";
+}
+
+/**
+ * @brief Compare merged points with those of an unsharded run, point by point in k* order.
+ * @param merged    Merged points, sorted by k*.
+ * @param reference Output file of the unsharded run.
+ * @param tolerance Largest relative difference of an observable.
+ * @return 0 if all points agree, 1 if the reference cannot be read, 3 otherwise.
+ */
+static int compare(const std::vector<wignerPoint> &merged, const std::string &reference, double tolerance)
+{
+    std::vector<wignerPoint> points;
+    if (!wignerScan::readTree(reference, points))
+    {
+        std::cerr << "Error: could not read " << reference << "\n";
+        return 1;
+    }
+    std::stable_sort(points.begin(), points.end(), [](const wignerPoint &a, const wignerPoint &b)
+                     { return a.k < b.k; });
+    if (points.size() != merged.size())
+    {
+        std::cerr << "Error: " << reference << " has " << points.size() << " points, the merged scan " << merged.size() << "\n";
+        return 3;
+    }
+    auto differ = [tolerance](double a, double b)
+    { return !(std::abs(a - b) <= tolerance * std::max(std::abs(a), std::abs(b))); };
+    long different = 0;
+    for (size_t i = 0; i < points.size(); ++i)
+    {
+        const wignerPoint &a = merged[i], &b = points[i];
+        if (differ(a.k, b.k) || differ(a.r0, b.r0) || differ(a.norm, b.norm) || differ(a.WW, b.WW) || differ(a.coal, b.coal) ||
+            differ(a.wK, b.wK) || differ(a.wV, b.wV) || differ(a.wH, b.wH))
+        {
+            if (different == 0)
+            {
+                std::cerr << "  first difference at k* = " << a.k << ": coal " << a.coal << " vs " << b.coal << "\n";
+            }
+            ++different;
+        }
+    }
+    std::cout << "Compared with " << reference << ": " << different << " of " << points.size() << " points differ\n";
+    return different == 0 ? 0 : 3;
+}
+
+/**
+ * @brief Entry point of the merge tool.
+ * @param argc Argument count.
+ * @param argv Argument vector.
+ * @return Exit code: 0 on success, 1 on error, 2 if the scan is incomplete, 3 if --compare finds differences.
+ */
+int main(int argc, char **argv)
+{
+    std::string manifestFile, output, reference;
+    bool allowMissing = false;
+    double tolerance = 1E-12;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if ((arg == "-m" || arg == "--manifest") && i + 1 < argc)
+            manifestFile = argv[++i];
+        else if ((arg == "-o" || arg == "--output") && i + 1 < argc)
+            output = argv[++i];
+        else if (arg == "--allow-missing")
+            allowMissing = true;
+        else if (arg == "--compare" && i + 1 < argc)
+            reference = argv[++i];
+        else if (arg == "--tolerance" && i + 1 < argc)
+            tolerance = std::stod(argv[++i]);
+        else if (arg == "-h" || arg == "--help")
+        {
+            usage(argv[0]);
+            return 0;
+        }
+        else
+        {
+            std::cerr << "Error: invalid option " << arg << "\n";
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (manifestFile.empty() || output.empty())
+    {
+        usage(argv[0]);
+        return 1;
+    }
+
+    wignerManifest manifest = wignerManifest::read(manifestFile);
+
+    std::vector<wignerPoint> points;
+    std::vector<int> missingShards, foreignShards;
+    const std::string stamp = manifest.stamp();
+    for (const auto &s : manifest.shards)
+    {
+        struct stat st;
+        if (stat(s.output.c_str(), &st) != 0)
+        {
+            missingShards.push_back(s.index);
+        }
+        else if (wignerScan::readStamp(s.output) != stamp)
+        {
+            // computed for another manifest or with other settings: its points are not used
+            foreignShards.push_back(s.index);
+        }
+        else if (!wignerScan::readTree(s.output, points))
+        {
+            missingShards.push_back(s.index);
+        }
+    }
+
+    // Sort by global index (hence by k*), keeping the lowest shard first for duplicates
+    std::stable_sort(points.begin(), points.end(), [](const wignerPoint &a, const wignerPoint &b)
+                     { return a.idx < b.idx; });
+
+    std::vector<wignerPoint> merged;
+    merged.reserve(manifest.points);
+    long duplicates = 0, conflicts = 0, foreign = 0;
+    for (const auto &pt : points)
+    {
+        if (pt.idx < 0 || pt.idx >= manifest.points || std::abs(pt.k - manifest.kAt(pt.idx)) > 1e-9 * (1 + std::abs(pt.k)))
+        {
+            ++foreign;
+            continue;
+        }
+        if (!merged.empty() && merged.back().idx == pt.idx)
+        {
+            ++duplicates;
+            if (merged.back().coal != pt.coal || merged.back().wH != pt.wH)
+            {
+                ++conflicts;
+            }
+            continue;
+        }
+        merged.push_back(pt);
+    }
+
+    long missingPoints = manifest.points - (long)merged.size();
+
+    std::cout << "Manifest " << manifestFile << ": " << manifest.shards.size() << " shards, "
+              << manifest.points << " points\n"
+              << "  read " << points.size() << " entries, " << merged.size() << " unique points, "
+              << duplicates << " duplicates (" << conflicts << " with different values), "
+              << foreign << " not belonging to the scan\n";
+    if (!missingShards.empty())
+    {
+        std::cerr << "  missing or unreadable shards:";
+        for (int i : missingShards)
+        {
+            std::cerr << " " << i;
+        }
+        std::cerr << "\n";
+    }
+    if (!foreignShards.empty())
+    {
+        std::string settings = manifest.settings.str();
+        std::cerr << "  shards computed with other settings than the manifest (" << (settings.empty() ? "defaults" : settings) << "):";
+        for (int i : foreignShards)
+        {
+            std::cerr << " " << i;
+        }
+        std::cerr << "\n";
+    }
+    if (missingPoints > 0)
+    {
+        std::cerr << "  " << missingPoints << " points missing\n";
+        if (!allowMissing)
+        {
+            std::cerr << "Error: scan incomplete, rerun the missing shards or use --allow-missing\n";
+            return 2;
+        }
+    }
+
+    if (!wignerScan::writeTree(merged, output, true))
+    {
+        return 1;
+    }
+    return reference.empty() ? 0 : compare(merged, reference, tolerance);
+}
+/// @}
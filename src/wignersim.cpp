@@ -0,0 +1,675 @@
+/**
+ * @defgroup WignerSimApp Compiled k* Scan
+ * @brief Standalone executable replacing the interpreted macros/wignersim.cpp.
+ * @{
+ */
+
+#include "CWignerAdaptiveScan.h"
+#include "CWignerCache.h"
+#include "CWignerEnsemble.h"
+#include "CWignerManifest.h"
+#include "CWignerScan.h"
+#include "CWignerThreeBody.h"
+#include "CWignerUtils.h"
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+
+/**
+ * @file wignersim.cpp
+ * @brief Compiled k* scan linking libWignerUtils directly, without starting the ROOT interpreter.
+ *
+ * It produces the same TTree as macros/wignersim.cpp (branches r0, WxW, coal, norm, wH, wK, wV, k),
+ * so its output can be merged with `hadd` and plotted with `makeplots`.
+ *
+ * Example usage:
+ * @code
+ *   source wignerenv.sh
+ *   wignersim --start 0.001 --end 2.0 --step 0.005 --config config/default.txt --output res.root --threads 8
+ * @endcode
+ *
+ * Sharded scans (one shard per node or per process, see wignerManifest):
+ * @code
+ *   wignersim --start 0.001 --end 2.0 --step 0.005 --shards 16 --prefix simres/res --manifest simres/res.manifest
+ *   wignersim --manifest simres/res.manifest --shard 3 --threads 8
+ *   wignermerge --manifest simres/res.manifest --output simres/res_merged.root
+ * @endcode
+ *
+ * Triton coalescence (Monte Carlo over the 12D three-nucleon phase space, see wignerThreeBody):
+ * @code
+ *   wignersim --start 0.001 --end 1.0 --step 0.01 --nucleus triton --threads 8 --output triton.root
+ * @endcode
+ *
+ * Uncertainty bands from distributions of r0, mu, rWidth, V0 and the deuteron table (see wignerEnsemble):
+ * @code
+ *   wignersim --start 0.001 --end 2.0 --step 0.005 --ensemble config/ensemble.txt --threads 8 --output bands.root
+ * @endcode
+ *
+ * Several deuteron tables in one sweep, one coal_<i> branch per table (coal is that of the first):
+ * @code
+ *   wignersim --start 0.001 --end 2.0 --step 0.005 --deuteron wigner1.root,wigner2.root --threads 8 --output res.root
+ * @endcode
+ *
+ * Closed-form coal from a Gaussian mixture of the deuteron table (see wignerGaussianMixture, wignertable --fit):
+ * @code
+ *   wignersim --start 0.001 --end 2.0 --step 0.005 --mixture deuteronFunction/wigner2.mix --output res.root
+ * @endcode
+ *
+ * coal from a low-rank factorization of the deuteron table, truncated at a relative error of 1e-5 (see wignerLowRankTable):
+ * @code
+ *   wignersim --start 0.001 --end 2.0 --step 0.005 --coal-precision 1e-5 --threads 8 --output res.root
+ * @endcode
+ *
+ * Contribution maps of coal, ⟨K⟩ and ⟨V⟩ in (r, p), filled during the integration (see wignerContributionMap):
+ * @code
+ *   wignersim --start 0.001 --end 0.5 --step 0.05 --maps 40,30 --output res.root
+ * @endcode
+ *
+ * Adaptive scan from a coarse grid, refined where coal, ⟨K⟩, ⟨V⟩ or ⟨H⟩ are not resolved (see wignerAdaptiveScan):
+ * @code
+ *   wignersim --start 0.001 --end 2.0 --step 0.1 --adaptive 1e-3 --threads 8 --output res.root
+ * @endcode
+ *
+ * User-defined observables integrated in the pass of coal, one branch each (see wignerObservables):
+ * @code
+ *   wignersim --start 0.001 --end 2.0 --step 0.005 --observable r2:source,jacobian:x*x --observable coalR2:source,jacobian,deuteron:x*x --output res.root
+ * @endcode
+ *
+ * p–n correlation function C(k*) of the same source in the same scan, branch cf (see wignerCorrelation):
+ * @code
+ *   wignersim --start 0.001 --end 0.5 --step 0.005 --correlation pn_singlet.bin:0.25,pn_triplet.bin:0.75 --output res.root
+ * @endcode
+ */
+
+/**
+ * @brief Print the command-line help.
+ * @param prog Program name.
+ */
+static void usage(const char *prog)
+{
+    std::cout << "Usage: " << prog << " --start <k> --end <k> --step <dk> [options]\n"
+              << "       " << prog << " --start <k> --end <k> --step <dk> --shards <n> --manifest <file> [--prefix <path>]\n"
+              << "       " << prog << " --manifest <file> --shard <i> [--threads <n>]\n"
+              << "Options:\n"
+              << "  -s, --start <k>      first k* value (GeV/c)\n"
+              << "  -e, --end <k>        upper bound of the scan, exclusive (GeV/c)\n"
+              << "  -i, --step <dk>      increment in k* (GeV/c)\n"
+              << "  -c, --config <file>  parameter file (default: config/default.txt)\n"
+              << "  -o, --output <file>  output ROOT file (default: wignersim.root)\n"
+              << "  -j, --threads <n>    worker threads, 0 = all cores (default: 1)\n"
+              << "      --test-mode      use TF2::Integral instead of the grid integration\n"
+              << "  -q, --quiet          do not print one line per point\n"
+              << "  -m, --manifest <file> shard manifest to write (with --shards) or to read (with --shard)\n"
+              << "      --shards <n>     split the scan into n shards and only write the manifest\n"
+              << "      --prefix <path>  output prefix of the shard files (default: wignersim)\n"
+              << "      --shard <i>      compute shard i of the manifest, with the settings recorded in it\n"
+              << "      --radii <o,s,l>  anisotropic source with reference out, side, long radii (fm)\n"
+              << "      --shape <spec>   source shape: gauss, exponential, cauchy, levy:<alpha>, corehalo:<f>,<ratio>\n"
+              << "      --potential <spec> potential: square:<w>,<V0>, yukawa:<V0>,<a>, woodssaxon:<V0>,<R>,<a>, table:<file>\n"
+              << "      --nucleus <name> A = 3 coalescence: triton or he3 (Gaussian nucleus)\n"
+              << "      --nucleus-table <file> A = 3 coalescence with a tabulated nucleus (TH2D \"h\")\n"
+              << "      --mc-tolerance <e> relative error target of the A = 3 Monte Carlo (default: 1e-3)\n"
+              << "      --deuteron <file> deuteron Wigner table (TH2D \"h\", e.g. from wignertable); a comma-separated\n"
+              << "                       list computes coal for each table in one sweep (branches coal_0, coal_1, ...)\n"
+              << "      --ensemble <file> write mean and quantile bands over the parameter distributions of <file>\n"
+              << "      --mixture <file> closed-form coal from a Gaussian mixture of the deuteron table (wignertable --fit)\n"
+              << "      --coal-precision <e> coal from the SVD of the deuteron table truncated at a relative error e\n"
+              << "      --maps <nr,np>   write (r, p) contribution maps of coal, wK and wV for every point (directory maps)\n"
+              << "      --observable <name>:<factors>:<formula> integrate the formula in x = r, y = p times the comma-separated\n"
+              << "                       factors source, jacobian, deuteron (or none) for every point (branch <name>, repeatable)\n"
+              << "      --correlation <file>[:<w>][,...] Koonin-Pratt C(k*) of the source from binary tables of |psi(k*, r)|^2\n"
+              << "                       (x = r, y = k*) with channel weights w (default 1), branch cf\n"
+              << "      --adaptive <tol> refine the --step grid until the relative interpolation error is below tol\n"
+              << "      --min-step <dk>  smallest k* spacing of the adaptive scan (default: 1e-5)\n"
+              << "      --max-points <n> largest number of points of the adaptive scan (default: 10000)\n"
+              << "      --cache <dir>    persistent result cache, shared by concurrent jobs\n"
+              << "      --cache-size <n> maximum number of cached points (default: 100000)\n"
+              << "  -h, --help           print this message\n";
+}
+
+/**
+ * @brief Build the A = 3 nucleus of --nucleus and --nucleus-table.
+ * @param name  triton or he3 (empty for the deuteron).
+ * @param table Tabulated nucleus (empty for the Gaussian nucleus).
+ * @return The nucleus, nullptr for the deuteron.
+ */
+static std::unique_ptr<wignerNucleusA3> makeNucleus(const std::string &name, const std::string &table)
+{
+    // matter rms radii of the triton and of 3He
+    double size = name == "he3" ? 1.97 : 1.76;
+    if (!table.empty())
+    {
+        return std::make_unique<wignerHyperTableA3>(table, "h", size);
+    }
+    if (!name.empty())
+    {
+        return std::make_unique<wignerGaussianA3>(size);
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Compute one shard of a manifest and write its output file.
+ *
+ * The physics settings are those of the manifest; a setting given on the command line must
+ * agree with it. The file is first written under a temporary name, stamped with
+ * wignerManifest::stamp() and renamed once complete, so a crashed or still running shard is
+ * never mistaken for a finished one by wignermerge.
+ *
+ * @param manifestFile Manifest path.
+ * @param shard        Shard index.
+ * @param threads      Worker threads.
+ * @param given        Settings given on the command line (defaults for those not given).
+ * @param toleranceGiven Whether --mc-tolerance was given.
+ * @param verbose      Forwarded to wignerScan::setVerbose.
+ * @param cache        Forwarded to wignerScan::setCache.
+ * @param deuteron     Deuteron table given on the command line (empty to use the one of the manifest).
+ * @return Exit code.
+ */
+static int runShard(const std::string &manifestFile, int shard, int threads, const wignerScanSettings &given, bool toleranceGiven,
+                    bool verbose, wignerCache *cache, const std::string &deuteron)
+{
+    wignerManifest manifest = wignerManifest::read(manifestFile);
+    if (shard >= (int)manifest.shards.size())
+    {
+        std::cerr << "Error: shard " << shard << " not in manifest (" << manifest.shards.size() << " shards)\n";
+        return 1;
+    }
+    const wignerScanSettings &settings = manifest.settings;
+    if ((given.testMode && !settings.testMode) || (!given.radii.empty() && given.radii != settings.radii) ||
+        (!given.shape.empty() && given.shape != settings.shape) || (!given.potential.empty() && given.potential != settings.potential) ||
+        (!given.nucleus.empty() && given.nucleus != settings.nucleus) ||
+        (!given.nucleusTable.empty() && given.nucleusTable != settings.nucleusTable) ||
+        (toleranceGiven && given.tolerance != settings.tolerance))
+    {
+        std::cerr << "Error: the command line conflicts with the settings of " << manifestFile << " ("
+                  << (settings.str().empty() ? "defaults" : settings.str()) << ")\n";
+        return 1;
+    }
+    if (deuteron.empty() && !manifest.deuteron.empty() && !wignerUtils::setDeuteronTable(manifest.deuteron))
+    {
+        return 1;
+    }
+    if (!manifest.configMatches())
+    {
+        std::cerr << "Error: config file " << manifest.config << ", the deuteron table or a table of the settings changed since the manifest was written\n";
+        return 1;
+    }
+
+    const wignerShard &s = manifest.shards[shard];
+    std::cout << "Shard " << shard << ": " << s.count << " k* points in [" << s.kMin << ", " << s.kMax << "]\n";
+
+    wignerScan scan(manifest.config, threads);
+    scan.setTestMode(settings.testMode);
+    scan.setVerbose(verbose);
+    scan.setCache(cache);
+    if (settings.radii.size() == 3)
+    {
+        scan.setAnisotropic(settings.radii[0], settings.radii[1], settings.radii[2]);
+    }
+    if (!settings.shape.empty() && !scan.setShape(settings.shape))
+    {
+        return 1;
+    }
+    if (!settings.potential.empty() && !scan.setPotential(settings.potential))
+    {
+        return 1;
+    }
+    std::unique_ptr<wignerNucleusA3> nucleus = makeNucleus(settings.nucleus, settings.nucleusTable);
+    if (nucleus)
+    {
+        scan.setThreeBody(nucleus.get(), settings.tolerance);
+    }
+    std::vector<wignerPoint> points = scan.run(manifest.kValues(shard));
+    for (long i = 0; i < s.count; ++i)
+    {
+        points[i].idx = s.first + i;
+        points[i].shard = shard;
+    }
+
+    std::string tmp = s.output + ".tmp";
+    if (!wignerScan::writeTree(points, tmp, true) || !wignerScan::writeStamp(tmp, manifest.stamp()))
+    {
+        return 1;
+    }
+    if (std::rename(tmp.c_str(), s.output.c_str()) != 0)
+    {
+        std::cerr << "Error: could not rename " << tmp << " to " << s.output << "\n";
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Entry point of the compiled scan.
+ * @param argc Argument count.
+ * @param argv Argument vector.
+ * @return Exit code.
+ */
+int main(int argc, char **argv)
+{
+    double start = -1, end = -1, step = -1;
+    std::string config = "config/default.txt";
+    std::string output = "wignersim.root";
+    int threads = 1;
+    bool testMode = false;
+    bool verbose = true;
+    std::string manifestFile;
+    std::string prefix = "wignersim";
+    int nShards = 0;
+    int shard = -1;
+    std::string cacheDir;
+    size_t cacheSize = 100000;
+    std::vector<double> radii;
+    std::string shape;
+    std::string potential;
+    std::string nucleusName;
+    std::string nucleusTable;
+    double tolerance = 1E-3;
+    bool toleranceGiven = false;
+    std::vector<std::string> deuteron;
+    std::string ensembleSpec;
+    std::string mixtureFile;
+    double coalPrecision = 0;
+    std::vector<int> maps;
+    std::vector<std::string> observableSpecs;
+    std::vector<std::string> correlationSpecs;
+    double adaptive = 0;
+    double minStep = 1E-5;
+    size_t maxPoints = 10000;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        auto value = [&]() -> std::string
+        {
+            if (i + 1 >= argc)
+            {
+                std::cerr << "Error: missing value for " << arg << "\n";
+                std::exit(1);
+            }
+            return argv[++i];
+        };
+
+        if (arg == "-s" || arg == "--start")
+            start = std::stod(value());
+        else if (arg == "-e" || arg == "--end")
+            end = std::stod(value());
+        else if (arg == "-i" || arg == "--step")
+            step = std::stod(value());
+        else if (arg == "-c" || arg == "--config")
+            config = value();
+        else if (arg == "-o" || arg == "--output")
+            output = value();
+        else if (arg == "-j" || arg == "--threads")
+            threads = std::stoi(value());
+        else if (arg == "--test-mode")
+            testMode = true;
+        else if (arg == "-q" || arg == "--quiet")
+            verbose = false;
+        else if (arg == "-m" || arg == "--manifest")
+            manifestFile = value();
+        else if (arg == "--shards")
+            nShards = std::stoi(value());
+        else if (arg == "--prefix")
+            prefix = value();
+        else if (arg == "--shard")
+            shard = std::stoi(value());
+        else if (arg == "--radii")
+        {
+            std::stringstream ss(value());
+            std::string item;
+            while (std::getline(ss, item, ','))
+                radii.push_back(std::stod(item));
+            if (radii.size() != 3)
+            {
+                std::cerr << "Error: --radii expects three comma-separated values\n";
+                return 1;
+            }
+        }
+        else if (arg == "--shape")
+            shape = value();
+        else if (arg == "--potential")
+            potential = value();
+        else if (arg == "--nucleus")
+            nucleusName = value();
+        else if (arg == "--nucleus-table")
+            nucleusTable = value();
+        else if (arg == "--mc-tolerance")
+        {
+            tolerance = std::stod(value());
+            toleranceGiven = true;
+        }
+        else if (arg == "--deuteron")
+        {
+            std::stringstream ss(value());
+            std::string item;
+            while (std::getline(ss, item, ','))
+                deuteron.push_back(item);
+        }
+        else if (arg == "--ensemble")
+            ensembleSpec = value();
+        else if (arg == "--mixture")
+            mixtureFile = value();
+        else if (arg == "--coal-precision")
+            coalPrecision = std::stod(value());
+        else if (arg == "--observable")
+            observableSpecs.push_back(value());
+        else if (arg == "--correlation")
+        {
+            std::stringstream ss(value());
+            std::string item;
+            while (std::getline(ss, item, ','))
+                correlationSpecs.push_back(item);
+        }
+        else if (arg == "--maps")
+        {
+            std::stringstream ss(value());
+            std::string item;
+            while (std::getline(ss, item, ','))
+                maps.push_back(std::stoi(item));
+            if (maps.size() != 2 || maps[0] < 1 || maps[1] < 1)
+            {
+                std::cerr << "Error: --maps expects two comma-separated positive numbers of bins\n";
+                return 1;
+            }
+        }
+        else if (arg == "--adaptive")
+            adaptive = std::stod(value());
+        else if (arg == "--min-step")
+            minStep = std::stod(value());
+        else if (arg == "--max-points")
+            maxPoints = std::stoul(value());
+        else if (arg == "--cache")
+            cacheDir = value();
+        else if (arg == "--cache-size")
+            cacheSize = std::stoul(value());
+        else if (arg == "-h" || arg == "--help")
+        {
+            usage(argv[0]);
+            return 0;
+        }
+        else
+        {
+            std::cerr << "Error: unknown option " << arg << "\n";
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (threads == 0)
+    {
+        threads = std::thread::hardware_concurrency();
+    }
+
+    if (!deuteron.empty() && !wignerUtils::setDeuteronTable(deuteron[0]))
+    {
+        return 1;
+    }
+
+    if (!nucleusName.empty() && nucleusName != "triton" && nucleusName != "he3")
+    {
+        std::cerr << "Error: unknown nucleus " << nucleusName << " (triton or he3)\n";
+        return 1;
+    }
+    std::unique_ptr<wignerNucleusA3> nucleus = makeNucleus(nucleusName, nucleusTable);
+
+    std::unique_ptr<wignerCache> cache;
+    if (!cacheDir.empty())
+    {
+        cache = std::make_unique<wignerCache>(cacheDir, cacheSize);
+    }
+    auto cacheReport = [&]()
+    {
+        if (cache)
+        {
+            std::cout << "Cache " << cache->getDir() << ": " << cache->getHits() << " hits, "
+                      << cache->getMisses() << " misses\n";
+        }
+    };
+
+    if (!shape.empty() && (radii.size() == 3 || nucleus || !ensembleSpec.empty()))
+    {
+        std::cerr << "Error: --shape cannot be combined with --radii, --nucleus or --ensemble\n";
+        return 1;
+    }
+    if (!potential.empty() && (radii.size() == 3 || nucleus || !ensembleSpec.empty()))
+    {
+        std::cerr << "Error: --potential cannot be combined with --radii, --nucleus or --ensemble\n";
+        return 1;
+    }
+    if (testMode && (radii.size() == 3 || nucleus || !ensembleSpec.empty()))
+    {
+        std::cerr << "Error: --test-mode cannot be combined with --radii, --nucleus or --ensemble\n";
+        return 1;
+    }
+    if (!ensembleSpec.empty() && (shard >= 0 || nShards > 0))
+    {
+        std::cerr << "Error: --ensemble cannot be combined with sharded scans\n";
+        return 1;
+    }
+    if (adaptive > 0 && (shard >= 0 || nShards > 0 || !ensembleSpec.empty()))
+    {
+        std::cerr << "Error: --adaptive cannot be combined with sharded scans or --ensemble\n";
+        return 1;
+    }
+    if (!mixtureFile.empty() && (radii.size() == 3 || nucleus || !shape.empty() || !ensembleSpec.empty() || deuteron.size() > 1 ||
+                                 !maps.empty() || shard >= 0 || nShards > 0))
+    {
+        std::cerr << "Error: --mixture cannot be combined with --radii, --nucleus, --shape, --ensemble, --maps,\n"
+                  << "       several --deuteron tables or sharded scans\n";
+        return 1;
+    }
+    if (coalPrecision < 0)
+    {
+        std::cerr << "Error: --coal-precision must be positive\n";
+        return 1;
+    }
+    if (coalPrecision > 0 && (radii.size() == 3 || nucleus || !shape.empty() || !ensembleSpec.empty() || !mixtureFile.empty() ||
+                              !maps.empty() || testMode || deuteron.size() > 1 || shard >= 0 || nShards > 0))
+    {
+        std::cerr << "Error: --coal-precision cannot be combined with --radii, --nucleus, --shape, --ensemble, --mixture, --maps,\n"
+                  << "       --test-mode, several --deuteron tables or sharded scans\n";
+        return 1;
+    }
+    if (!maps.empty() && (radii.size() == 3 || nucleus || !shape.empty() || !ensembleSpec.empty() || cache || adaptive > 0 ||
+                          testMode || deuteron.size() > 1 || shard >= 0 || nShards > 0))
+    {
+        std::cerr << "Error: --maps cannot be combined with --radii, --nucleus, --shape, --ensemble, --cache, --adaptive, --test-mode,\n"
+                  << "       several --deuteron tables or sharded scans\n";
+        return 1;
+    }
+    if (deuteron.size() > 1 && (radii.size() == 3 || nucleus || !shape.empty() || !ensembleSpec.empty() || cache || shard >= 0 || nShards > 0))
+    {
+        std::cerr << "Error: several --deuteron tables cannot be combined with --radii, --nucleus, --shape, --ensemble, --cache or sharded scans\n";
+        return 1;
+    }
+    wignerObservables observables;
+    for (const std::string &spec : observableSpecs)
+    {
+        if (!observables.add(spec))
+        {
+            return 1;
+        }
+    }
+    if (observables.size() > 0 && (radii.size() == 3 || nucleus || !shape.empty() || !ensembleSpec.empty() || shard >= 0 || nShards > 0))
+    {
+        std::cerr << "Error: --observable cannot be combined with --radii, --nucleus, --shape, --ensemble or sharded scans\n";
+        return 1;
+    }
+    if ((observables.getFactors() & wignerObservables::kDeuteron) && deuteron.size() > 1)
+    {
+        std::cerr << "Error: --observable with the deuteron factor cannot be combined with several --deuteron tables\n";
+        return 1;
+    }
+    wignerCorrelation correlation;
+    for (const std::string &spec : correlationSpecs)
+    {
+        if (!correlation.addChannel(spec))
+        {
+            return 1;
+        }
+    }
+    if (correlation.size() > 0 && (radii.size() == 3 || nucleus || !shape.empty() || !ensembleSpec.empty() || shard >= 0 || nShards > 0))
+    {
+        std::cerr << "Error: --correlation cannot be combined with --radii, --nucleus, --shape, --ensemble or sharded scans\n";
+        return 1;
+    }
+
+    // recorded in the manifest by --shards, taken from it by --shard
+    wignerScanSettings settings;
+    settings.testMode = testMode;
+    settings.radii = radii;
+    settings.shape = shape;
+    settings.potential = potential;
+    settings.nucleus = nucleusName;
+    settings.nucleusTable = nucleusTable;
+    settings.tolerance = tolerance;
+
+    if (shard >= 0)
+    {
+        if (manifestFile.empty())
+        {
+            std::cerr << "Error: --shard requires --manifest\n";
+            return 1;
+        }
+        int status = runShard(manifestFile, shard, threads, settings, toleranceGiven, verbose, cache.get(),
+                              deuteron.empty() ? "" : deuteron[0]);
+        cacheReport();
+        return status;
+    }
+
+    if (start < 0 || end < start || step <= 0)
+    {
+        std::cerr << "Error: --start, --end and --step are required (0 <= start <= end, step > 0)\n";
+        usage(argv[0]);
+        return 1;
+    }
+
+    if (nShards > 0)
+    {
+        if (manifestFile.empty())
+        {
+            std::cerr << "Error: --shards requires --manifest\n";
+            return 1;
+        }
+        wignerManifest manifest = wignerManifest::create(start, end, step, nShards, config, prefix, deuteron.empty() ? "" : deuteron[0],
+                                                         settings);
+        if (manifest.shards.empty() || manifest.configHash == 0)
+        {
+            std::cerr << "Error: empty scan or unreadable config file " << config << " or table of the settings\n";
+            return 1;
+        }
+        if (!manifest.write(manifestFile))
+        {
+            return 1;
+        }
+        std::cout << "Wrote " << manifestFile << ": " << manifest.points << " points in "
+                  << manifest.shards.size() << " shards\n";
+        return 0;
+    }
+
+    std::vector<double> kValues = wignerScan::kGrid(start, end, step);
+
+    if (!ensembleSpec.empty())
+    {
+        if (radii.size() == 3 || nucleus || cache)
+        {
+            std::cerr << "Error: --ensemble cannot be combined with --radii, --nucleus or --cache\n";
+            return 1;
+        }
+        wignerEnsemble ensemble(config, threads);
+        ensemble.readSpec(ensembleSpec);
+        ensemble.setVerbose(verbose);
+        std::vector<wignerBandPoint> bands = ensemble.run(kValues);
+        return ensemble.writeTree(bands, output) ? 0 : 1;
+    }
+
+    wignerScan scan(config, threads);
+    scan.setTestMode(testMode);
+    scan.setVerbose(verbose);
+    scan.setCache(cache.get());
+    if (radii.size() == 3)
+    {
+        scan.setAnisotropic(radii[0], radii[1], radii[2]);
+    }
+    if (!shape.empty() && !scan.setShape(shape))
+    {
+        return 1;
+    }
+    if (!potential.empty() && !scan.setPotential(potential))
+    {
+        return 1;
+    }
+    if (nucleus)
+    {
+        scan.setThreeBody(nucleus.get(), tolerance);
+    }
+    if (deuteron.size() > 1 && !scan.setDeuteronTables(deuteron))
+    {
+        return 1;
+    }
+    if (!maps.empty())
+    {
+        scan.setContributionMaps(maps[0], maps[1]);
+    }
+    wignerGaussianMixture mixture;
+    if (!mixtureFile.empty())
+    {
+        mixture = wignerGaussianMixture::read(mixtureFile);
+        std::cout << "Gaussian mixture " << mixtureFile << ": " << mixture.size() << " components, relative residual "
+                  << mixture.getResidual() << "\n";
+        scan.setMixture(&mixture);
+    }
+    if (coalPrecision > 0)
+    {
+        wignerUtils::setLowRankTolerance(coalPrecision);
+        const wignerLowRankTable *lowRank = wignerUtils::getLowRankTable();
+        std::cout << "Low-rank deuteron table: rank " << lowRank->getRank() << ", relative truncation error "
+                  << lowRank->getError() << "\n";
+        if (lowRank->getError() > coalPrecision)
+        {
+            std::cerr << "Warning: the precision is not reached, coal is integrated on the grid\n";
+        }
+        scan.setCoalPrecision(coalPrecision);
+    }
+    if (observables.size() > 0)
+    {
+        scan.setObservables(&observables);
+    }
+    if (correlation.size() > 0)
+    {
+        scan.setCorrelation(&correlation);
+    }
+
+    if (adaptive > 0)
+    {
+        wignerAdaptiveScan adaptiveScan(scan);
+        adaptiveScan.setTolerance(adaptive);
+        adaptiveScan.setMinStep(minStep);
+        adaptiveScan.setMaxPoints(maxPoints);
+        std::cout << "Adaptive scan of [" << start << ", " << end << "] from a step of " << step
+                  << " with " << scan.getThreads() << " thread(s)\n";
+        std::vector<wignerPoint> points = adaptiveScan.run(start, end, step);
+        std::cout << points.size() << " points after " << adaptiveScan.getRounds() << " refinement(s)\n";
+        cacheReport();
+        return wignerScan::writeTree(points, output, false, scan.getDeuteronTables(), observables.getNames(), correlation.size() > 0) &&
+                       wignerAdaptiveScan::writeInterpolants(points, output) ? 0 : 1;
+    }
+
+    std::cout << "Scanning " << kValues.size() << " k* points in [" << start << ", " << end
+              << ") with " << scan.getThreads() << " thread(s)\n";
+
+    std::vector<wignerPoint> points = scan.run(kValues);
+    cacheReport();
+    if (!wignerScan::writeTree(points, output, false, scan.getDeuteronTables(), observables.getNames(), correlation.size() > 0))
+    {
+        return 1;
+    }
+    return maps.empty() || scan.writeContributionMaps(output) ? 0 : 1;
+}
+/// @}
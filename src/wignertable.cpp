@@ -0,0 +1,266 @@
+/**
+ * @defgroup WignerTableApp Deuteron Table Generator
+ * @brief Standalone executable writing a deuteron Wigner table from a radial wavefunction.
+ * @{
+ */
+
+#include "CWignerCoreSource.h"
+#include "CWignerDeuteronTable.h"
+#include "CWignerGaussianMixture.h"
+#include "CWignerUtils.h"
+#include "TFile.h"
+#include "TH2.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+
+/**
+ * @file wignertable.cpp
+ * @brief Generates the deuteron Wigner table (TH2D "h", r in fm, p in GeV/c) loaded by wignerUtils.
+ *
+ * Example usage:
+ * @code
+ *   wignertable --hulthen --output deuteronFunction/hulthen.root --nr 1000 --np 1000 --threads 8
+ *   wignertable --wavefunction av18.txt --output deuteronFunction/av18.root
+ *   wignersim --start 0.001 --end 2.0 --step 0.005 --deuteron deuteronFunction/av18.root
+ *   wignertable --convert deuteronFunction/wigner2.root --binary deuteronFunction/wigner2.bin
+ *   wignertable --wavefunction av18.txt --check-overlap 1.0 --nr 1000 --np 1000
+ *   wignertable --fit deuteronFunction/wigner2.root --mixture deuteronFunction/wigner2.mix
+ * @endcode
+ *
+ * The binary table (`--binary`) is the ROOT-free format read by wignerTable, for codes that
+ * embed wignerCoreSource without ROOT. `--check-overlap <r0>` compares, for a few k*, coal from
+ * the table (phase-space grid, wignerCoreSource) with coal from the wavefunction overlap
+ * (wignerOverlap). `--fit` writes a Gaussian mixture of an existing table (wignerGaussianMixture)
+ * for the closed-form coal of `wignersim --mixture`, and prints its error against the grid.
+ */
+
+/**
+ * @brief Print the command-line help.
+ * @param prog Program name.
+ */
+static void usage(const char *prog)
+{
+    std::cout << "Usage: " << prog << " (--hulthen | --wavefunction <file>) (--output <file> | --check-overlap <r0>) [options]\n"
+              << "       " << prog << " --convert <file> --binary <file>\n"
+              << "       " << prog << " --fit <file> --mixture <file> [--fit-tolerance <e>] [--max-widths <n>]\n"
+              << "Options:\n"
+              << "      --hulthen            Hulthen wavefunction (S-wave only)\n"
+              << "      --alpha <a>          Hulthen alpha in 1/fm (default: 0.2316)\n"
+              << "      --beta <b>           Hulthen beta in 1/fm (default: 1.385)\n"
+              << "  -w, --wavefunction <file> text file with columns r (fm), u(r) [, w(r)]\n"
+              << "  -o, --output <file>      output ROOT file\n"
+              << "      --binary <file>      also write the table in the ROOT-free binary format\n"
+              << "      --convert <file>     convert the TH2 \"h\" of an existing ROOT table to --binary\n"
+              << "      --fit <file>         fit the TH2 \"h\" of an existing ROOT table with a Gaussian mixture\n"
+              << "      --mixture <file>     output file of the mixture coefficients\n"
+              << "      --fit-tolerance <e>  target relative residual of the fit (default: 1e-3)\n"
+              << "      --max-widths <n>     largest number of widths per axis, n x n components (default: 16)\n"
+              << "      --check-overlap <r0> compare coal of the table with the wavefunction overlap for R0 = r0\n"
+              << "      --nr <n>             number of r bins (default: 100)\n"
+              << "      --rmax <r>           upper r edge in fm (default: 20)\n"
+              << "      --np <n>             number of p bins (default: 100)\n"
+              << "      --pmax <p>           upper p edge in GeV/c (default: 0.6)\n"
+              << "  -j, --threads <n>        threads, 0 = all cores (default: 0)\n"
+              << "  -h, --help               print this message\n";
+}
+
+/**
+ * @brief Entry point of the table generator.
+ * @param argc Argument count.
+ * @param argv Argument vector.
+ * @return Exit code.
+ */
+int main(int argc, char **argv)
+{
+    bool hulthen = false;
+    double alpha = 0.2316, beta = 1.385;
+    std::string wavefunction, output, binary, convert;
+    int nR = 100, nP = 100;
+    double rMax = 20., pMax = 0.6;
+    int threads = 0;
+    double checkR0 = -1;
+    std::string fit, mixtureFile;
+    double fitTolerance = 1E-3;
+    int maxWidths = 16;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        auto value = [&]() -> std::string
+        {
+            if (i + 1 >= argc)
+            {
+                std::cerr << "Error: missing value for " << arg << "\n";
+                std::exit(1);
+            }
+            return argv[++i];
+        };
+
+        if (arg == "--hulthen")
+            hulthen = true;
+        else if (arg == "--alpha")
+            alpha = std::stod(value());
+        else if (arg == "--beta")
+            beta = std::stod(value());
+        else if (arg == "-w" || arg == "--wavefunction")
+            wavefunction = value();
+        else if (arg == "-o" || arg == "--output")
+            output = value();
+        else if (arg == "--binary")
+            binary = value();
+        else if (arg == "--convert")
+            convert = value();
+        else if (arg == "--fit")
+            fit = value();
+        else if (arg == "--mixture")
+            mixtureFile = value();
+        else if (arg == "--fit-tolerance")
+            fitTolerance = std::stod(value());
+        else if (arg == "--max-widths")
+            maxWidths = std::stoi(value());
+        else if (arg == "--check-overlap")
+            checkR0 = std::stod(value());
+        else if (arg == "--nr")
+            nR = std::stoi(value());
+        else if (arg == "--rmax")
+            rMax = std::stod(value());
+        else if (arg == "--np")
+            nP = std::stoi(value());
+        else if (arg == "--pmax")
+            pMax = std::stod(value());
+        else if (arg == "-j" || arg == "--threads")
+            threads = std::stoi(value());
+        else if (arg == "-h" || arg == "--help")
+        {
+            usage(argv[0]);
+            return 0;
+        }
+        else
+        {
+            std::cerr << "Error: unknown option " << arg << "\n";
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (!convert.empty())
+    {
+        if (binary.empty())
+        {
+            std::cerr << "Error: --convert requires --binary\n";
+            return 1;
+        }
+        TFile file(convert.c_str(), "READ");
+        TH2 *h = file.IsZombie() ? nullptr : dynamic_cast<TH2 *>(file.Get("h"));
+        if (!h)
+        {
+            std::cerr << "Could not read h from " << convert << "\n";
+            return 1;
+        }
+        wignerTable table = wignerUtils::toTable(h);
+        if (!table.write(binary))
+        {
+            return 1;
+        }
+        std::cout << "Wrote " << binary << ": " << h->GetNbinsX() << " x " << h->GetNbinsY()
+                  << " bins, checksum " << std::hex << table.checksum() << std::dec << "\n";
+        return 0;
+    }
+
+    if (!fit.empty())
+    {
+        if (mixtureFile.empty())
+        {
+            std::cerr << "Error: --fit requires --mixture\n";
+            return 1;
+        }
+        TFile file(fit.c_str(), "READ");
+        TH2 *h = file.IsZombie() ? nullptr : dynamic_cast<TH2 *>(file.Get("h"));
+        if (!h)
+        {
+            std::cerr << "Could not read h from " << fit << "\n";
+            return 1;
+        }
+        wignerTable grid = wignerUtils::toTable(h);
+        wignerGaussianMixture mixture = wignerGaussianMixture::fit(grid, fitTolerance, maxWidths);
+        if (!mixture.write(mixtureFile))
+        {
+            return 1;
+        }
+        std::cout << "Wrote " << mixtureFile << ": " << mixture.size() << " components, relative residual "
+                  << mixture.getResidual() << "\n";
+
+        // closed form against the grid integration of the table, with the same source normalization
+        wignerCoreSource source(&grid);
+        double worst = 0;
+        for (double r0 : {0.5, 1., 2., 4.})
+        {
+            source.setR0(r0);
+            for (double k : {0.05, 0.1, 0.2, 0.3})
+            {
+                wignerPoint pt = source.computePoint(k);
+                double closed = mixture.coal(pt.r0, wignerCore::kStarEff(k, pt.r0), pt.norm);
+                double error = (closed - pt.coal) / pt.coal;
+                worst = std::max(worst, std::fabs(error));
+                std::cout << "  R0 = " << r0 << " fm, k* = " << k << ": grid " << pt.coal << ", mixture " << closed
+                          << ", relative difference " << error << "\n";
+            }
+        }
+        std::cout << "Largest relative difference of coal: " << worst << "\n";
+        return 0;
+    }
+
+    if ((output.empty() && checkR0 < 0) || hulthen == !wavefunction.empty())
+    {
+        std::cerr << "Error: --output or --check-overlap and exactly one of --hulthen, --wavefunction are required\n";
+        usage(argv[0]);
+        return 1;
+    }
+    if (threads == 0)
+    {
+        threads = std::thread::hardware_concurrency();
+    }
+
+    wignerDeuteronTable table = hulthen ? wignerDeuteronTable::hulthen(alpha, beta)
+                                        : wignerDeuteronTable::fromFile(wavefunction);
+    table.setGrid(nR, 0., rMax, nP, 0., pMax);
+    table.setThreads(threads);
+
+    if (!output.empty())
+    {
+        auto start = std::chrono::steady_clock::now();
+        if (!table.write(output, binary))
+        {
+            return 1;
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "Wrote " << output << ": " << nR << " x " << nP << " bins, D-state probability "
+                  << table.getDProbability() << ", " << seconds << " s\n";
+    }
+
+    if (checkR0 >= 0)
+    {
+        TH2D *h = table.compute();
+        wignerTable phaseSpace = wignerUtils::toTable(h);
+        delete h;
+        wignerCoreSource source(&phaseSpace);
+        source.setR0(checkR0);
+        wignerOverlap overlap = table.overlap();
+
+        std::cout << "Cross-check with R0 = " << checkR0 << " fm: coal from the table and from the wavefunction overlap\n";
+        for (double k : {0.02, 0.05, 0.1, 0.15, 0.2, 0.3, 0.4})
+        {
+            double grid = source.computePoint(k).coal;
+            double direct = overlap.computeCoal(k, checkR0);
+            std::cout << "  k* = " << k << ": table " << grid << ", overlap " << direct
+                      << ", relative difference " << (grid - direct) / direct << "\n";
+        }
+    }
+    return 0;
+}
+/// @}